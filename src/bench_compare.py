@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON runs of bench_matrix.
+
+Usage: bench_compare.py BASELINE.json CURRENT.json [--threshold 0.10]
+
+For every benchmark present in both runs it prints the time change. A
+benchmark whose time grew by more than the threshold (a fraction, 0.10 is
+10%) is flagged as a regression, and the script exits with status 1 if
+there is at least one. When the runs were made with repetitions, the mean
+aggregate is compared.
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+
+def load_times(path):
+    """Returns {benchmark name: time in seconds} for one JSON run."""
+    with open(path, encoding="utf-8") as f:
+        report = json.load(f)
+    times = {}
+    means = {}
+    for bench in report.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        seconds = bench["real_time"] * TIME_UNITS[bench.get("time_unit", "ns")]
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "mean":
+                means[bench["run_name"]] = seconds
+        else:
+            times.setdefault(bench.get("run_name", bench["name"]), seconds)
+    times.update(means)
+    return times
+
+
+def format_time(seconds):
+    for unit in ("s", "ms", "us", "ns"):
+        if seconds >= TIME_UNITS[unit] or unit == "ns":
+            return "%.3f %s" % (seconds / TIME_UNITS[unit], unit)
+    return ""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="allowed relative slowdown (default 0.10)")
+    args = parser.parse_args()
+
+    baseline = load_times(args.baseline)
+    current = load_times(args.current)
+    common = [name for name in current if name in baseline]
+    if not common:
+        print("no common benchmarks between the two runs")
+        return 1
+
+    regressions = []
+    width = max(len(name) for name in common)
+    for name in common:
+        change = current[name] / baseline[name] - 1.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        print("%-*s %12s -> %12s %+8.1f%%%s" % (
+            width, name, format_time(baseline[name]),
+            format_time(current[name]), change * 100.0, flag))
+
+    for name in sorted(set(baseline) - set(current)):
+        print("missing in current run: %s" % name)
+    print("%d benchmarks compared, %d regressions above %.1f%%" % (
+        len(common), len(regressions), args.threshold * 100.0))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,604 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_out_of_core.h"
+
+// Микробенчмарки публичных операций S21Matrix. Собираются и запускаются
+// целью make bench (с оптимизацией, результат в bench.json); два прогона
+// сравнивает bench_compare.py.
+//
+// Для каждой операции считаются FLOPS (арифметические операции в секунду,
+// с приставками K/M/G) и bytes_per_second (байты, которые операция обязана
+// прочитать и записать). Размеры - квадратные от 2x2 до 4096x4096 и
+// прямоугольные, в том числе векторы.
+
+namespace {
+
+constexpr double kDouble = sizeof(double);
+
+S21Matrix Filled(int rows, int cols, std::uint32_t seed = 1) {
+  S21Matrix result(rows, cols);
+  double *data = result.Data();
+  std::uint32_t state = seed;
+  for (long k = 0; k < static_cast<long>(rows) * cols; k++) {
+    state = state * 1664525u + 1013904223u;
+    data[k] = static_cast<double>(state >> 8) / (1u << 24) - 0.5;
+  }
+  return result;
+}
+
+// хорошо обусловленная квадратная матрица для det/inverse/LU
+S21Matrix Regular(int n) {
+  S21Matrix result = Filled(n, n, 7);
+  for (int i = 0; i < n; i++) {
+    result(i, i) += n;
+  }
+  return result;
+}
+
+// симметричная положительно определенная (диагональное преобладание) для
+// разложения Холецкого
+S21Matrix Spd(int n) {
+  S21Matrix result = Regular(n);
+  return result + result.Transpose();
+}
+
+void SetCounters(benchmark::State &state, double flops, double bytes) {
+  state.counters["FLOPS"] =
+      benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate,
+                         benchmark::Counter::kIs1000);
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() *
+                                                    bytes));
+}
+
+// квадратные 2..4096 и прямоугольные формы (rows, cols)
+void ElementwiseShapes(benchmark::internal::Benchmark *bench) {
+  for (int n = 2; n <= 4096; n *= 2) {
+    bench->Args({n, n});
+  }
+  for (auto shape : std::vector<std::pair<int, int>>{
+           {1, 4096}, {4096, 1}, {16, 4096}, {4096, 16}, {256, 1024},
+           {1024, 256}, {3, 1000}, {1000, 3}}) {
+    bench->Args({shape.first, shape.second});
+  }
+}
+
+// квадратные n x n для операций над квадратными матрицами
+void SquareShapes(benchmark::internal::Benchmark *bench) {
+  for (int n = 2; n <= 4096; n *= 2) {
+    bench->Args({n});
+  }
+  for (int n : {3, 5, 100, 1000}) {
+    bench->Args({n});
+  }
+}
+
+// произведения (m, k, n): A - m x k, B - k x n
+void ProductShapes(benchmark::internal::Benchmark *bench) {
+  for (int n = 2; n <= 4096; n *= 2) {
+    bench->Args({n, n, n});
+  }
+  for (auto shape : std::vector<std::vector<std::int64_t>>{
+           {1, 4096, 4096},
+           {4096, 4096, 1},
+           {4096, 64, 4096},
+           {64, 4096, 64},
+           {1024, 256, 2048},
+           {2048, 1024, 512},
+           {1000, 1000, 1000}}) {
+    bench->Args(shape);
+  }
+}
+
+void BM_Construct(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  for (auto _ : state) {
+    S21Matrix m(rows, cols);
+    benchmark::DoNotOptimize(m.Data());
+  }
+  SetCounters(state, 0, kDouble * rows * cols);
+}
+BENCHMARK(BM_Construct)->Apply(ElementwiseShapes);
+
+void BM_Copy(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix source = Filled(rows, cols);
+  for (auto _ : state) {
+    S21Matrix copy(source);
+    benchmark::DoNotOptimize(copy.Data());
+  }
+  SetCounters(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_Copy)->Apply(ElementwiseShapes);
+
+void BM_CopyAssign(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix source = Filled(rows, cols);
+  S21Matrix target(rows, cols);
+  for (auto _ : state) {
+    target = source;
+    benchmark::DoNotOptimize(target.Data());
+  }
+  SetCounters(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_CopyAssign)->Apply(ElementwiseShapes);
+
+void BM_Move(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  for (auto _ : state) {
+    S21Matrix b(std::move(a));
+    a = std::move(b);
+    benchmark::DoNotOptimize(a.Data());
+  }
+  SetCounters(state, 0, 0);
+}
+BENCHMARK(BM_Move)->Apply(ElementwiseShapes);
+
+void BM_Access(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix m = Filled(rows, cols);
+  for (auto _ : state) {
+    double sum = 0;
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        sum += m(i, j);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  SetCounters(state, 1.0 * rows * cols, kDouble * rows * cols);
+}
+BENCHMARK(BM_Access)->Apply(ElementwiseShapes);
+
+void BM_EqMatrix(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  S21Matrix b = a;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.EqMatrix(b));
+  }
+  SetCounters(state, 2.0 * rows * cols, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_EqMatrix)->Apply(ElementwiseShapes);
+
+void BM_SumMatrix(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  S21Matrix b = Filled(rows, cols, 2);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::DoNotOptimize(a.Data());
+  }
+  SetCounters(state, 1.0 * rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_SumMatrix)->Apply(ElementwiseShapes);
+
+void BM_SubMatrix(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  S21Matrix b = Filled(rows, cols, 2);
+  for (auto _ : state) {
+    a.SubMatrix(b);
+    benchmark::DoNotOptimize(a.Data());
+  }
+  SetCounters(state, 1.0 * rows * cols, 3 * kDouble * rows * cols);
+}
+BENCHMARK(BM_SubMatrix)->Apply(ElementwiseShapes);
+
+void BM_MulNumber(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  for (auto _ : state) {
+    a.MulNumber(1.0000001);
+    benchmark::DoNotOptimize(a.Data());
+  }
+  SetCounters(state, 1.0 * rows * cols, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_MulNumber)->Apply(ElementwiseShapes);
+
+// A + B - C * 2.0 одним проходом через ленивые выражения
+void BM_ExpressionChain(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols, 1);
+  S21Matrix b = Filled(rows, cols, 2);
+  S21Matrix c = Filled(rows, cols, 3);
+  S21Matrix result(rows, cols);
+  for (auto _ : state) {
+    result = a + b - c * 2.0;
+    benchmark::DoNotOptimize(result.Data());
+  }
+  SetCounters(state, 3.0 * rows * cols, 4 * kDouble * rows * cols);
+}
+BENCHMARK(BM_ExpressionChain)->Apply(ElementwiseShapes);
+
+void BM_Transpose(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t.Data());
+  }
+  SetCounters(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_Transpose)->Apply(ElementwiseShapes);
+
+void BM_TransposeInPlace(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::DoNotOptimize(a.Data());
+  }
+  SetCounters(state, 0, 2 * kDouble * rows * cols);
+}
+BENCHMARK(BM_TransposeInPlace)->Apply(ElementwiseShapes);
+
+void BM_Resize(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = Filled(rows, cols);
+  for (auto _ : state) {
+    a.SetRows(rows + 1);
+    a.SetCols(cols + 1);
+    a.SetRows(rows);
+    a.SetCols(cols);
+    benchmark::DoNotOptimize(a.Data());
+  }
+  SetCounters(state, 0, 8 * kDouble * rows * cols);
+}
+BENCHMARK(BM_Resize)->Apply(ElementwiseShapes);
+
+void MulBenchmark(benchmark::State &state, S21MulAlgorithm algorithm) {
+  int m = state.range(0), k = state.range(1), n = state.range(2);
+  S21Matrix a = Filled(m, k, 1);
+  S21Matrix b = Filled(k, n, 2);
+  for (auto _ : state) {
+    S21Matrix c = a;
+    c.MulMatrix(b, algorithm);
+    benchmark::DoNotOptimize(c.Data());
+  }
+  SetCounters(state, 2.0 * m * n * k,
+              kDouble * (2.0 * m * k + 1.0 * k * n + 1.0 * m * n));
+}
+
+void BM_MulMatrix(benchmark::State &state) {
+  MulBenchmark(state, S21MulAlgorithm::kAuto);
+}
+BENCHMARK(BM_MulMatrix)->Apply(ProductShapes)->Unit(benchmark::kMicrosecond);
+
+void BM_MulMatrixClassic(benchmark::State &state) {
+  MulBenchmark(state, S21MulAlgorithm::kClassic);
+}
+BENCHMARK(BM_MulMatrixClassic)
+    ->Apply(ProductShapes)
+    ->Unit(benchmark::kMicrosecond);
+
+// для Штрассена FLOPS считаются по классической формуле 2mnk, чтобы
+// значения можно было сравнивать с обычным умножением
+void BM_MulMatrixStrassen(benchmark::State &state) {
+  MulBenchmark(state, S21MulAlgorithm::kStrassen);
+}
+BENCHMARK(BM_MulMatrixStrassen)
+    ->Apply(ProductShapes)
+    ->Unit(benchmark::kMicrosecond);
+
+// накладные расходы исполнителя и полос столбцов, сравнивать с
+// BM_MulMatrixClassic
+void BM_MulMatrixAsync(benchmark::State &state) {
+  int m = state.range(0), k = state.range(1), n = state.range(2);
+  S21Matrix a = Filled(m, k, 1);
+  S21Matrix b = Filled(k, n, 2);
+  for (auto _ : state) {
+    S21Matrix c = a.MulMatrixAsync(b).get();
+    benchmark::DoNotOptimize(c.Data());
+  }
+  SetCounters(state, 2.0 * m * n * k,
+              kDouble * (3.0 * m * k + 2.0 * k * n + 1.0 * m * n));
+}
+BENCHMARK(BM_MulMatrixAsync)
+    ->Apply(ProductShapes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// (rows, cols, row): A * x для столбца x или x * A для строки x (row = 1),
+// в том числе высокие и широкие A
+void VectorShapes(benchmark::internal::Benchmark *bench) {
+  for (auto shape : std::vector<std::pair<int, int>>{{100, 100},
+                                                     {1000, 1000},
+                                                     {4096, 4096},
+                                                     {100000, 64},
+                                                     {1000000, 8},
+                                                     {64, 100000}}) {
+    bench->Args({shape.first, shape.second, 0});
+    bench->Args({shape.first, shape.second, 1});
+  }
+}
+
+// произведение в готовый вектор, без выделения памяти на итерацию
+void BM_MulVector(benchmark::State &state) {
+  int rows = state.range(0), cols = state.range(1);
+  bool row = state.range(2) != 0;
+  S21Matrix a = Filled(rows, cols, 1);
+  S21Matrix x = row ? Filled(1, rows, 2) : Filled(cols, 1, 2);
+  S21Matrix y;
+  for (auto _ : state) {
+    a.MulVector(x, &y);
+    benchmark::DoNotOptimize(y.Data());
+  }
+  SetCounters(state, 2.0 * rows * cols,
+              kDouble * (1.0 * rows * cols + rows + cols));
+}
+BENCHMARK(BM_MulVector)->Apply(VectorShapes)->Unit(benchmark::kMicrosecond);
+
+void BM_Determinant(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Regular(n);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.Determinant());
+  }
+  SetCounters(state, 2.0 / 3.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_Determinant)->Apply(SquareShapes)->Unit(benchmark::kMicrosecond);
+
+void BM_LU(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Regular(n);
+  for (auto _ : state) {
+    S21LU lu = a.LU();
+    benchmark::DoNotOptimize(lu.Factors().Data());
+  }
+  SetCounters(state, 2.0 / 3.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_LU)->Apply(SquareShapes)->Unit(benchmark::kMicrosecond);
+
+void BM_InverseMatrix(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Regular(n);
+  for (auto _ : state) {
+    S21Matrix inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.Data());
+  }
+  SetCounters(state, 2.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_InverseMatrix)
+    ->Apply(SquareShapes)
+    ->Unit(benchmark::kMicrosecond);
+
+// Повторное решение с одной правой частью: разложение строится до цикла и
+// дальше берется из матрицы, против A.InverseMatrix() * b на каждый вызов.
+void BM_Solve(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Regular(n);
+  S21Matrix b = Filled(n, 1, 2);
+  a.Solve(b);
+  for (auto _ : state) {
+    S21Matrix x = a.Solve(b);
+    benchmark::DoNotOptimize(x.Data());
+  }
+  SetCounters(state, 2.0 * n * n, kDouble * n * n);
+}
+BENCHMARK(BM_Solve)->Apply(SquareShapes)->Unit(benchmark::kMicrosecond);
+
+// Первое решение вместе с разложением: в double и со смешанной точностью
+// (разложение во float и уточнение в double). Запись в матрицу сбрасывает
+// запомненное разложение перед каждой итерацией.
+void FactorAndSolve(benchmark::State &state, bool mixed) {
+  int n = state.range(0);
+  S21Matrix a = Regular(n);
+  S21Matrix b = Filled(n, 1, 2);
+  for (auto _ : state) {
+    a(0, 0) += 0.0;
+    S21Matrix x = mixed ? a.SolveMixed(b) : a.Solve(b);
+    benchmark::DoNotOptimize(x.Data());
+  }
+  SetCounters(state, 2.0 / 3.0 * n * n * n, 2 * kDouble * n * n);
+}
+
+void BM_FactorSolve(benchmark::State &state) { FactorAndSolve(state, false); }
+BENCHMARK(BM_FactorSolve)->Apply(SquareShapes)->Unit(benchmark::kMicrosecond);
+
+void BM_FactorSolveMixed(benchmark::State &state) {
+  FactorAndSolve(state, true);
+}
+BENCHMARK(BM_FactorSolveMixed)
+    ->Apply(SquareShapes)
+    ->Unit(benchmark::kMicrosecond);
+
+// Solve сам выбирает Холецкого для симметричной матрицы: n^3 / 3 операций
+void BM_FactorSolveSpd(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Spd(n);
+  S21Matrix b = Filled(n, 1, 2);
+  for (auto _ : state) {
+    a(0, 0) += 0.0;
+    S21Matrix x = a.Solve(b);
+    benchmark::DoNotOptimize(x.Data());
+  }
+  SetCounters(state, 1.0 / 3.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_FactorSolveSpd)
+    ->Apply(SquareShapes)
+    ->Unit(benchmark::kMicrosecond);
+
+// наименьшие квадраты для 2n x n через QR: 2 * m * n^2 - 2 / 3 * n^3
+void BM_LeastSquares(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Filled(2 * n, n, 3);
+  S21Matrix b = Filled(2 * n, 1, 2);
+  for (auto _ : state) {
+    S21Matrix x = a.LeastSquares(b);
+    benchmark::DoNotOptimize(x.Data());
+  }
+  SetCounters(state, 10.0 / 3.0 * n * n * n, 2 * kDouble * 2 * n * n);
+}
+BENCHMARK(BM_LeastSquares)->Apply(SquareShapes)->Unit(benchmark::kMicrosecond);
+
+void BM_SolveViaInverse(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Regular(n);
+  S21Matrix b = Filled(n, 1, 2);
+  for (auto _ : state) {
+    S21Matrix x = a.InverseMatrix() * b;
+    benchmark::DoNotOptimize(x.Data());
+  }
+  SetCounters(state, 2.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_SolveViaInverse)
+    ->Apply(SquareShapes)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_CalcComplements(benchmark::State &state) {
+  int n = state.range(0);
+  S21Matrix a = Regular(n);
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(complements.Data());
+  }
+  SetCounters(state, 2.0 * n * n * n, 2 * kDouble * n * n);
+}
+BENCHMARK(BM_CalcComplements)
+    ->Apply(SquareShapes)
+    ->Unit(benchmark::kMicrosecond);
+
+// Пакет из 4096 матриц n x n против тех же операций над отдельными
+// S21Matrix; FLOPS считаются на весь пакет.
+S21MatrixBatch FilledBatch(int count, int n) {
+  S21MatrixBatch batch(count, n, n);
+  for (int b = 0; b < count; b++) {
+    S21Matrix single = Regular(n);
+    single(0, 0) += b;
+    batch.Set(b, single);
+  }
+  return batch;
+}
+
+constexpr int kBatchCount = 4096;
+
+void BM_BatchDeterminant(benchmark::State &state) {
+  int n = state.range(0);
+  S21MatrixBatch batch = FilledBatch(kBatchCount, n);
+  for (auto _ : state) {
+    std::vector<double> det = batch.Determinant();
+    benchmark::DoNotOptimize(det.data());
+  }
+  SetCounters(state, 2.0 / 3.0 * n * n * n * kBatchCount,
+              kDouble * (n * n + 1.0) * kBatchCount);
+}
+BENCHMARK(BM_BatchDeterminant)->DenseRange(2, 6)->Unit(benchmark::kMicrosecond);
+
+void BM_BatchInverse(benchmark::State &state) {
+  int n = state.range(0);
+  S21MatrixBatch batch = FilledBatch(kBatchCount, n);
+  std::vector<std::uint8_t> singular;
+  for (auto _ : state) {
+    S21MatrixBatch inverse = batch.InverseMatrix(&singular);
+    benchmark::DoNotOptimize(inverse.Plane(0, 0));
+  }
+  SetCounters(state, 2.0 * n * n * n * kBatchCount,
+              2 * kDouble * n * n * kBatchCount);
+}
+BENCHMARK(BM_BatchInverse)->DenseRange(2, 6)->Unit(benchmark::kMicrosecond);
+
+void BM_BatchMul(benchmark::State &state) {
+  int n = state.range(0);
+  S21MatrixBatch batch = FilledBatch(kBatchCount, n);
+  for (auto _ : state) {
+    S21MatrixBatch product = batch.MulBatch(batch);
+    benchmark::DoNotOptimize(product.Plane(0, 0));
+  }
+  SetCounters(state, 2.0 * n * n * n * kBatchCount,
+              3 * kDouble * n * n * kBatchCount);
+}
+BENCHMARK(BM_BatchMul)->DenseRange(2, 6)->Unit(benchmark::kMicrosecond);
+
+// та же работа по одной матрице
+void BM_SingleDeterminant(benchmark::State &state) {
+  int n = state.range(0);
+  std::vector<S21Matrix> matrices(kBatchCount, Regular(n));
+  for (auto _ : state) {
+    for (const S21Matrix &matrix : matrices) {
+      benchmark::DoNotOptimize(matrix.Determinant());
+    }
+  }
+  SetCounters(state, 2.0 / 3.0 * n * n * n * kBatchCount,
+              kDouble * (n * n + 1.0) * kBatchCount);
+}
+BENCHMARK(BM_SingleDeterminant)
+    ->DenseRange(2, 6)
+    ->Unit(benchmark::kMicrosecond);
+
+// Те же сложение и умножение для разных типов элементов: float вдвое
+// уменьшает объем памяти и вдвое расширяет векторы ядер.
+template <typename T>
+void BM_SumMatrixTyped(benchmark::State &state) {
+  int n = state.range(0);
+  S21BasicMatrix<T> a(Filled(n, n, 1));
+  S21BasicMatrix<T> b(Filled(n, n, 2));
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::DoNotOptimize(a.Data());
+  }
+  SetCounters(state, 1.0 * n * n, 3.0 * sizeof(T) * n * n);
+}
+BENCHMARK_TEMPLATE(BM_SumMatrixTyped, float)
+    ->RangeMultiplier(8)
+    ->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_SumMatrixTyped, double)
+    ->RangeMultiplier(8)
+    ->Range(8, 4096);
+
+template <typename T>
+void BM_MulMatrixTyped(benchmark::State &state) {
+  int n = state.range(0);
+  S21BasicMatrix<T> a(Filled(n, n, 1));
+  S21BasicMatrix<T> b(Filled(n, n, 2));
+  for (auto _ : state) {
+    S21BasicMatrix<T> c = a * b;
+    benchmark::DoNotOptimize(c.Data());
+  }
+  SetCounters(state, 2.0 * n * n * n, 3.0 * sizeof(T) * n * n);
+}
+BENCHMARK_TEMPLATE(BM_MulMatrixTyped, float)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MulMatrixTyped, double)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+// Потоковое умножение файлов n x n с бюджетом в четверть операнда; второй
+// аргумент - предвыборка. overlap - доля ввода-вывода, скрытая за
+// вычислениями (страничный кэш ОС делает чтение дешевле, чем с диска).
+void BM_MulFiles(benchmark::State &state) {
+  int n = state.range(0);
+  Filled(n, n, 1).Save("bench_ooc_a.bin");
+  Filled(n, n, 2).Save("bench_ooc_b.bin");
+  S21OutOfCoreOptions options;
+  options.memory_budget = kDouble * n * n / 4;
+  options.prefetch = state.range(1) != 0;
+  S21OutOfCoreReport report;
+  for (auto _ : state) {
+    report = S21MulFiles("bench_ooc_a.bin", "bench_ooc_b.bin",
+                         "bench_ooc_c.bin", options);
+  }
+  SetCounters(state, 2.0 * n * n * n,
+              static_cast<double>(report.bytes_read + report.bytes_written));
+  state.counters["overlap"] = report.Overlap();
+  std::remove("bench_ooc_a.bin");
+  std::remove("bench_ooc_b.bin");
+  std::remove("bench_ooc_c.bin");
+}
+BENCHMARK(BM_MulFiles)
+    ->ArgsProduct({{512, 2048}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
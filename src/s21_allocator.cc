@@ -0,0 +1,372 @@
+#include "s21_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace {
+
+// Классы размеров: по четыре на каждую степень двойки (x1, x1.25, x1.5,
+// x1.75), начиная с 64 байт, так что округление теряет не больше 25%.
+constexpr std::size_t kMinClassBytes = 64;
+constexpr int kClassesPerDoubling = 4;
+
+int SizeClass(std::size_t bytes) {
+  bytes = std::max(bytes, kMinClassBytes);
+  int power = 0;
+  while ((kMinClassBytes << (power + 1)) <= bytes) {
+    power++;
+  }
+  std::size_t base = kMinClassBytes << power;
+  std::size_t step = base / kClassesPerDoubling;
+  int sub = static_cast<int>((bytes - base + step - 1) / step);
+  return power * kClassesPerDoubling + sub;
+}
+
+std::size_t ClassBytes(int size_class) {
+  int power = size_class / kClassesPerDoubling;
+  int sub = size_class % kClassesPerDoubling;
+  std::size_t base = kMinClassBytes << power;
+  return base + sub * (base / kClassesPerDoubling);
+}
+
+void *SystemAllocate(std::size_t bytes) {
+  return ::operator new(bytes, std::align_val_t(S21Allocator::kAlignment));
+}
+
+void SystemDeallocate(void *ptr) {
+  ::operator delete(ptr, std::align_val_t(S21Allocator::kAlignment));
+}
+
+// Счетчики одного потока. Пишет в них только владелец, поэтому атомарные
+// операции не конкурируют; при выходе потока значения переносятся в
+// Registry::retired.
+struct ThreadCounters {
+  std::atomic<std::uint64_t> pool_hits{0};
+  std::atomic<std::uint64_t> system_allocations{0};
+  std::atomic<std::uint64_t> arena_allocations{0};
+  // все запросы Allocate, читается только своим потоком
+  std::uint64_t requests = 0;
+};
+
+struct ThreadCache;
+
+// Реестр кэшей живых потоков. Создается один раз и не разрушается:
+// рабочие потоки пула завершаются при разрушении статических объектов
+// другой единицы трансляции и еще обращаются к нему.
+struct Registry {
+  std::mutex mutex;
+  std::vector<ThreadCache *> threads;
+  S21AllocatorStats retired;
+};
+
+Registry &GetRegistry() {
+  static Registry *registry = new Registry();
+  return *registry;
+}
+
+void Bump(std::atomic<std::uint64_t> &counter) {
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+}
+
+// выставляется при разрушении кэша потока
+thread_local bool cache_destroyed = false;
+
+// Общий лимит кэшей потоки занимают долями по kReserveStep: атомарная
+// операция над общим счетчиком нужна раз в несколько мегабайт, а не на
+// каждый блок.
+constexpr std::size_t kReserveStep = std::size_t(4) << 20;
+std::atomic<std::size_t> total_reserved{0};
+
+std::size_t RoundUpToStep(std::size_t bytes) {
+  return (bytes + kReserveStep - 1) / kReserveStep * kReserveStep;
+}
+
+// Списки свободных блоков потока. Блокировку берет владелец при каждом
+// обращении и S21PoolAllocator::TrimAll; она почти всегда свободна, и
+// снятие ее - обычная запись, так что обходится дешевле мьютекса.
+struct ThreadCache {
+  std::atomic<bool> locked{false};
+  std::vector<std::vector<void *>> free_lists;
+  // пишет только владелец под блокировкой, читает статистика
+  std::atomic<std::size_t> cached_bytes{0};
+  // доля общего лимита, занятая потоком, не меньше cached_bytes
+  std::size_t reserved = 0;
+  ThreadCounters counters;
+
+  ThreadCache() {
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(this);
+  }
+
+  ~ThreadCache() {
+    Trim();
+    cache_destroyed = true;
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.erase(
+        std::find(registry.threads.begin(), registry.threads.end(), this));
+    registry.retired.pool_hits += counters.pool_hits;
+    registry.retired.system_allocations += counters.system_allocations;
+    registry.retired.arena_allocations += counters.arena_allocations;
+  }
+
+  void Lock() {
+    while (locked.exchange(true, std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  void Unlock() { locked.store(false, std::memory_order_release); }
+
+  std::size_t Cached() const {
+    return cached_bytes.load(std::memory_order_relaxed);
+  }
+
+  void SetCached(std::size_t bytes) {
+    cached_bytes.store(bytes, std::memory_order_relaxed);
+  }
+
+  // Добирает долю общего лимита под cached_bytes + bytes; false, если
+  // лимит исчерпан.
+  bool Reserve(std::size_t bytes) {
+    if (Cached() + bytes <= reserved) {
+      return true;
+    }
+    std::size_t step = RoundUpToStep(Cached() + bytes - reserved);
+    if (total_reserved.fetch_add(step, std::memory_order_relaxed) + step >
+        S21PoolAllocator::kMaxTotalCachedBytes) {
+      total_reserved.fetch_sub(step, std::memory_order_relaxed);
+      return false;
+    }
+    reserved += step;
+    return true;
+  }
+
+  // возвращает лишнюю долю, когда кэш заметно опустел
+  void Release() {
+    std::size_t keep = RoundUpToStep(Cached());
+    if (reserved >= keep + 2 * kReserveStep) {
+      total_reserved.fetch_sub(reserved - keep, std::memory_order_relaxed);
+      reserved = keep;
+    }
+  }
+
+  void Trim() {
+    Lock();
+    for (std::vector<void *> &list : free_lists) {
+      for (void *ptr : list) {
+        SystemDeallocate(ptr);
+      }
+      list.clear();
+    }
+    SetCached(0);
+    total_reserved.fetch_sub(reserved, std::memory_order_relaxed);
+    reserved = 0;
+    Unlock();
+  }
+};
+
+// кэш текущего потока или nullptr, если поток уже завершается и кэш
+// разрушен (например, при освобождении глобальных матриц после main)
+ThreadCache *LocalCache() {
+  if (cache_destroyed) {
+    return nullptr;
+  }
+  thread_local ThreadCache cache;
+  return &cache;
+}
+
+std::atomic<S21Allocator *> default_allocator{nullptr};
+thread_local S21Allocator *scoped_allocator = nullptr;
+
+}  // namespace
+
+void *S21PoolAllocator::Allocate(std::size_t bytes) {
+  ThreadCache *local = LocalCache();
+  if (bytes > kMaxPooledBytes) {
+    if (local != nullptr) {
+      Bump(local->counters.system_allocations);
+      local->counters.requests++;
+    }
+    return SystemAllocate(bytes);
+  }
+  int size_class = SizeClass(bytes);
+  if (local == nullptr) {
+    return SystemAllocate(ClassBytes(size_class));
+  }
+  ThreadCache &cache = *local;
+  cache.counters.requests++;
+  cache.Lock();
+  if (size_class < static_cast<int>(cache.free_lists.size()) &&
+      !cache.free_lists[size_class].empty()) {
+    void *ptr = cache.free_lists[size_class].back();
+    cache.free_lists[size_class].pop_back();
+    cache.SetCached(cache.Cached() - ClassBytes(size_class));
+    cache.Release();
+    cache.Unlock();
+    Bump(cache.counters.pool_hits);
+    return ptr;
+  }
+  cache.Unlock();
+  Bump(cache.counters.system_allocations);
+  return SystemAllocate(ClassBytes(size_class));
+}
+
+// Блок попадает в кэш освобождающего потока, даже если был выделен
+// другим: так потоки не обращаются к чужим спискам (кроме TrimAll). Кэш
+// ограничен и в потоке, и в сумме по потокам, иначе пул из N потоков
+// держал бы до N * kMaxCachedBytes.
+void S21PoolAllocator::Deallocate(void *ptr, std::size_t bytes) {
+  if (ptr == nullptr) {
+    return;
+  }
+  ThreadCache *local = LocalCache();
+  if (local == nullptr || bytes > kMaxPooledBytes) {
+    SystemDeallocate(ptr);
+    return;
+  }
+  ThreadCache &cache = *local;
+  int size_class = SizeClass(bytes);
+  std::size_t class_bytes = ClassBytes(size_class);
+  cache.Lock();
+  if (cache.Cached() + class_bytes > kMaxCachedBytes ||
+      !cache.Reserve(class_bytes)) {
+    cache.Unlock();
+    SystemDeallocate(ptr);
+    return;
+  }
+  if (size_class >= static_cast<int>(cache.free_lists.size())) {
+    cache.free_lists.resize(size_class + 1);
+  }
+  cache.free_lists[size_class].push_back(ptr);
+  cache.SetCached(cache.Cached() + class_bytes);
+  cache.Unlock();
+}
+
+void S21PoolAllocator::Trim() {
+  ThreadCache *local = LocalCache();
+  if (local != nullptr) {
+    local->Trim();
+  }
+}
+
+// Реестр держится на время обхода, поэтому ни один кэш не разрушится
+// посередине (деструктор кэша ждет реестр).
+void S21PoolAllocator::TrimAll() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (ThreadCache *cache : registry.threads) {
+    cache->Trim();
+  }
+}
+
+// по той же причине, что и реестр, пул не разрушается
+S21PoolAllocator &S21PoolAllocator::Instance() {
+  static S21PoolAllocator *pool = new S21PoolAllocator();
+  return *pool;
+}
+
+S21Arena::S21Arena(std::size_t chunk_bytes)
+    : chunk_bytes_(std::max(chunk_bytes, kAlignment)),
+      chunks_(),
+      current_(0),
+      offset_(0),
+      last_(nullptr) {}
+
+S21Arena::~S21Arena() {
+  for (Chunk &chunk : chunks_) {
+    SystemDeallocate(chunk.data);
+  }
+}
+
+void *S21Arena::Allocate(std::size_t bytes) {
+  bytes = (std::max<std::size_t>(bytes, 1) + kAlignment - 1) / kAlignment *
+          kAlignment;
+  while (current_ < chunks_.size() &&
+         offset_ + bytes > chunks_[current_].size) {
+    current_++;
+    offset_ = 0;
+  }
+  ThreadCache *local = LocalCache();
+  if (current_ == chunks_.size()) {
+    std::size_t size = std::max(chunk_bytes_, bytes);
+    chunks_.push_back({static_cast<char *>(SystemAllocate(size)), size});
+    if (local != nullptr) {
+      Bump(local->counters.system_allocations);
+    }
+    offset_ = 0;
+  }
+  if (local != nullptr) {
+    Bump(local->counters.arena_allocations);
+    local->counters.requests++;
+  }
+  last_ = chunks_[current_].data + offset_;
+  offset_ += bytes;
+  return last_;
+}
+
+void S21Arena::Deallocate(void *ptr, std::size_t) {
+  if (ptr != nullptr && ptr == last_) {
+    offset_ = static_cast<std::size_t>(last_ - chunks_[current_].data);
+    last_ = nullptr;
+  }
+}
+
+// куски памяти остаются за ареной и используются заново
+void S21Arena::Reset() {
+  current_ = 0;
+  offset_ = 0;
+  last_ = nullptr;
+}
+
+std::size_t S21Arena::BytesUsed() const {
+  std::size_t used = offset_;
+  for (std::size_t i = 0; i < current_ && i < chunks_.size(); i++) {
+    used += chunks_[i].size;
+  }
+  return used;
+}
+
+S21ArenaScope::S21ArenaScope(S21Arena &arena) : previous_(scoped_allocator) {
+  scoped_allocator = &arena;
+}
+
+S21ArenaScope::~S21ArenaScope() { scoped_allocator = previous_; }
+
+S21Allocator &S21CurrentAllocator() {
+  if (scoped_allocator != nullptr) {
+    return *scoped_allocator;
+  }
+  S21Allocator *allocator = default_allocator.load(std::memory_order_acquire);
+  return allocator != nullptr ? *allocator : S21PoolAllocator::Instance();
+}
+
+void S21SetDefaultAllocator(S21Allocator *allocator) {
+  default_allocator.store(allocator, std::memory_order_release);
+}
+
+S21AllocatorStats S21GetAllocatorStats() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  S21AllocatorStats stats = registry.retired;
+  for (const ThreadCache *cache : registry.threads) {
+    stats.cached_bytes += cache->Cached();
+    const ThreadCounters *counters = &cache->counters;
+    stats.pool_hits += counters->pool_hits.load(std::memory_order_relaxed);
+    stats.system_allocations +=
+        counters->system_allocations.load(std::memory_order_relaxed);
+    stats.arena_allocations +=
+        counters->arena_allocations.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+std::uint64_t S21ThreadAllocations() {
+  ThreadCache *local = LocalCache();
+  return local != nullptr ? local->counters.requests : 0;
+}
@@ -0,0 +1,103 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_ALLOCATOR_H_
+#define CPP1_S21_MATRIXPLUS_S21_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Источник памяти для буферов матриц и внутренних временных буферов.
+// Все блоки выровнены по 64 байта; при освобождении передается тот же
+// размер, что и при выделении.
+class S21Allocator {
+ public:
+  static constexpr std::size_t kAlignment = 64;
+
+  virtual ~S21Allocator() = default;
+  virtual void *Allocate(std::size_t bytes) = 0;
+  virtual void Deallocate(void *ptr, std::size_t bytes) = 0;
+};
+
+// Пул с классами размеров и отдельным кэшем свободных блоков в каждом
+// потоке: выделение и освобождение не берут общих блокировок. Блоки
+// крупнее kMaxPooledBytes и промахи кэша идут в системный operator new,
+// блоки сверх лимитов кэша возвращаются системе сразу.
+class S21PoolAllocator : public S21Allocator {
+ public:
+  static constexpr std::size_t kMaxPooledBytes = std::size_t(64) << 20;
+  // сколько байт свободных блоков один поток держит у себя
+  static constexpr std::size_t kMaxCachedBytes = std::size_t(128) << 20;
+  // и сколько все потоки вместе
+  static constexpr std::size_t kMaxTotalCachedBytes = std::size_t(512) << 20;
+
+  void *Allocate(std::size_t bytes) override;
+  void Deallocate(void *ptr, std::size_t bytes) override;
+  // возвращает системе свободные блоки кэша текущего потока
+  void Trim();
+  // то же для кэшей всех потоков, включая простаивающих рабочих пула
+  void TrimAll();
+
+  static S21PoolAllocator &Instance();
+};
+
+// Арена: память выдается сдвигом указателя внутри крупных кусков, а
+// освобождается целиком при Reset() или разрушении арены. Освобождение
+// последнего выделенного блока возвращает его сразу, так что вложенные
+// временные буферы переиспользуют одно и то же место.
+class S21Arena : public S21Allocator {
+ public:
+  explicit S21Arena(std::size_t chunk_bytes = std::size_t(1) << 20);
+  ~S21Arena() override;
+  S21Arena(const S21Arena &) = delete;
+  S21Arena &operator=(const S21Arena &) = delete;
+
+  void *Allocate(std::size_t bytes) override;
+  void Deallocate(void *ptr, std::size_t bytes) override;
+  void Reset();
+  std::size_t BytesUsed() const;
+
+ private:
+  struct Chunk {
+    char *data;
+    std::size_t size;
+  };
+
+  std::size_t chunk_bytes_;
+  std::vector<Chunk> chunks_;
+  std::size_t current_;
+  std::size_t offset_;
+  char *last_;
+};
+
+// Делает арену текущим источником памяти в этом потоке на время жизни
+// объекта: из неё берутся и новые матрицы, и временные буферы операций.
+// Матрицы, созданные внутри области, не должны переживать арену.
+class S21ArenaScope {
+ public:
+  explicit S21ArenaScope(S21Arena &arena);
+  ~S21ArenaScope();
+  S21ArenaScope(const S21ArenaScope &) = delete;
+  S21ArenaScope &operator=(const S21ArenaScope &) = delete;
+
+ private:
+  S21Allocator *previous_;
+};
+
+// Текущий источник памяти: арена из S21ArenaScope, иначе распределитель
+// по умолчанию (пул, если не задан другой через S21SetDefaultAllocator).
+S21Allocator &S21CurrentAllocator();
+void S21SetDefaultAllocator(S21Allocator *allocator);
+
+struct S21AllocatorStats {
+  std::uint64_t pool_hits = 0;           // выдано из кэша пула
+  std::uint64_t system_allocations = 0;  // ушло в operator new / malloc
+  std::uint64_t arena_allocations = 0;   // выдано ареной
+  std::uint64_t cached_bytes = 0;        // свободно в кэшах пула
+};
+
+// суммарная статистика по всем потокам
+S21AllocatorStats S21GetAllocatorStats();
+// число запросов памяти (к пулу и аренам) из текущего потока; дешево,
+// блокировок не берет
+std::uint64_t S21ThreadAllocations();
+
+#endif
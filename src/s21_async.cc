@@ -0,0 +1,50 @@
+#include "s21_async.h"
+
+#include <algorithm>
+
+namespace {
+
+// Потоки исполнителя: одна долгая операция не задерживает следующую, а
+// вычисления внутри операций все равно идут в общем пуле.
+constexpr int kAsyncWorkers = 2;
+
+thread_local S21AsyncScope *current_scope = nullptr;
+
+}  // namespace
+
+void S21Checkpoint(double done) {
+  S21AsyncScope *scope = current_scope;
+  if (scope == nullptr) {
+    return;
+  }
+  if (scope->Options().token.IsCancelled()) {
+    throw S21OperationCancelled();
+  }
+  scope->Report(done);
+}
+
+S21AsyncScope::S21AsyncScope(const S21AsyncOptions &options)
+    : options_(options), previous_(current_scope), reported_(-1.0) {
+  current_scope = this;
+}
+
+S21AsyncScope::~S21AsyncScope() { current_scope = previous_; }
+
+// повторные и меньшие значения (операция перешла к другому алгоритму) не
+// сообщаются
+void S21AsyncScope::Report(double done) {
+  done = std::min(1.0, std::max(0.0, done));
+  if (done <= reported_) {
+    return;
+  }
+  reported_ = done;
+  if (options_.progress) {
+    options_.progress(done);
+  }
+}
+
+// пул создается при первой асинхронной операции
+void S21SubmitAsync(std::function<void()> job) {
+  static S21ThreadPool executor(kAsyncWorkers);
+  executor.Submit(std::move(job));
+}
@@ -0,0 +1,107 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_ASYNC_H_
+#define CPP1_S21_MATRIXPLUS_S21_ASYNC_H_
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+// Асинхронное выполнение операций (MulMatrixAsync, InverseAsync и т. д.).
+// Задачи идут в исполнитель библиотеки - отдельный от S21ParallelFor пул,
+// так что долгая операция не занимает потоки, которыми пользуются
+// синхронные вызовы, а сама внутри делится между ними как обычно.
+
+// Флаг отмены; копии токена разделяют один флаг.
+class S21CancellationToken {
+ public:
+  S21CancellationToken()
+      : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+  void Cancel() const { cancelled_->store(true); }
+  bool IsCancelled() const { return cancelled_->load(); }
+
+ private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// исключение, которым завершается future отмененной операции
+class S21OperationCancelled : public std::runtime_error {
+ public:
+  S21OperationCancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+struct S21AsyncOptions {
+  S21CancellationToken token;
+  // доля выполненной работы от 0 до 1, не убывает; вызывается в потоке
+  // исполнителя между блоками
+  std::function<void(double)> progress;
+  // вызывается в потоке исполнителя, когда future уже готов (в том числе
+  // с исключением); через него корутина может возобновиться без ожидания
+  std::function<void()> on_complete;
+};
+
+// Точка между блоками долгой операции: в асинхронной операции бросает
+// S21OperationCancelled после отмены и сообщает долю выполненной работы,
+// в остальных случаях ничего не делает.
+void S21Checkpoint(double done);
+
+// доля работы исключения со стоимостью O(n^3), выполненная к шагу k из n
+inline double S21EliminationProgress(int k, int n) {
+  double left = n > 0 ? 1.0 - static_cast<double>(k) / n : 0.0;
+  return 1.0 - left * left * left;
+}
+
+// Связывает текущий поток с асинхронной операцией на время жизни объекта.
+class S21AsyncScope {
+ public:
+  explicit S21AsyncScope(const S21AsyncOptions &options);
+  ~S21AsyncScope();
+  S21AsyncScope(const S21AsyncScope &) = delete;
+  S21AsyncScope &operator=(const S21AsyncScope &) = delete;
+
+  const S21AsyncOptions &Options() const { return options_; }
+  void Report(double done);
+
+ private:
+  const S21AsyncOptions &options_;
+  S21AsyncScope *previous_;
+  double reported_;
+};
+
+// ставит задачу в очередь исполнителя библиотеки
+void S21SubmitAsync(std::function<void()> job);
+
+// Выполняет task в исполнителе с политикой вызывающего потока. Отмена до
+// начала работы тоже завершает future исключением S21OperationCancelled.
+template <typename R>
+std::future<R> S21RunAsync(S21AsyncOptions options,
+                           std::function<R()> task) {
+  auto promise = std::make_shared<std::promise<R>>();
+  std::future<R> future = promise->get_future();
+  S21ExecutionPolicy policy = S21GetExecutionPolicy();
+  S21SubmitAsync([promise, policy, options = std::move(options),
+                  task = std::move(task)]() {
+    {
+      S21ScopedExecutionPolicy scoped_policy(policy);
+      S21AsyncScope scope(options);
+      try {
+        S21Checkpoint(0.0);
+        R result = task();
+        scope.Report(1.0);
+        promise->set_value(std::move(result));
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+      }
+    }
+    if (options.on_complete) {
+      options.on_complete();
+    }
+  });
+  return future;
+}
+
+#endif
@@ -0,0 +1,231 @@
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// сторона блока: диагональный блок и полоса панели помещаются в L1/L2
+constexpr int kCholeskyBlock = 64;
+
+// Неблочное разложение диагонального блока nb x nb на месте. Диагональ
+// не больше threshold означает, что матрица не положительно определена
+// (или вырождена в пределах округления).
+template <typename T>
+bool FactorDiagonal(int nb, T *a, std::ptrdiff_t stride, T threshold) {
+  for (int j = 0; j < nb; j++) {
+    T *row_j = a + j * stride;
+    T diagonal = row_j[j];
+    for (int p = 0; p < j; p++) {
+      diagonal -= row_j[p] * row_j[p];
+    }
+    if (!(diagonal > threshold)) {
+      return false;
+    }
+    diagonal = std::sqrt(diagonal);
+    row_j[j] = diagonal;
+    for (int i = j + 1; i < nb; i++) {
+      T *row_i = a + i * stride;
+      T sum = row_i[j];
+      for (int p = 0; p < j; p++) {
+        sum -= row_i[p] * row_j[p];
+      }
+      row_i[j] = sum / diagonal;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+// Правосторонний блочный алгоритм: на шаге k раскладывается диагональный
+// блок L11, панель под ним решается как L21 = A21 * L11^-T (строки
+// независимы), а остаток обновляется A22 -= L21 * L21^T. Обновление идет
+// полосами по kCholeskyBlock строк, и каждая полоса умножается через
+// S21Gemm только до диагонали, так что считается лишь нижний треугольник:
+// n^3 / 3 операций против 2 n^3 / 3 у LU.
+template <typename T>
+S21BasicCholesky<T>::S21BasicCholesky(const S21BasicMatrix<T> &matrix)
+    : factors_(matrix), positive_definite_(true) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (std::is_integral<T>::value) {
+    throw std::logic_error("Cholesky is not defined for integer matrices");
+  }
+  int n = factors_.GetRows();
+  std::ptrdiff_t stride = factors_.Stride();
+  T *a = factors_.Data();
+  T threshold = S21BasicLU<T>::SingularThreshold(factors_);
+
+  for (int k = 0; k < n; k += kCholeskyBlock) {
+    S21Checkpoint(S21EliminationProgress(k, n));
+    int nb = std::min(kCholeskyBlock, n - k);
+    T *l11 = a + k * stride + k;
+    if (!FactorDiagonal(nb, l11, stride, threshold)) {
+      positive_definite_ = false;
+      break;
+    }
+    int first = k + nb;
+    int rest = n - first;
+    if (rest == 0) {
+      break;
+    }
+    double work = static_cast<double>(rest) * nb * nb;
+    S21ParallelFor(first, n, work, [&](int from, int to) {
+      for (int i = from; i < to; i++) {
+        T *row = a + i * stride + k;
+        for (int j = 0; j < nb; j++) {
+          const T *l_row = l11 + j * stride;
+          T sum = row[j];
+          for (int p = 0; p < j; p++) {
+            sum -= row[p] * l_row[p];
+          }
+          row[j] = sum / l_row[j];
+        }
+      }
+    });
+
+    // L21^T подряд в памяти, чтобы передать его в S21Gemm как матрицу
+    S21BasicScratchBuffer<T> panel_t(static_cast<std::size_t>(nb) * rest);
+    for (int i = 0; i < rest; i++) {
+      const T *row = a + (first + i) * stride + k;
+      for (int p = 0; p < nb; p++) {
+        panel_t.Get()[p * rest + i] = row[p];
+      }
+    }
+    int strips = (rest + kCholeskyBlock - 1) / kCholeskyBlock;
+    work = static_cast<double>(rest) * rest * nb;
+    S21ParallelFor(0, strips, work, [&](int from, int to) {
+      for (int strip = from; strip < to; strip++) {
+        int row0 = first + strip * kCholeskyBlock;
+        int rows = std::min(kCholeskyBlock, n - row0);
+        int cols = row0 + rows - first;
+        S21BasicScratchBuffer<T> product(static_cast<std::size_t>(rows) *
+                                         cols);
+        S21Gemm(rows, cols, nb, a + row0 * stride + k, stride, panel_t.Get(),
+                rest, product.Get(), cols);
+        for (int r = 0; r < rows; r++) {
+          T *row = a + (row0 + r) * stride + first;
+          const T *update = product.Get() + r * cols;
+          for (int c = 0; c < cols; c++) {
+            row[c] -= update[c];
+          }
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < n; i++) {
+    std::fill(a + i * stride + i + 1, a + i * stride + n, T(0));
+  }
+}
+
+template <typename T>
+bool S21BasicCholesky<T>::IsPositiveDefinite() const {
+  return positive_definite_;
+}
+
+template <typename T>
+T S21BasicCholesky<T>::Determinant() const {
+  if (!positive_definite_) {
+    throw std::logic_error("Matrix is not positive definite");
+  }
+  int n = factors_.GetRows();
+  const T *a = factors_.Data();
+  T result = 1;
+  for (int k = 0; k < n; k++) {
+    T diagonal = a[k * factors_.Stride() + k];
+    result *= diagonal * diagonal;
+  }
+  return result;
+}
+
+template <typename T>
+const S21BasicMatrix<T> &S21BasicCholesky<T>::Factor() const {
+  return factors_;
+}
+
+// Прямой ход по L и обратный по L^T обновлением строк rhs целиком;
+// столбцы rhs независимы и делятся между потоками.
+template <typename T>
+S21BasicMatrix<T> S21BasicCholesky<T>::Solve(
+    const S21BasicMatrix<T> &rhs) const {
+  int n = factors_.GetRows();
+  if (rhs.GetRows() != n) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  if (!positive_definite_ || n == 0) {
+    throw std::logic_error("Мatrix is not invertible.");
+  }
+  S21BasicMatrix<T> result = rhs;
+  std::ptrdiff_t stride = result.Stride();
+  std::ptrdiff_t l_stride = factors_.Stride();
+  const T *l = factors_.Data();
+  T *x = result.Data();
+  double work = static_cast<double>(n) * n * result.GetCols();
+  S21ParallelFor(0, result.GetCols(), work, [&](int first, int last) {
+    for (int i = 0; i < n; i++) {
+      T *row_i = x + i * stride;
+      for (int k = 0; k < i; k++) {
+        T factor = l[i * l_stride + k];
+        const T *row_k = x + k * stride;
+        for (int j = first; j < last; j++) {
+          row_i[j] -= factor * row_k[j];
+        }
+      }
+      T diagonal = l[i * l_stride + i];
+      for (int j = first; j < last; j++) {
+        row_i[j] /= diagonal;
+      }
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      T *row_i = x + i * stride;
+      for (int k = i + 1; k < n; k++) {
+        T factor = l[k * l_stride + i];
+        const T *row_k = x + k * stride;
+        for (int j = first; j < last; j++) {
+          row_i[j] -= factor * row_k[j];
+        }
+      }
+      T diagonal = l[i * l_stride + i];
+      for (int j = first; j < last; j++) {
+        row_i[j] /= diagonal;
+      }
+    }
+  });
+  return result;
+}
+
+// Строка j матрицы U = L^-T считается прямой подстановкой за n^3 / 3
+// операций (строки независимы), затем A^-1 = U * U^T одним умножением.
+template <typename T>
+S21BasicMatrix<T> S21BasicCholesky<T>::Inverse() const {
+  int n = factors_.GetRows();
+  if (!positive_definite_ || n == 0) {
+    throw std::logic_error("Мatrix is not invertible.");
+  }
+  std::ptrdiff_t l_stride = factors_.Stride();
+  const T *l = factors_.Data();
+  S21BasicMatrix<T> upper(n, n);
+  T *u = upper.Data();
+  std::ptrdiff_t stride = upper.Stride();
+  double work = static_cast<double>(n) * n * n / 3;
+  S21ParallelFor(0, n, work, [&](int first, int last) {
+    for (int j = first; j < last; j++) {
+      T *row = u + j * stride;
+      row[j] = T(1) / l[j * l_stride + j];
+      for (int i = j + 1; i < n; i++) {
+        const T *l_row = l + i * l_stride;
+        T sum = 0;
+        for (int k = j; k < i; k++) {
+          sum += l_row[k] * row[k];
+        }
+        row[i] = -sum / l_row[i];
+      }
+    }
+  });
+  return upper * upper.Transpose();
+}
+
+#define S21_INSTANTIATE_CHOLESKY(T) template class S21BasicCholesky<T>;
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_CHOLESKY)
+#undef S21_INSTANTIATE_CHOLESKY
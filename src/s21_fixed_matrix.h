@@ -0,0 +1,374 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_FIXED_MATRIX_H_
+#define CPP1_S21_MATRIXPLUS_S21_FIXED_MATRIX_H_
+
+// Матрица с размерами времени компиляции. Элементы лежат по строкам во
+// встроенном std::array, так что объект не выделяет памяти, а все операции
+// constexpr и разворачиваются компилятором целиком. Несовместимые размеры
+// (сложение 2x3 с 3x2, умножение 2x3 на 2x3, определитель 2x3) не
+// компилируются. Включается из s21_matrix_oop.h.
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <int R, int C, typename T = double>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "S21FixedMatrix dimensions must be positive");
+
+ public:
+  using value_type = T;
+
+  constexpr S21FixedMatrix() : data_() {}
+  constexpr explicit S21FixedMatrix(const std::array<T, R * C> &values)
+      : data_(values) {}
+  // элементы по строкам; недостающие заполняются нулями
+  constexpr S21FixedMatrix(std::initializer_list<T> values) : data_() {
+    if (values.size() > static_cast<std::size_t>(R * C)) {
+      throw std::invalid_argument("Too many values for S21FixedMatrix");
+    }
+    std::size_t index = 0;
+    for (T value : values) {
+      data_[index++] = value;
+    }
+  }
+  // размеры S21Matrix должны совпадать с R x C
+  explicit S21FixedMatrix(const S21Matrix &other);
+  explicit operator S21Matrix() const;
+
+  static constexpr S21FixedMatrix Identity() {
+    S21FixedMatrix result;
+    for (int i = 0; i < R && i < C; i++) {
+      result.data_[i * C + i] = T(1);
+    }
+    return result;
+  }
+
+  static constexpr int GetRows() { return R; }
+  static constexpr int GetCols() { return C; }
+
+  // доступ без проверки индексов
+  constexpr T operator()(int row, int col) const {
+    return data_[row * C + col];
+  }
+  constexpr T &operator()(int row, int col) { return data_[row * C + col]; }
+  // доступ с проверкой, как у S21Matrix
+  constexpr T At(int row, int col) const {
+    if (row < 0 || row >= R || col < 0 || col >= C) {
+      throw std::out_of_range("Invalid rows or/and columns!");
+    }
+    return data_[row * C + col];
+  }
+  constexpr const T *Data() const { return data_.data(); }
+  constexpr T *Data() { return data_.data(); }
+
+  constexpr bool EqMatrix(const S21FixedMatrix &other) const {
+    return Equal(other, std::make_index_sequence<R * C>());
+  }
+  constexpr bool operator==(const S21FixedMatrix &other) const {
+    return EqMatrix(other);
+  }
+  constexpr bool operator!=(const S21FixedMatrix &other) const {
+    return !EqMatrix(other);
+  }
+
+  constexpr void SumMatrix(const S21FixedMatrix &other) {
+    *this = *this + other;
+  }
+  constexpr void SubMatrix(const S21FixedMatrix &other) {
+    *this = *this - other;
+  }
+  constexpr void MulNumber(T num) { *this = *this * num; }
+  // умножение на месте возможно только на квадратную матрицу C x C
+  constexpr void MulMatrix(const S21FixedMatrix<C, C, T> &other) {
+    *this = *this * other;
+  }
+  constexpr S21FixedMatrix &operator+=(const S21FixedMatrix &other) {
+    SumMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix &operator-=(const S21FixedMatrix &other) {
+    SubMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix &operator*=(T num) {
+    MulNumber(num);
+    return *this;
+  }
+  constexpr S21FixedMatrix &operator*=(const S21FixedMatrix<C, C, T> &other) {
+    MulMatrix(other);
+    return *this;
+  }
+
+  friend constexpr S21FixedMatrix operator+(const S21FixedMatrix &lhs,
+                                            const S21FixedMatrix &rhs) {
+    return lhs.Map(rhs, std::plus<T>(), std::make_index_sequence<R * C>());
+  }
+  friend constexpr S21FixedMatrix operator-(const S21FixedMatrix &lhs,
+                                            const S21FixedMatrix &rhs) {
+    return lhs.Map(rhs, std::minus<T>(), std::make_index_sequence<R * C>());
+  }
+  friend constexpr S21FixedMatrix operator*(const S21FixedMatrix &lhs, T num) {
+    return lhs.Scale(num, std::make_index_sequence<R * C>());
+  }
+  friend constexpr S21FixedMatrix operator*(T num, const S21FixedMatrix &rhs) {
+    return rhs * num;
+  }
+  template <int K>
+  constexpr S21FixedMatrix<R, K, T> operator*(
+      const S21FixedMatrix<C, K, T> &other) const {
+    return Product(other, std::make_index_sequence<R * K>());
+  }
+
+  constexpr S21FixedMatrix<C, R, T> Transpose() const {
+    return TransposeImpl(std::make_index_sequence<R * C>());
+  }
+
+  // матрица без строки row и столбца col
+  constexpr S21FixedMatrix<R - 1, C - 1, T> Minor(int row, int col) const {
+    static_assert(R > 1 && C > 1, "Minor does not exist for 1xN or Nx1");
+    S21FixedMatrix<R - 1, C - 1, T> result;
+    for (int i = 0, m_row = 0; i < R; i++) {
+      if (i == row) {
+        continue;
+      }
+      for (int j = 0, m_col = 0; j < C; j++) {
+        if (j != col) {
+          result(m_row, m_col++) = data_[i * C + j];
+        }
+      }
+      m_row++;
+    }
+    return result;
+  }
+
+  // до 4x4 - явные формулы, дальше - исключение Гаусса с выбором
+  // ведущего элемента (для целых T - без дробей, по Барейсу)
+  constexpr T Determinant() const {
+    static_assert(R == C, "Matrix is not square");
+    const S21FixedMatrix &a = *this;
+    if constexpr (R == 1) {
+      return a(0, 0);
+    } else if constexpr (R == 2) {
+      return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+    } else if constexpr (R == 3) {
+      return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1)) -
+             a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0)) +
+             a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+    } else if constexpr (R == 4) {
+      // разложение по первым двум строкам через миноры 2x2
+      T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+      T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+      T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+      T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+      T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+      T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+      T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+      T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+      T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+      T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+      T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+      T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+      return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    } else {
+      return Eliminate();
+    }
+  }
+
+  constexpr S21FixedMatrix CalcComplements() const {
+    static_assert(R == C, "Matrix is not square");
+    static_assert(R > 1, "CalcComplements does not exist for matrix size 1x1");
+    S21FixedMatrix result;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        T minor_det = Minor(i, j).Determinant();
+        result(i, j) = (i + j) % 2 == 0 ? minor_det : -minor_det;
+      }
+    }
+    return result;
+  }
+
+  // A^-1 = adj(A) / det(A); матрица считается вырожденной, если
+  // |det| <= n * eps * max|a|^n (порог того же вида, что в S21LU)
+  constexpr S21FixedMatrix InverseMatrix() const {
+    static_assert(R == C, "Matrix is not square");
+    static_assert(std::is_floating_point<T>::value,
+                  "InverseMatrix requires a floating-point element type");
+    T det = Determinant();
+    if (IsSingular(det)) {
+      throw std::logic_error("Мatrix is not invertible.");
+    }
+    if constexpr (R == 1) {
+      return S21FixedMatrix({T(1) / det});
+    } else {
+      return CalcComplements().Transpose() * (T(1) / det);
+    }
+  }
+
+ private:
+  std::array<T, R * C> data_;
+
+  template <int, int, typename>
+  friend class S21FixedMatrix;
+
+  static constexpr T Abs(T value) { return value < T(0) ? -value : value; }
+
+  static constexpr bool Close(T a, T b) {
+    if constexpr (std::is_floating_point<T>::value) {
+      return Abs(a - b) <= S21MatrixTraits<T>::kTolerance;
+    } else {
+      return a == b;
+    }
+  }
+
+  template <std::size_t... I>
+  constexpr bool Equal(const S21FixedMatrix &other,
+                       std::index_sequence<I...>) const {
+    return (Close(data_[I], other.data_[I]) && ...);
+  }
+
+  template <typename Op, std::size_t... I>
+  constexpr S21FixedMatrix Map(const S21FixedMatrix &other, Op op,
+                               std::index_sequence<I...>) const {
+    return S21FixedMatrix(
+        std::array<T, R * C>{{op(data_[I], other.data_[I])...}});
+  }
+
+  template <std::size_t... I>
+  constexpr S21FixedMatrix Scale(T num, std::index_sequence<I...>) const {
+    return S21FixedMatrix(std::array<T, R * C>{{(data_[I] * num)...}});
+  }
+
+  template <int K, std::size_t... P>
+  constexpr T Dot(const S21FixedMatrix<C, K, T> &other, int row, int col,
+                  std::index_sequence<P...>) const {
+    return ((data_[row * C + P] * other.data_[P * K + col]) + ...);
+  }
+
+  template <int K, std::size_t... I>
+  constexpr S21FixedMatrix<R, K, T> Product(
+      const S21FixedMatrix<C, K, T> &other, std::index_sequence<I...>) const {
+    return S21FixedMatrix<R, K, T>(std::array<T, R * K>{
+        {Dot(other, I / K, I % K, std::make_index_sequence<C>())...}});
+  }
+
+  template <std::size_t... I>
+  constexpr S21FixedMatrix<C, R, T> TransposeImpl(
+      std::index_sequence<I...>) const {
+    return S21FixedMatrix<C, R, T>(
+        std::array<T, R * C>{{data_[(I % R) * C + I / R]...}});
+  }
+
+  constexpr bool IsSingular(T det) const {
+    T max_abs = T(0);
+    for (T value : data_) {
+      max_abs = Abs(value) > max_abs ? Abs(value) : max_abs;
+    }
+    T scale = T(R) * std::numeric_limits<T>::epsilon();
+    for (int i = 0; i < R; i++) {
+      scale *= max_abs;
+    }
+    return Abs(det) <= scale;
+  }
+
+  // Определитель исключением Гаусса в копии матрицы. Для целых T деление
+  // на ведущий элемент отбросило бы дробную часть, поэтому они считаются
+  // без дробей, как BareissDeterminant у S21Matrix.
+  constexpr T Eliminate() const {
+    if constexpr (!std::is_floating_point<T>::value) {
+      return Bareiss();
+    }
+    std::array<T, R * C> a = data_;
+    T det = T(1);
+    for (int k = 0; k < R; k++) {
+      int pivot = k;
+      for (int i = k + 1; i < R; i++) {
+        if (Abs(a[i * C + k]) > Abs(a[pivot * C + k])) {
+          pivot = i;
+        }
+      }
+      if (a[pivot * C + k] == T(0)) {
+        return T(0);
+      }
+      if (pivot != k) {
+        for (int j = 0; j < C; j++) {
+          T tmp = a[k * C + j];
+          a[k * C + j] = a[pivot * C + j];
+          a[pivot * C + j] = tmp;
+        }
+        det = -det;
+      }
+      det *= a[k * C + k];
+      for (int i = k + 1; i < R; i++) {
+        T factor = a[i * C + k] / a[k * C + k];
+        for (int j = k + 1; j < C; j++) {
+          a[i * C + j] -= factor * a[k * C + j];
+        }
+      }
+    }
+    return det;
+  }
+
+  // каждый шаг делится нацело на ведущий элемент предыдущего шага
+  constexpr T Bareiss() const {
+    std::array<T, R * C> a = data_;
+    T sign = T(1);
+    T previous = T(1);
+    for (int k = 0; k < R - 1; k++) {
+      if (a[k * C + k] == T(0)) {
+        int pivot = k + 1;
+        while (pivot < R && a[pivot * C + k] == T(0)) {
+          pivot++;
+        }
+        if (pivot == R) {
+          return T(0);
+        }
+        for (int j = 0; j < C; j++) {
+          T tmp = a[k * C + j];
+          a[k * C + j] = a[pivot * C + j];
+          a[pivot * C + j] = tmp;
+        }
+        sign = -sign;
+      }
+      for (int i = k + 1; i < R; i++) {
+        for (int j = k + 1; j < C; j++) {
+          a[i * C + j] =
+              (a[i * C + j] * a[k * C + k] - a[i * C + k] * a[k * C + j]) /
+              previous;
+        }
+      }
+      previous = a[k * C + k];
+    }
+    return sign * a[(R - 1) * C + R - 1];
+  }
+};
+
+template <int R, int C, typename T>
+S21FixedMatrix<R, C, T>::S21FixedMatrix(const S21Matrix &other) : data_() {
+  if (other.GetRows() != R || other.GetCols() != C) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  for (int i = 0; i < R; i++) {
+    for (int j = 0; j < C; j++) {
+      data_[i * C + j] = static_cast<T>(other.Data()[i * other.Stride() + j]);
+    }
+  }
+}
+
+template <int R, int C, typename T>
+S21FixedMatrix<R, C, T>::operator S21Matrix() const {
+  S21Matrix result(R, C);
+  for (int i = 0; i < R; i++) {
+    for (int j = 0; j < C; j++) {
+      result.Data()[i * result.Stride() + j] =
+          static_cast<double>(data_[i * C + j]);
+    }
+  }
+  return result;
+}
+
+#endif
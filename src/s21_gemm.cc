@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+// Блочное умножение по схеме Goto/BLIS. Матрица B разбивается на панели
+// kKc x kNc (живут в L3), A - на блоки kMc x kKc (живут в L2). Оба операнда
+// упаковываются в непрерывные полосы шириной kMr и kNr, так что
+// микроядро читает память строго последовательно, а блок C размера
+// kMr x kNr целиком держит в регистрах. Строка блока C занимает одну
+// кэш-линию, поэтому для float полосы B вдвое шире, чем для double.
+namespace {
+
+constexpr int kMr = 4;
+template <typename T>
+constexpr int kNr = 64 / sizeof(T);
+constexpr int kKc = 256;
+constexpr int kMc = 128;
+constexpr int kNc = 4096;
+
+// упаковка блока A (mc x kc) в полосы по kMr строк: внутри полосы элементы
+// идут столбец за столбцом, недостающие строки последней полосы - нули;
+// lda и a_col - шаги между строками и между столбцами A; у плотных
+// операндов (Strided == false) шаг по столбцам - единица на этапе компиляции
+template <typename T, bool Strided>
+void PackA(int mc, int kc, const T *a, std::ptrdiff_t lda,
+           std::ptrdiff_t a_col, T *packed) {
+  if constexpr (!Strided) {
+    a_col = 1;
+  }
+  for (int i = 0; i < mc; i += kMr) {
+    int rows = std::min(kMr, mc - i);
+    for (int p = 0; p < kc; p++) {
+      for (int r = 0; r < rows; r++) {
+        packed[r] = a[(i + r) * lda + p * a_col];
+      }
+      for (int r = rows; r < kMr; r++) {
+        packed[r] = T(0);
+      }
+      packed += kMr;
+    }
+  }
+}
+
+// упаковка панели B (kc x nc) в полосы по kNr столбцов; у плотной B
+// строка полосы копируется подряд, у транспонированного вида - с шагом
+template <typename T, bool Strided>
+void PackB(int kc, int nc, const T *b, std::ptrdiff_t ldb,
+           std::ptrdiff_t b_col, T *packed) {
+  if constexpr (!Strided) {
+    b_col = 1;
+  }
+  for (int j = 0; j < nc; j += kNr<T>) {
+    int cols = std::min(kNr<T>, nc - j);
+    for (int p = 0; p < kc; p++) {
+      const T *src = b + p * ldb + j * b_col;
+      if (b_col == 1) {
+        for (int c = 0; c < cols; c++) {
+          packed[c] = src[c];
+        }
+      } else {
+        for (int c = 0; c < cols; c++) {
+          packed[c] = src[c * b_col];
+        }
+      }
+      for (int c = cols; c < kNr<T>; c++) {
+        packed[c] = T(0);
+      }
+      packed += kNr<T>;
+    }
+  }
+}
+
+// Микроядро: блок kMr x kNr накапливается в регистрах. Строка блока -
+// один вектор GCC из kNr элементов (64 байта), иначе автовекторизатор для
+// float выбирает узкие векторы вдоль столбца A и теряет в разы. long double
+// в векторы не помещается и считается обычным циклом.
+template <typename T>
+void MicroKernel(int kc, const T *a, const T *b, T *c, std::ptrdiff_t ldc,
+                 int rows, int cols, bool accumulate) {
+  T acc[kMr][kNr<T>] = {};
+  if constexpr (sizeof(T) <= 8) {
+    typedef T Row __attribute__((vector_size(kNr<T> * sizeof(T))));
+    Row rows_acc[kMr] = {};
+    for (int p = 0; p < kc; p++) {
+      Row b_row;
+      std::memcpy(&b_row, b, sizeof(Row));
+      for (int r = 0; r < kMr; r++) {
+        rows_acc[r] += a[r] * b_row;
+      }
+      a += kMr;
+      b += kNr<T>;
+    }
+    std::memcpy(acc, rows_acc, sizeof(acc));
+  } else {
+    for (int p = 0; p < kc; p++) {
+      for (int r = 0; r < kMr; r++) {
+        T a_value = a[r];
+        for (int q = 0; q < kNr<T>; q++) {
+          acc[r][q] += a_value * b[q];
+        }
+      }
+      a += kMr;
+      b += kNr<T>;
+    }
+  }
+  for (int r = 0; r < rows; r++) {
+    T *c_row = c + r * ldc;
+    if (accumulate) {
+      for (int q = 0; q < cols; q++) {
+        c_row[q] += acc[r][q];
+      }
+    } else {
+      for (int q = 0; q < cols; q++) {
+        c_row[q] = acc[r][q];
+      }
+    }
+  }
+}
+
+// Шаги операндов нужны только упаковке: после нее панели одинаковы для
+// любых шагов, поэтому микроядро и разбиение по потокам общие.
+template <typename T, bool Strided>
+void Gemm(int m, int n, int k, const T *a, std::ptrdiff_t lda,
+          std::ptrdiff_t a_col, const T *b, std::ptrdiff_t ldb,
+          std::ptrdiff_t b_col, T *c, int ldc) {
+  if (m <= 0 || n <= 0) {
+    return;
+  }
+  if (k <= 0) {
+    for (int i = 0; i < m; i++) {
+      std::fill_n(c + static_cast<std::size_t>(i) * ldc, n, T(0));
+    }
+    return;
+  }
+  int nc_max = std::min(kNc, (n + kNr<T> - 1) / kNr<T> * kNr<T>);
+  int mc_max = std::min(kMc, (m + kMr - 1) / kMr * kMr);
+  int kc_max = std::min(kKc, k);
+  S21BasicScratchBuffer<T> packed_b(static_cast<std::size_t>(kc_max) * nc_max);
+  int m_blocks = (m + kMc - 1) / kMc;
+
+  for (int jc = 0; jc < n; jc += kNc) {
+    int nc = std::min(kNc, n - jc);
+    for (int pc = 0; pc < k; pc += kKc) {
+      int kc = std::min(kKc, k - pc);
+      bool accumulate = pc > 0;
+      PackB<T, Strided>(kc, nc, b + pc * ldb + jc * b_col, ldb, b_col,
+                        packed_b.Get());
+      // упакованная панель B общая, блоки строк A делятся между потоками,
+      // каждый пакует свои блоки в собственный буфер
+      double work = 2.0 * m * nc * kc;
+      S21ParallelFor(0, m_blocks, work, [&](int first, int last) {
+        S21BasicScratchBuffer<T> packed_a(static_cast<std::size_t>(kc_max) *
+                                          mc_max);
+        for (int block = first; block < last; block++) {
+          int ic = block * kMc;
+          int mc = std::min(kMc, m - ic);
+          PackA<T, Strided>(mc, kc, a + ic * lda + pc * a_col, lda, a_col,
+                            packed_a.Get());
+          for (int jr = 0; jr < nc; jr += kNr<T>) {
+            for (int ir = 0; ir < mc; ir += kMr) {
+              MicroKernel(kc, packed_a.Get() + ir * kc,
+                          packed_b.Get() + jr * kc,
+                          c + static_cast<std::size_t>(ic + ir) * ldc + jc + jr,
+                          ldc, std::min(kMr, mc - ir),
+                          std::min(kNr<T>, nc - jr), accumulate);
+            }
+          }
+        }
+      });
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void S21Gemm(int m, int n, int k, const T *a, int lda, const T *b, int ldb,
+             T *c, int ldc) {
+  Gemm<T, false>(m, n, k, a, lda, 1, b, ldb, 1, c, ldc);
+}
+
+template <typename T>
+void S21GemmStrided(int m, int n, int k, const T *a, std::ptrdiff_t lda,
+                    std::ptrdiff_t a_col, const T *b, std::ptrdiff_t ldb,
+                    std::ptrdiff_t b_col, T *c, int ldc) {
+  Gemm<T, true>(m, n, k, a, lda, a_col, b, ldb, b_col, c, ldc);
+}
+
+#define S21_INSTANTIATE_GEMM(T)                                            \
+  template void S21Gemm<T>(int, int, int, const T *, int, const T *, int,   \
+                           T *, int);                                       \
+  template void S21GemmStrided<T>(int, int, int, const T *, std::ptrdiff_t, \
+                                  std::ptrdiff_t, const T *, std::ptrdiff_t, \
+                                  std::ptrdiff_t, T *, int);
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_GEMM)
+#undef S21_INSTANTIATE_GEMM
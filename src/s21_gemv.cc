@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+// Произведения с вектором упираются в чтение A (каждый элемент нужен один
+// раз), поэтому упаковка и блоки S21Gemm им только мешают: A читается
+// построчно один раз векторными ядрами dot и axpy, а строки делятся между
+// потоками.
+namespace {
+
+// строки A на одну частичную сумму в S21Gevm
+constexpr int kGevmRows = 256;
+// больше частичных сумм не нужно ни одному пулу, а память под них - n * 64
+constexpr int kMaxGevmParts = 64;
+
+}  // namespace
+
+template <typename T>
+void S21Gemv(int m, int n, const T *a, int lda, const T *x, T *y) {
+  const S21BasicElementwiseKernels<T> &kernels = S21ActiveKernels<T>();
+  S21ParallelFor(0, m, 2.0 * m * n, [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      y[i] = kernels.dot(n, a + static_cast<std::size_t>(i) * lda, x);
+    }
+  });
+}
+
+// y = сумма x_i * A_i по строкам. Полосы строк копят частичные суммы
+// отдельно, а складываются они всегда в одном порядке, так что результат
+// не зависит от числа потоков.
+template <typename T>
+void S21Gevm(int m, int n, const T *a, int lda, const T *x, T *y) {
+  const S21BasicElementwiseKernels<T> &kernels = S21ActiveKernels<T>();
+  double work = 2.0 * m * n;
+  int parts = std::min(kMaxGevmParts, (m + kGevmRows - 1) / kGevmRows);
+  if (parts <= 1 || work < S21GetExecutionPolicy().parallel_threshold) {
+    std::fill_n(y, n, T(0));
+    for (int i = 0; i < m; i++) {
+      kernels.axpy(n, y, a + static_cast<std::size_t>(i) * lda, x[i]);
+    }
+    return;
+  }
+  S21BasicScratchBuffer<T> partial(static_cast<std::size_t>(parts) * n);
+  S21ParallelFor(0, parts, work, [&](int first, int last) {
+    for (int part = first; part < last; part++) {
+      T *sum = partial.Get() + static_cast<std::size_t>(part) * n;
+      std::fill_n(sum, n, T(0));
+      int end = static_cast<int>(static_cast<long>(m) * (part + 1) / parts);
+      for (int i = static_cast<int>(static_cast<long>(m) * part / parts);
+           i < end; i++) {
+        kernels.axpy(n, sum, a + static_cast<std::size_t>(i) * lda, x[i]);
+      }
+    }
+  });
+  S21ParallelFor(0, n, 1.0 * parts * n, [&](int first, int last) {
+    std::copy(partial.Get() + first, partial.Get() + last, y + first);
+    for (int part = 1; part < parts; part++) {
+      kernels.add(last - first, y + first,
+                  partial.Get() + static_cast<std::size_t>(part) * n + first);
+    }
+  });
+}
+
+template <typename T>
+void S21Ger(int m, int n, const T *x, const T *y, T *a, int lda) {
+  const S21BasicElementwiseKernels<T> &kernels = S21ActiveKernels<T>();
+  S21ParallelFor(0, m, 1.0 * m * n, [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      T *row = a + static_cast<std::size_t>(i) * lda;
+      std::fill_n(row, n, T(0));
+      kernels.axpy(n, row, y, x[i]);
+    }
+  });
+}
+
+#define S21_INSTANTIATE_GEMV(T)                                       \
+  template void S21Gemv<T>(int, int, const T *, int, const T *, T *); \
+  template void S21Gevm<T>(int, int, const T *, int, const T *, T *); \
+  template void S21Ger<T>(int, int, const T *, const T *, T *, int);
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_GEMV)
+#undef S21_INSTANTIATE_GEMV
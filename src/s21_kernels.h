@@ -0,0 +1,110 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_KERNELS_H_
+#define CPP1_S21_MATRIXPLUS_S21_KERNELS_H_
+
+// Внутренние вычислительные ядра библиотеки. Работают с сырыми буферами в
+// формате S21Matrix (по строкам, ld* - ведущая размерность), в публичный
+// интерфейс не входят.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "s21_allocator.h"
+#include "s21_matrix_oop.h"
+
+// Временный выровненный буфер из текущего распределителя потока: при
+// повторных вызовах блоки берутся из кэша пула или из арены вызывающего.
+template <typename T>
+class S21BasicScratchBuffer {
+ public:
+  explicit S21BasicScratchBuffer(std::size_t count)
+      : allocator_(S21CurrentAllocator()),
+        bytes_(count * sizeof(T)),
+        data_(static_cast<T *>(allocator_.Allocate(bytes_))) {}
+  ~S21BasicScratchBuffer() { allocator_.Deallocate(data_, bytes_); }
+  S21BasicScratchBuffer(const S21BasicScratchBuffer &) = delete;
+  S21BasicScratchBuffer &operator=(const S21BasicScratchBuffer &) = delete;
+  T *Get() { return data_; }
+
+ private:
+  S21Allocator &allocator_;
+  std::size_t bytes_;
+  T *data_;
+};
+
+using S21ScratchBuffer = S21BasicScratchBuffer<double>;
+
+// C = A * B, где A - m x k, B - k x n, C - m x n (C перезаписывается).
+// Ядра умножения инстанцированы для типов из S21_FOR_EACH_SCALAR.
+template <typename T>
+void S21Gemm(int m, int n, int k, const T *a, int lda, const T *b, int ldb,
+             T *c, int ldc);
+// то же для операндов с произвольными шагами между строками (lda, ldb) и
+// столбцами (a_col, b_col), например транспонированных видов: элементы
+// читаются прямо при упаковке панелей, без промежуточной копии
+template <typename T>
+void S21GemmStrided(int m, int n, int k, const T *a, std::ptrdiff_t lda,
+                    std::ptrdiff_t a_col, const T *b, std::ptrdiff_t ldb,
+                    std::ptrdiff_t b_col, T *c, int ldc);
+// то же по Штрассену-Винограду; рекурсия останавливается, когда меньшая из
+// размерностей блока становится меньше 2 * crossover
+template <typename T>
+void S21StrassenGemm(int m, int n, int k, const T *a, int lda, const T *b,
+                     int ldb, T *c, int ldc, int crossover);
+// y (m) = A (m x n) * x (n) и y (n) = x (m)^T * A (m x n) для векторов,
+// лежащих подряд; y перезаписывается
+template <typename T>
+void S21Gemv(int m, int n, const T *a, int lda, const T *x, T *y);
+template <typename T>
+void S21Gevm(int m, int n, const T *a, int lda, const T *x, T *y);
+// A (m x n) = x (m) * y (n)^T
+template <typename T>
+void S21Ger(int m, int n, const T *x, const T *y, T *a, int lda);
+
+// Таблица поэлементных ядер одного набора инструкций для элементов типа
+// T. Все функции работают над n подряд идущими элементами.
+template <typename T>
+struct S21BasicElementwiseKernels {
+  S21Isa isa;
+  void (*add)(std::size_t n, T *a, const T *b);  // a += b
+  void (*sub)(std::size_t n, T *a, const T *b);  // a -= b
+  void (*scale)(std::size_t n, T *a, T num);     // a *= num
+  // true, если |a[k] - b[k]| <= tolerance для всех k
+  bool (*equal)(std::size_t n, const T *a, const T *b, T tolerance);
+  // dst (cols x rows) = src (rows x cols)^T для небольшого блока
+  void (*transpose)(int rows, int cols, const T *src, std::ptrdiff_t lds,
+                    T *dst, std::ptrdiff_t ldd);
+  // сумма a[k] * b[k]; векторные версии складывают в другом порядке
+  T (*dot)(std::size_t n, const T *a, const T *b);
+  void (*axpy)(std::size_t n, T *a, const T *b, T num);  // a += num * b
+};
+
+using S21ElementwiseKernels = S21BasicElementwiseKernels<double>;
+
+// ядра, выбранные для текущего процессора при первом обращении
+template <typename T = double>
+const S21BasicElementwiseKernels<T> &S21ActiveKernels();
+// Ядра конкретного набора или nullptr, если процессор его не поддерживает.
+// У long double векторных ядер нет, для него есть только kScalar.
+template <typename T = double>
+const S21BasicElementwiseKernels<T> *S21KernelsFor(S21Isa isa);
+
+// Ядра пакетных операций S21MatrixBatch. Обрабатывают матрицы с номерами
+// [first, last) (границы кратны S21MatrixBatch::kLanes); элемент (i, j)
+// матрицы b лежит по адресу a[(i * cols + j) * stride + b].
+struct S21BatchKernels {
+  S21Isa isa;
+  // det[b] = det(A_b) для квадратных n x n, 0 для вырожденных
+  void (*determinant)(int n, const double *a, int stride, int first,
+                      int last, double *det);
+  // inverse_b = A_b^-1; для вырожденных singular[b] = 1 и NaN в inverse_b
+  void (*inverse)(int n, const double *a, int stride, int first, int last,
+                  double *inverse, std::uint8_t *singular);
+  // C_b = A_b * B_b, где A_b - m x k, B_b - k x n
+  void (*multiply)(int m, int k, int n, const double *a, const double *b,
+                   int stride, int first, int last, double *c);
+};
+
+const S21BatchKernels *S21BatchKernelsFor(S21Isa isa);
+const S21BatchKernels &S21ActiveBatchKernels();
+
+#endif
@@ -0,0 +1,193 @@
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// с какой ширины полосы столбцов Solve обновляет строки rhs целиком
+constexpr int kSolveWideSlice = 8;
+
+}  // namespace
+
+// Разложение выполняется на месте в копии исходной матрицы за O(n^3),
+// других буферов не требуется. Исключение идет до конца при любом
+// ненулевом ведущем элементе, пропускается только шаг с нулевым столбцом
+// (как в LAPACK dgetrf). Для Solve и обращения матрица считается
+// вырожденной, если какой-то ведущий элемент не превосходит n *
+// epsilon(T) * max|a_ij|, то есть неотличим от ошибки округления
+// (абсолютный epsilon не используется).
+template <typename T>
+S21BasicLU<T>::S21BasicLU(const S21BasicMatrix<T> &matrix)
+    : factors_(matrix), pivots_(), sign_(1), singular_(false) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (std::is_integral<T>::value) {
+    throw std::logic_error("LU is not defined for integer matrices");
+  }
+  int n = factors_.GetRows();
+  std::ptrdiff_t stride = factors_.Stride();
+  T *a = factors_.Data();
+  pivots_.resize(n);
+  T threshold = SingularThreshold(factors_);
+
+  for (int k = 0; k < n; k++) {
+    S21Checkpoint(S21EliminationProgress(k, n));
+    // ищем максимальный по модулю элемент в столбце k
+    int pivot = k;
+    T max_abs = std::abs(a[k * stride + k]);
+    for (int i = k + 1; i < n; i++) {
+      T value = std::abs(a[i * stride + k]);
+      if (value > max_abs) {
+        max_abs = value;
+        pivot = i;
+      }
+    }
+    pivots_[k] = pivot;
+    if (max_abs <= threshold) {
+      singular_ = true;
+    }
+    if (max_abs == T(0)) {
+      continue;
+    }
+    if (pivot != k) {
+      std::swap_ranges(a + k * stride, a + k * stride + n,
+                       a + pivot * stride);
+      sign_ = -sign_;
+    }
+
+    // обновление оставшейся части строк делится между потоками
+    T *row_k = a + k * stride;
+    double work = static_cast<double>(n - k) * (n - k);
+    S21ParallelFor(k + 1, n, work, [&](int first, int last) {
+      for (int i = first; i < last; i++) {
+        T *row_i = a + i * stride;
+        T l = row_i[k] / row_k[k];
+        row_i[k] = l;
+        for (int j = k + 1; j < n; j++) {
+          row_i[j] -= l * row_k[j];
+        }
+      }
+    });
+  }
+}
+
+template <typename T>
+T S21BasicLU<T>::SingularThreshold(const S21BasicMatrix<T> &matrix) {
+  const T *a = matrix.Data();
+  std::size_t count =
+      static_cast<std::size_t>(matrix.GetRows()) * matrix.GetCols();
+  T max_abs = 0;
+  for (std::size_t k = 0; k < count; k++) {
+    max_abs = std::max(max_abs, std::abs(a[k]));
+  }
+  return matrix.GetRows() * std::numeric_limits<T>::epsilon() * max_abs;
+}
+
+template <typename T>
+bool S21BasicLU<T>::IsSingular() const { return singular_; }
+
+// Определитель равен произведению диагонали U с учетом знака перестановки.
+// Порог вырожденности здесь не применяется: у плохо масштабированной
+// матрицы малый ведущий элемент - не ошибка округления, и определитель
+// равен нулю только при точно нулевом элементе.
+template <typename T>
+T S21BasicLU<T>::Determinant() const {
+  int n = factors_.GetRows();
+  std::ptrdiff_t stride = factors_.Stride();
+  const T *a = factors_.Data();
+  T result = sign_;
+  for (int k = 0; k < n; k++) {
+    result *= a[k * stride + k];
+  }
+  return result;
+}
+
+template <typename T>
+const S21BasicMatrix<T> &S21BasicLU<T>::Factors() const { return factors_; }
+
+template <typename T>
+const std::vector<int> &S21BasicLU<T>::Pivots() const { return pivots_; }
+
+// Перестановка строк rhs по pivots_, затем прямой ход по L с единичной
+// диагональю и обратный по U. Столбцы rhs независимы, поэтому делятся
+// между потоками. Узкая полоса столбцов решается по одному столбцу
+// скалярными произведениями по строкам L и U, широкая - обновлением строк
+// rhs целиком, так что внутренний цикл в обоих случаях идет по памяти
+// подряд.
+template <typename T>
+S21BasicMatrix<T> S21BasicLU<T>::Solve(const S21BasicMatrix<T> &rhs) const {
+  int n = factors_.GetRows();
+  if (rhs.GetRows() != n) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  if (singular_ || n == 0) {
+    throw std::logic_error("Мatrix is not invertible.");
+  }
+  S21BasicMatrix<T> result = rhs;
+  int cols = result.GetCols();
+  std::ptrdiff_t stride = result.Stride();
+  std::ptrdiff_t lu_stride = factors_.Stride();
+  const T *a = factors_.Data();
+  T *x = result.Data();
+  for (int k = 0; k < n; k++) {
+    if (pivots_[k] != k) {
+      std::swap_ranges(x + k * stride, x + k * stride + cols,
+                       x + pivots_[k] * stride);
+    }
+  }
+
+  double work = static_cast<double>(n) * n * cols;
+  S21ParallelFor(0, cols, work, [&](int first, int last) {
+    if (last - first < kSolveWideSlice) {
+      std::vector<T> column(n);
+      for (int j = first; j < last; j++) {
+        for (int i = 0; i < n; i++) {
+          T sum = x[i * stride + j];
+          const T *row = a + i * lu_stride;
+          for (int k = 0; k < i; k++) {
+            sum -= row[k] * column[k];
+          }
+          column[i] = sum;
+        }
+        for (int i = n - 1; i >= 0; i--) {
+          T sum = column[i];
+          const T *row = a + i * lu_stride;
+          for (int k = i + 1; k < n; k++) {
+            sum -= row[k] * column[k];
+          }
+          column[i] = sum / row[i];
+          x[i * stride + j] = column[i];
+        }
+      }
+      return;
+    }
+    for (int i = 1; i < n; i++) {
+      T *row_i = x + i * stride;
+      for (int k = 0; k < i; k++) {
+        T l = a[i * lu_stride + k];
+        const T *row_k = x + k * stride;
+        for (int j = first; j < last; j++) {
+          row_i[j] -= l * row_k[j];
+        }
+      }
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      T *row_i = x + i * stride;
+      for (int k = i + 1; k < n; k++) {
+        T u = a[i * lu_stride + k];
+        const T *row_k = x + k * stride;
+        for (int j = first; j < last; j++) {
+          row_i[j] -= u * row_k[j];
+        }
+      }
+      T diagonal = a[i * lu_stride + i];
+      for (int j = first; j < last; j++) {
+        row_i[j] /= diagonal;
+      }
+    }
+  });
+  return result;
+}
+
+#define S21_INSTANTIATE_LU(T) template class S21BasicLU<T>;
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_LU)
+#undef S21_INSTANTIATE_LU
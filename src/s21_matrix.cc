@@ -1,197 +1,519 @@
 #include "s21_matrix_oop.h"
 
+#include <atomic>
+
+#include "s21_kernels.h"
+
+namespace {
+
+// размер порции поэлементных операций при делении между потоками
+constexpr int kElementBlock = 4096;
+// сторона блока при транспонировании
+constexpr int kTransposeTile = 32;
+// столбцы результата между точками отмены в MulMatrixAsync; каждая
+// полоса заново упаковывает A, поэтому узкие полосы заметно медленнее
+constexpr int kAsyncCols = 1024;
+
+// Определитель целой матрицы n x n без деления с остатком (алгоритм
+// Барейса): все промежуточные значения - миноры исходной матрицы, поэтому
+// результат точен, пока они помещаются в T.
+template <typename T>
+T BareissDeterminant(int n, const T *data, std::ptrdiff_t stride) {
+  std::vector<T> a(static_cast<std::size_t>(n) * n);
+  auto row = [&](int i) { return a.data() + static_cast<std::size_t>(i) * n; };
+  for (int i = 0; i < n; i++) {
+    std::copy_n(data + i * stride, n, row(i));
+  }
+  T sign = 1;
+  T previous = 1;
+  for (int k = 0; k < n - 1; k++) {
+    S21Checkpoint(S21EliminationProgress(k, n));
+    T *row_k = row(k);
+    if (row_k[k] == 0) {
+      int pivot = k + 1;
+      while (pivot < n && row(pivot)[k] == 0) {
+        pivot++;
+      }
+      if (pivot == n) {
+        return 0;
+      }
+      std::swap_ranges(row_k, row_k + n, row(pivot));
+      sign = -sign;
+    }
+    for (int i = k + 1; i < n; i++) {
+      T *row_i = row(i);
+      for (int j = k + 1; j < n; j++) {
+        row_i[j] = (row_i[j] * row_k[k] - row_i[k] * row_k[j]) / previous;
+      }
+    }
+    previous = row_k[k];
+  }
+  return sign * row(n - 1)[n - 1];
+}
+
+// предел числа шагов SolveMixed (ITERMAX в LAPACK)
+constexpr int kMaxRefinements = 30;
+
+template <typename T>
+double MaxAbs(const S21BasicMatrix<T> &matrix) {
+  const T *data = matrix.Data();
+  std::size_t count =
+      static_cast<std::size_t>(matrix.GetRows()) * matrix.GetCols();
+  double result = 0.0;
+  for (std::size_t k = 0; k < count; k++) {
+    result = std::max(result, static_cast<double>(std::abs(data[k])));
+  }
+  return result;
+}
+
+// ||A||_inf - наибольшая сумма модулей по строке
+template <typename T>
+double RowSumNorm(const S21BasicMatrix<T> &matrix) {
+  double result = 0.0;
+  for (int i = 0; i < matrix.GetRows(); i++) {
+    const T *row =
+        matrix.Data() + static_cast<std::size_t>(i) * matrix.Stride();
+    double sum = 0.0;
+    for (int j = 0; j < matrix.GetCols(); j++) {
+      sum += static_cast<double>(std::abs(row[j]));
+    }
+    result = std::max(result, sum);
+  }
+  return result;
+}
+
+// заполняет residual_norm и backward_error отчета по невязке R = B - A * X
+template <typename T>
+void MeasureResidual(const S21BasicMatrix<T> &residual,
+                     const S21BasicMatrix<T> &x, double a_norm,
+                     S21RefinementReport *report) {
+  int cols = x.GetCols();
+  std::vector<double> r_max(cols, 0.0), x_max(cols, 0.0);
+  for (int i = 0; i < x.GetRows(); i++) {
+    const T *r_row = residual.Data() + i * residual.Stride();
+    const T *x_row = x.Data() + i * x.Stride();
+    for (int j = 0; j < cols; j++) {
+      r_max[j] = std::max(r_max[j], static_cast<double>(std::abs(r_row[j])));
+      x_max[j] = std::max(x_max[j], static_cast<double>(std::abs(x_row[j])));
+    }
+  }
+  report->residual_norm = 0.0;
+  report->backward_error = 0.0;
+  for (int j = 0; j < cols; j++) {
+    double scale = a_norm * x_max[j];
+    double error = r_max[j] == 0.0 ? 0.0
+                   : scale > 0.0   ? r_max[j] / scale
+                                   : std::numeric_limits<double>::infinity();
+    report->residual_norm = std::max(report->residual_norm, r_max[j]);
+    report->backward_error = std::max(report->backward_error, error);
+  }
+}
+
+// Произведения, в которых множитель или результат - вектор (m, n или k
+// равно 1), идут мимо S21Gemm: упаковка операндов для них дороже самого
+// умножения. Столбец вида может лежать с шагом и тогда собирается подряд.
+template <typename T>
+void MultiplyVectorShape(int m, int n, int k, const T *a, int lda, const T *b,
+                         int ldb, T *c) {
+  if (m == 1) {
+    S21Gevm(k, n, b, ldb, a, c);
+    return;
+  }
+  // вектор - столбец b (n == 1) или столбец a (k == 1)
+  auto multiply = [&](const T *column) {
+    if (n == 1) {
+      S21Gemv(m, k, a, lda, column, c);
+    } else {
+      S21Ger(m, n, column, b, c, n);
+    }
+  };
+  const T *column = n == 1 ? b : a;
+  int step = n == 1 ? ldb : lda;
+  int length = n == 1 ? k : m;
+  if (step == 1 || length < 2) {
+    multiply(column);
+    return;
+  }
+  S21BasicScratchBuffer<T> packed(length);
+  for (int p = 0; p < length; p++) {
+    packed.Get()[p] = column[static_cast<std::size_t>(p) * step];
+  }
+  multiply(packed.Get());
+}
+
+}  // namespace
+
 // базовый конструктор
-S21Matrix::S21Matrix() : rows_(0), cols_(0) { matrix_ = nullptr; }
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix()
+    : rows_(0),
+      cols_(0),
+      data_(nullptr),
+      capacity_(0),
+      allocator_(nullptr),
+      storage_(S21Storage::kOwned),
+      rows_view_(nullptr) {}
 
 // параметризированный конструктор
-S21Matrix::S21Matrix(int inrows, int incols) : rows_(inrows), cols_(incols) {
-  matrix_ = nullptr;
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int inrows, int incols)
+    : rows_(inrows),
+      cols_(incols),
+      data_(nullptr),
+      capacity_(0),
+      allocator_(nullptr),
+      storage_(S21Storage::kOwned),
+      rows_view_(nullptr) {
   AllocateMemory(rows_, cols_);
+  std::fill_n(data_, static_cast<std::size_t>(rows_) * cols_, T(0));
 }
 
-// конструктор копирования
-S21Matrix::S21Matrix(const S21Matrix &other)
-    : rows_(other.rows_), cols_(other.cols_) {
-  matrix_ = nullptr;
+// конструктор копирования: одно выделение памяти и одно копирование буфера
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix &other)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      data_(nullptr),
+      capacity_(0),
+      allocator_(nullptr),
+      storage_(S21Storage::kOwned),
+      rows_view_(nullptr) {
   AllocateMemory(other.rows_, other.cols_);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
-  }
+  std::copy_n(other.data_, static_cast<std::size_t>(rows_) * cols_, data_);
+  // после AllocateMemory, которое сбрасывает разложения
+  lu_ = std::atomic_load(&other.lu_);
+  reduced_lu_ = std::atomic_load(&other.reduced_lu_);
+  cholesky_ = std::atomic_load(&other.cholesky_);
+  cholesky_failed_ = other.cholesky_failed_.load();
 }
 
 // конструктор перемещения
-S21Matrix::S21Matrix(S21Matrix &&other) : rows_(0), cols_(0), matrix_(nullptr) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix &&other)
+    : rows_(0),
+      cols_(0),
+      data_(nullptr),
+      capacity_(0),
+      allocator_(nullptr),
+      storage_(S21Storage::kOwned),
+      rows_view_(nullptr) {
   std::swap(rows_, other.rows_);
   std::swap(cols_, other.cols_);
-  std::swap(matrix_, other.matrix_);
+  std::swap(data_, other.data_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(allocator_, other.allocator_);
+  std::swap(storage_, other.storage_);
+  std::swap(rows_view_, other.rows_view_);
+  std::swap(lu_, other.lu_);
+  std::swap(reduced_lu_, other.reduced_lu_);
+  std::swap(cholesky_, other.cholesky_);
+  cholesky_failed_ = other.cholesky_failed_.exchange(false);
 }
 
 // деструктор
-S21Matrix::~S21Matrix() { DeallocateMemory(); }
+template <typename T>
+S21BasicMatrix<T>::~S21BasicMatrix() { DeallocateMemory(); }
 
 // операторы
-S21Matrix S21Matrix::operator+(const S21Matrix &other) const {
-  S21Matrix result = *this;
-  result.SumMatrix(other);
-  return result;
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(
+    const S21BasicMatrix &other) const {
+  return Multiply(other);
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix &other) const {
-  S21Matrix result = *this;
-  result.SubMatrix(other);
-  return result;
+// Операторы для временных операндов: результат пишется в буфер
+// временной матрицы, которая все равно была бы уничтожена, и она же
+// возвращается, так что новых выделений памяти нет.
+template <typename T>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T> &&lhs,
+                            const S21BasicMatrix<T> &rhs) {
+  lhs.SumMatrix(rhs);
+  return std::move(lhs);
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix &other) const {
-  S21Matrix result = *this;
-  result.MulMatrix(other);
-  return result;
+template <typename T>
+S21BasicMatrix<T> operator+(const S21BasicMatrix<T> &lhs,
+                            S21BasicMatrix<T> &&rhs) {
+  rhs.SumMatrix(lhs);
+  return std::move(rhs);
 }
 
-S21Matrix S21Matrix::operator*(const double num) const {
-  S21Matrix result = *this;
-  result.MulNumber(num);
-  return result;
+template <typename T>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T> &&lhs, S21BasicMatrix<T> &&rhs) {
+  lhs.SumMatrix(rhs);
+  return std::move(lhs);
 }
 
-S21Matrix &S21Matrix::operator=(S21Matrix &&other) noexcept {
-  if (matrix_ != nullptr) {
-    DeallocateMemory();
-  }
+template <typename T>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T> &&lhs,
+                            const S21BasicMatrix<T> &rhs) {
+  lhs.SubMatrix(rhs);
+  return std::move(lhs);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator-(const S21BasicMatrix<T> &lhs,
+                            S21BasicMatrix<T> &&rhs) {
+  rhs = lhs - rhs;
+  return std::move(rhs);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T> &&lhs, S21BasicMatrix<T> &&rhs) {
+  lhs.SubMatrix(rhs);
+  return std::move(lhs);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator*(S21BasicMatrix<T> &&lhs,
+                            S21OperandScalar<S21BasicMatrix<T>> num) {
+  lhs.MulNumber(num);
+  return std::move(lhs);
+}
+
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(
+    S21BasicMatrix &&other) noexcept {
   if (this != &other) {
+    DeallocateMemory();
     rows_ = other.rows_;
     cols_ = other.cols_;
-    matrix_ = other.matrix_;
+    data_ = other.data_;
+    capacity_ = other.capacity_;
+    allocator_ = other.allocator_;
+    storage_ = other.storage_;
+    rows_view_ = other.rows_view_;
+    lu_ = std::move(other.lu_);
+    reduced_lu_ = std::move(other.reduced_lu_);
+    cholesky_ = std::move(other.cholesky_);
+    cholesky_failed_ = other.cholesky_failed_.exchange(false);
 
     other.rows_ = 0;
     other.cols_ = 0;
-    other.matrix_ = nullptr;
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+    other.allocator_ = nullptr;
+    other.storage_ = S21Storage::kOwned;
+    other.rows_view_ = nullptr;
   }
   return *this;
 }
 
-S21Matrix &S21Matrix::operator=(const S21Matrix &other) {
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(const S21BasicMatrix &other) {
   if (this == &other) {
     return *this;
   }
 
-  DeallocateMemory();
-  rows_ = other.rows_;
-  cols_ = other.cols_;
-  AllocateMemory(rows_, cols_);
-
-  for (int i = 0; i < other.rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
+  // при совпадении размеров буфер переиспользуется без перевыделения,
+  // кроме отображенного только для чтения файла
+  if (data_ == nullptr || rows_ != other.rows_ || cols_ != other.cols_ ||
+      storage_ == S21Storage::kMappedReadOnly) {
+    DeallocateMemory();
+    AllocateMemory(other.rows_, other.cols_);
   }
+  std::copy_n(other.data_, static_cast<std::size_t>(rows_) * cols_, data_);
+  lu_ = std::atomic_load(&other.lu_);
+  reduced_lu_ = std::atomic_load(&other.reduced_lu_);
+  cholesky_ = std::atomic_load(&other.cholesky_);
+  cholesky_failed_ = other.cholesky_failed_.load();
 
   return *this;
 }
 
-S21Matrix &S21Matrix::operator+=(const S21Matrix &other) {
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator+=(const S21BasicMatrix &other) {
   SumMatrix(other);
   return *this;
 }
 
-S21Matrix &S21Matrix::operator-=(const S21Matrix &other) {
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator-=(const S21BasicMatrix &other) {
   SubMatrix(other);
   return *this;
 }
 
-S21Matrix &S21Matrix::operator*=(const S21Matrix &other) {
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator*=(const S21BasicMatrix &other) {
   MulMatrix(other);
   return *this;
 }
 
-S21Matrix &S21Matrix::operator*=(double num) {
+template <typename T>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator*=(T num) {
   MulNumber(num);
   return *this;
 }
 
-bool S21Matrix::operator==(const S21Matrix &other) const {
+template <typename T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix &other) const {
   return EqMatrix(other);
 }
 
-double S21Matrix::operator()(int row, int col) const {
+template <typename T>
+T S21BasicMatrix<T>::operator()(int row, int col) const {
   if (row < 0 || col < 0 || col >= cols_ || row >= rows_) {
     throw std::out_of_range("Invalid rows or/and columns!");
   }
-  return matrix_[row][col];
+  return data_[row * Stride() + col];
 }
 
-double &S21Matrix::operator()(int row, int col) {
+template <typename T>
+T &S21BasicMatrix<T>::operator()(int row, int col) {
   if (row < 0 || col < 0 || col >= cols_ || row >= rows_) {
     throw std::out_of_range("Invalid rows or/and columns!");
   }
-  return matrix_[row][col];
+  MakeWritable();
+  return data_[row * Stride() + col];
+}
+
+template <typename T>
+int S21BasicMatrix<T>::GetCols() const { return cols_; }
+
+template <typename T>
+int S21BasicMatrix<T>::GetRows() const { return rows_; }
+
+// таблица указателей на строки для совместимости со старым интерфейсом,
+// строки указывают внутрь единого буфера data_
+template <typename T>
+T **S21BasicMatrix<T>::GetMatrix() const {
+  if (data_ == nullptr) {
+    return nullptr;
+  }
+  // через таблицу элементы можно изменить
+  DropCache();
+  if (rows_view_ == nullptr) {
+    rows_view_ = new T *[rows_];
+    for (int i = 0; i < rows_; i++) {
+      rows_view_[i] = data_ + static_cast<std::size_t>(i) * Stride();
+    }
+  }
+  return rows_view_;
+}
+
+template <typename T>
+T *S21BasicMatrix<T>::Data() {
+  MakeWritable();
+  return data_;
 }
 
-int S21Matrix::GetCols() const { return cols_; }
+template <typename T>
+const T *S21BasicMatrix<T>::Data() const { return data_; }
 
-int S21Matrix::GetRows() const { return rows_; }
+// набор инструкций, выбранный для поэлементных операций по CPUID
+template <typename T>
+S21Isa S21BasicMatrix<T>::ActiveIsa() { return S21ActiveKernels<T>().isa; }
 
-double **S21Matrix::GetMatrix() const { return matrix_; }
+// ведущая размерность: расстояние в элементах между началами строк
+template <typename T>
+std::ptrdiff_t S21BasicMatrix<T>::Stride() const { return cols_; }
 
-void S21Matrix::AllocateMemory(int rows, int cols) {
+template <typename T>
+void S21BasicMatrix<T>::AllocateMemory(int rows, int cols) {
   rows_ = rows;
   cols_ = cols;
-  if (matrix_ == nullptr &&
+  if (data_ == nullptr &&
       (((rows_ == 0) && (cols_ > 0)) || ((rows_ > 0) && (cols_ == 0)))) {
     AllocateMatrix();
-  } else if ((rows_ < 1 || cols_ < 1) && !matrix_) {
+  } else if ((rows_ < 1 || cols_ < 1) && !data_) {
     throw std::invalid_argument("Invalid rows or/and columns!_2");
   } else {
     AllocateMatrix();
   }
 }
 
-void S21Matrix::AllocateMatrix() {
+// одно выделение выровненного буфера под все элементы из текущего
+// распределителя (пул потока или арена), содержимое не инициализируется
+template <typename T>
+void S21BasicMatrix<T>::AllocateMatrix() {
   FreeMemory();
-  matrix_ = new double *[rows_];
-  if (matrix_ == nullptr) {
-    throw std::bad_alloc();
-  }
-  for (int i = 0; i < rows_; i++) {
-    matrix_[i] = new double[cols_]();
-    if (matrix_[i] == nullptr) {
-      throw std::bad_alloc();
-    }
-  }
+  std::size_t count = static_cast<std::size_t>(rows_) * Stride();
+  S21Allocator &allocator = S21CurrentAllocator();
+  data_ = static_cast<T *>(allocator.Allocate(count * sizeof(T)));
+  capacity_ = count;
+  allocator_ = &allocator;
+  storage_ = S21Storage::kOwned;
 }
 
-void S21Matrix::DeallocateMemory() {
+template <typename T>
+void S21BasicMatrix<T>::DeallocateMemory() {
   FreeMemory();
   rows_ = 0;
   cols_ = 0;
 }
 
-void S21Matrix::FreeMemory() {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; i++) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
-    matrix_ = nullptr;
+template <typename T>
+void S21BasicMatrix<T>::FreeMemory() {
+  delete[] rows_view_;
+  rows_view_ = nullptr;
+  lu_.reset();
+  reduced_lu_.reset();
+  cholesky_.reset();
+  cholesky_failed_ = false;
+  if (data_ != nullptr) {
+    allocator_->Deallocate(data_, capacity_ * sizeof(T));
+    data_ = nullptr;
+    capacity_ = 0;
+    allocator_ = nullptr;
+    storage_ = S21Storage::kOwned;
+  }
+}
+
+// перевыделение под новые размеры с сохранением общего левого верхнего блока,
+// новые элементы заполняются нулями
+template <typename T>
+void S21BasicMatrix<T>::Resize(int new_rows, int new_cols) {
+  S21BasicMatrix tmp;
+  tmp.rows_ = new_rows;
+  tmp.cols_ = new_cols;
+  tmp.AllocateMatrix();
+  std::fill_n(tmp.data_, static_cast<std::size_t>(new_rows) * new_cols, T(0));
+  int copy_rows = std::min(rows_, new_rows);
+  int copy_cols = std::min(cols_, new_cols);
+  for (int i = 0; i < copy_rows; i++) {
+    std::copy_n(data_ + static_cast<std::size_t>(i) * Stride(), copy_cols,
+                tmp.data_ + static_cast<std::size_t>(i) * tmp.Stride());
   }
+  *this = std::move(tmp);
+}
+
+// вызывает body(first, count) для частей диапазона [0, count) по текущей
+// политике выполнения
+template <typename T>
+void S21BasicMatrix<T>::ForEachBlock(
+    std::size_t count,
+    const std::function<void(std::size_t, std::size_t)> &body) {
+  int blocks = static_cast<int>((count + kElementBlock - 1) / kElementBlock);
+  S21ParallelFor(0, blocks, static_cast<double>(count),
+                 [count, &body](int first, int last) {
+                   std::size_t from =
+                       static_cast<std::size_t>(first) * kElementBlock;
+                   std::size_t to = std::min(
+                       count, static_cast<std::size_t>(last) * kElementBlock);
+                   body(from, to - from);
+                 });
 }
 
 //функция для сравнения двух матриц
-bool S21Matrix::EqMatrix(const S21Matrix &other) const {
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix &other) const {
   bool res = true;
-  if (&other == this || other.matrix_ == nullptr || matrix_ == nullptr) {
+  if (&other == this || other.data_ == nullptr || data_ == nullptr) {
     throw std::invalid_argument("Matrix is not exist");
   }
   if (rows_ == other.rows_ && cols_ == other.cols_) {
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        if (fabs(other.matrix_[i][j] - matrix_[i][j]) > epsilon) {
-          res = false;
-        }
-      }
-    }
+    S21_PROFILE(S21Operation::kEqual, rows_, cols_, 1.0 * rows_ * cols_,
+                2.0 * sizeof(T) * rows_ * cols_);
+    std::atomic<bool> equal(true);
+    ForEachBlock(static_cast<std::size_t>(rows_) * cols_,
+                 [&](std::size_t from, std::size_t count) {
+                   if (equal && !S21ActiveKernels<T>().equal(
+                                    count, data_ + from, other.data_ + from,
+                                    S21MatrixTraits<T>::kTolerance)) {
+                     equal = false;
+                   }
+                 });
+    res = equal;
   } else {
     res = false;
   }
@@ -200,73 +522,306 @@ bool S21Matrix::EqMatrix(const S21Matrix &other) const {
 
 //Функция для добавления матрицы к текущей (исключительные ситуации разные
 //размеры матрицы)
-void S21Matrix::SumMatrix(const S21Matrix &other) {
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(const S21BasicMatrix &other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
     throw std::invalid_argument("Different matrix size");
   }
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = matrix_[i][j] + other.matrix_[i][j];
-    }
-  }
+  S21_PROFILE(S21Operation::kSum, rows_, cols_, 1.0 * rows_ * cols_,
+              3.0 * sizeof(T) * rows_ * cols_);
+  MakeWritable();
+  ForEachBlock(static_cast<std::size_t>(rows_) * cols_,
+               [&](std::size_t from, std::size_t count) {
+                 S21ActiveKernels<T>().add(count, data_ + from,
+                                        other.data_ + from);
+               });
 }
 
 //Функция для вычитания матрицы из текущий(исключительные систуации - разные
 //размеры матрицы)
-void S21Matrix::SubMatrix(const S21Matrix &other) {
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(const S21BasicMatrix &other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
     throw std::invalid_argument("Different matrix size");
   }
-  if (matrix_ == nullptr || other.matrix_ == nullptr) {
+  if (data_ == nullptr || other.data_ == nullptr) {
     throw std::runtime_error("Matrix_ is nullptr");
   }
-
-  for (int i = 0; i < rows_; i++)
-    for (int j = 0; j < cols_; j++)
-      matrix_[i][j] = matrix_[i][j] - other.matrix_[i][j];
+  S21_PROFILE(S21Operation::kSub, rows_, cols_, 1.0 * rows_ * cols_,
+              3.0 * sizeof(T) * rows_ * cols_);
+  MakeWritable();
+  ForEachBlock(static_cast<std::size_t>(rows_) * cols_,
+               [&](std::size_t from, std::size_t count) {
+                 S21ActiveKernels<T>().sub(count, data_ + from,
+                                        other.data_ + from);
+               });
 }
 
 //Функция умножения текущей матрицы на число
-void S21Matrix::MulNumber(const double num) {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = matrix_[i][j] * num;
-    }
-  }
+template <typename T>
+void S21BasicMatrix<T>::MulNumber(const T num) {
+  S21_PROFILE(S21Operation::kMulNumber, rows_, cols_, 1.0 * rows_ * cols_,
+              2.0 * sizeof(T) * rows_ * cols_);
+  MakeWritable();
+  ForEachBlock(static_cast<std::size_t>(rows_) * cols_,
+               [&](std::size_t from, std::size_t count) {
+                 S21ActiveKernels<T>().scale(count, data_ + from, num);
+               });
+}
+
+//Функция умножения текущей матрицы на вторую матрицу. Вычисление идет
+//блочным ядром S21Gemm с упаковкой операндов (см. s21_gemm.cc), а для
+//больших матриц - алгоритмом Штрассена-Винограда (s21_strassen.cc)
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix &other) {
+  *this = Multiply(other);
 }
 
-//Функция умножения текущей матрицы на вторую матрицу
-void S21Matrix::MulMatrix(const S21Matrix &other) {
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix &other,
+                                  S21MulAlgorithm algorithm) {
+  *this = Multiply(other, algorithm);
+}
+
+// произведение в новую матрицу: одно выделение памяти под результат
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Multiply(
+    const S21BasicMatrix &other, S21MulAlgorithm algorithm) const {
   if (cols_ != other.rows_) {
     throw std::invalid_argument(
         "The number of columns of the first matrix is not equal to the "
         "number "
         "of rows of the second matrix");
   }
-  S21Matrix tmp_matrix(rows_, other.cols_);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      double sum = 0.0;
-      for (int n = 0; n < cols_; n++) {
-        sum += matrix_[i][n] * other.matrix_[n][j];
-      }
-      tmp_matrix.matrix_[i][j] = sum;
-    }
+  return Multiply(rows_, other.cols_, cols_, data_, Stride(), other.data_,
+                  other.Stride(), algorithm);
+}
+
+// C (m x n) = A (m x k) * B (k x n) для буферов с ведущими размерностями
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Multiply(int m, int n, int k,
+                                              const T *a, int lda, const T *b,
+                                              int ldb,
+                                              S21MulAlgorithm algorithm) {
+  S21_PROFILE(S21Operation::kMulMatrix, m, n, 2.0 * m * n * k,
+              sizeof(T) * (1.0 * m * k + 1.0 * k * n + 1.0 * m * n));
+  S21BasicMatrix result;
+  result.rows_ = m;
+  result.cols_ = n;
+  result.AllocateMatrix();
+  if (m == 1 || n == 1 || k == 1) {
+    MultiplyVectorShape(m, n, k, a, lda, b, ldb, result.data_);
+    return result;
+  }
+  S21ExecutionPolicy policy = S21GetExecutionPolicy();
+  if (algorithm == S21MulAlgorithm::kAuto) {
+    int min_size = std::min({m, n, k});
+    bool large = policy.strassen_threshold > 0 &&
+                 min_size >= policy.strassen_threshold;
+    algorithm = large ? S21MulAlgorithm::kStrassen : S21MulAlgorithm::kClassic;
+  }
+  if (algorithm == S21MulAlgorithm::kStrassen) {
+    S21StrassenGemm(m, n, k, a, lda, b, ldb, result.data_, result.Stride(),
+                    policy.strassen_crossover);
+  } else {
+    S21Gemm(m, n, k, a, lda, b, ldb, result.data_, result.Stride());
+  }
+  return result;
+}
+
+// Размер out проверяется до вычислений: совпадает - пишем в его буфер,
+// иначе out заменяется новой матрицей нужного размера.
+template <typename T>
+void S21BasicMatrix<T>::MulVector(const S21BasicMatrix &vector,
+                                  S21BasicMatrix *out) const {
+  bool column = vector.cols_ == 1 && vector.rows_ == cols_;
+  if (!column && (vector.rows_ != 1 || vector.cols_ != rows_)) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  if (out == this || out == &vector) {
+    *out = MulVector(vector);
+    return;
+  }
+  int rows = column ? rows_ : 1;
+  int cols = column ? 1 : cols_;
+  S21_PROFILE(S21Operation::kMulMatrix, rows, cols, 2.0 * rows_ * cols_,
+              sizeof(T) * (1.0 * rows_ * cols_ + vector.rows_ * vector.cols_ +
+                           rows * cols));
+  if (out->rows_ != rows || out->cols_ != cols) {
+    *out = S21BasicMatrix(rows, cols);
+  }
+  T *y = out->Data();
+  if (column) {
+    S21Gemv(rows_, cols_, data_, Stride(), vector.data_, y);
+  } else {
+    S21Gevm(rows_, cols_, data_, Stride(), vector.data_, y);
   }
-  *this = tmp_matrix;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::MulVector(
+    const S21BasicMatrix &vector) const {
+  S21BasicMatrix result;
+  MulVector(vector, &result);
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21MulViews(const S21BasicMatrixView<const T> &lhs,
+                              const S21BasicMatrixView<const T> &rhs,
+                              S21MulAlgorithm algorithm) {
+  if (lhs.GetCols() != rhs.GetRows()) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number "
+        "of rows of the second matrix");
+  }
+  if (!lhs.IsStrided()) {
+    return S21MulViews<T>(S21BasicMatrix<T>(lhs).View(), rhs, algorithm);
+  }
+  if (!rhs.IsStrided()) {
+    return S21MulViews<T>(lhs, S21BasicMatrix<T>(rhs).View(), algorithm);
+  }
+  if (!lhs.IsDense() || !rhs.IsDense()) {
+    return S21BasicMatrix<T>::MultiplyStrided(lhs, rhs, algorithm);
+  }
+  return S21BasicMatrix<T>::Multiply(lhs.GetRows(), rhs.GetCols(),
+                                     lhs.GetCols(), lhs.Data(),
+                                     lhs.RowStride(), rhs.Data(),
+                                     rhs.RowStride(), algorithm);
+}
+
+// Классическое умножение читает шаги при упаковке панелей. Векторным
+// формам и Штрассену нужен плотный буфер, для них виды копируются.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::MultiplyStrided(
+    const S21BasicMatrixView<const T> &lhs,
+    const S21BasicMatrixView<const T> &rhs, S21MulAlgorithm algorithm) {
+  int m = lhs.GetRows();
+  int n = rhs.GetCols();
+  int k = lhs.GetCols();
+  S21ExecutionPolicy policy = S21GetExecutionPolicy();
+  bool strassen =
+      algorithm == S21MulAlgorithm::kStrassen ||
+      (algorithm == S21MulAlgorithm::kAuto && policy.strassen_threshold > 0 &&
+       std::min({m, n, k}) >= policy.strassen_threshold);
+  if (m == 1 || n == 1 || k == 1 || strassen) {
+    S21BasicMatrix a(lhs);
+    S21BasicMatrix b(rhs);
+    return Multiply(m, n, k, a.data_, a.Stride(), b.data_, b.Stride(),
+                    algorithm);
+  }
+  S21_PROFILE(S21Operation::kMulMatrix, m, n, 2.0 * m * n * k,
+              sizeof(T) * (1.0 * m * k + 1.0 * k * n + 1.0 * m * n));
+  S21BasicMatrix result;
+  result.rows_ = m;
+  result.cols_ = n;
+  result.AllocateMatrix();
+  S21GemmStrided(m, n, k, lhs.Data(), lhs.RowStride(), lhs.ColStride(),
+                 rhs.Data(), rhs.RowStride(), rhs.ColStride(), result.data_,
+                 static_cast<int>(result.Stride()));
+  return result;
 }
 
 //Создает новую транспонированную матрицу из текущей и возвращает ее.
-S21Matrix S21Matrix::Transpose() const {
-  S21Matrix result(cols_, rows_);
+//Матрица обходится квадратными блоками kTransposeTile x kTransposeTile:
+//блок источника и блок результата одновременно помещаются в L1, а сам блок
+//транспонируется векторным ядром. Полосы блоков делятся между потоками.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() const & {
+  S21_PROFILE(S21Operation::kTranspose, rows_, cols_, 0.0,
+              2.0 * sizeof(T) * rows_ * cols_);
+  S21BasicMatrix result;
+  result.rows_ = cols_;
+  result.cols_ = rows_;
+  result.AllocateMatrix();
 
-  for (int i = 0; i < result.rows_; i++) {
-    for (int j = 0; j < result.cols_; j++) {
-      result.matrix_[i][j] = matrix_[j][i];
+  const S21BasicElementwiseKernels<T> &kernels = S21ActiveKernels<T>();
+  int tiles = (rows_ + kTransposeTile - 1) / kTransposeTile;
+  S21ParallelFor(0, tiles, static_cast<double>(rows_) * cols_,
+                 [&](int first, int last) {
+                   for (int i = first * kTransposeTile;
+                        i < std::min(rows_, last * kTransposeTile);
+                        i += kTransposeTile) {
+                     int tile_rows = std::min(kTransposeTile, rows_ - i);
+                     for (int j = 0; j < cols_; j += kTransposeTile) {
+                       int tile_cols = std::min(kTransposeTile, cols_ - j);
+                       kernels.transpose(tile_rows, tile_cols,
+                                         data_ + i * Stride() + j, Stride(),
+                                         result.data_ + j * result.Stride() + i,
+                                         result.Stride());
+                     }
+                   }
+                 });
+
+  return result;
+}
+
+//Транспонирование временной матрицы выполняется на месте, без копии.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() && {
+  TransposeInPlace();
+  return std::move(*this);
+}
+
+//Транспонирование на месте. Квадратная матрица обменивает симметричные
+//блоки через буфер на стеке размером в один блок. Прямоугольная
+//переставляется по циклам перестановки: элемент с индексом k переходит в
+//k * rows mod (rows * cols - 1); пройденные позиции отмечаются битовой
+//маской, так что дополнительная память - один бит на элемент.
+template <typename T>
+void S21BasicMatrix<T>::TransposeInPlace() {
+  S21_PROFILE(S21Operation::kTranspose, rows_, cols_, 0.0,
+              2.0 * sizeof(T) * rows_ * cols_);
+  MakeWritable();
+  if (rows_ == cols_) {
+    const S21BasicElementwiseKernels<T> &kernels = S21ActiveKernels<T>();
+    int n = rows_;
+    std::ptrdiff_t stride = Stride();
+    T tile[kTransposeTile * kTransposeTile];
+    for (int bi = 0; bi < n; bi += kTransposeTile) {
+      int tile_rows = std::min(kTransposeTile, n - bi);
+      for (int i = bi; i < bi + tile_rows; i++) {
+        for (int j = i + 1; j < bi + tile_rows; j++) {
+          std::swap(data_[i * stride + j], data_[j * stride + i]);
+        }
+      }
+      for (int bj = bi + kTransposeTile; bj < n; bj += kTransposeTile) {
+        int tile_cols = std::min(kTransposeTile, n - bj);
+        T *upper = data_ + bi * stride + bj;
+        T *lower = data_ + bj * stride + bi;
+        kernels.transpose(tile_rows, tile_cols, upper, stride, tile,
+                          tile_rows);
+        kernels.transpose(tile_cols, tile_rows, lower, stride, upper, stride);
+        for (int r = 0; r < tile_cols; r++) {
+          std::copy_n(tile + r * tile_rows, tile_rows, lower + r * stride);
+        }
+      }
     }
+    return;
   }
 
-  return result;
+  std::size_t count = static_cast<std::size_t>(rows_) * cols_;
+  if (rows_ != 1 && cols_ != 1 && count > 2) {
+    std::size_t modulus = count - 1;
+    std::vector<bool> visited(count, false);
+    for (std::size_t start = 1; start < modulus; start++) {
+      if (visited[start]) {
+        continue;
+      }
+      std::size_t current = start;
+      T carried = data_[start];
+      do {
+        std::size_t next = current * rows_ % modulus;
+        std::swap(carried, data_[next]);
+        visited[current] = true;
+        current = next;
+      } while (current != start);
+    }
+  }
+  std::swap(rows_, cols_);
+  delete[] rows_view_;
+  rows_view_ = nullptr;
 }
 
 //Вычисляет матрицу алгебраического сложения текущей и возвращает ее
@@ -277,77 +832,320 @@ S21Matrix S21Matrix::Transpose() const {
 //Матрица алгебраических дополнений состоит из таких алгебраических дополнений
 //(посчитанных для каждого элемента матрицы)
 
-S21Matrix S21Matrix::Minor(int inrows, int incols) const {
-  int m_rows = 0;
-  int m_cols = 0;
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Minor(int inrows, int incols) const {
+  return S21BasicMatrix(View().Minor(inrows, incols));
+}
 
-  S21Matrix result(rows_ - 1, cols_ - 1);
-  if (rows_ != 1 || cols_ != 1 || matrix_ != nullptr) {
-    for (int i = 0; i < GetRows(); i++) {
-      if (i == inrows) {
-        continue;
-      }
-      m_cols = 0;
-      for (int j = 0; j < GetCols(); j++) {
-        if (j == incols) {
-          continue;
-        }
-        result.matrix_[m_rows][m_cols] = matrix_[i][j];
-        m_cols++;
+//Определитель вычисляется через LU-разложение за O(n^3) (через разложение
+//Холецкого, если матрица симметрична и положительно определена), у целых
+//матриц - алгоритмом Барейса за то же время
+template <typename T>
+T S21BasicMatrix<T>::Determinant() const {
+  if (rows_ != cols_) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (rows_ == 0) {
+    return 0;
+  }
+  S21_PROFILE(S21Operation::kDeterminant, rows_, cols_,
+              2.0 / 3.0 * rows_ * rows_ * rows_,
+              2.0 * sizeof(T) * rows_ * cols_);
+  if constexpr (std::is_integral<T>::value) {
+    return BareissDeterminant(rows_, data_, Stride());
+  }
+  std::shared_ptr<const S21BasicLU<T>> lu = std::atomic_load(&lu_);
+  if (lu != nullptr) {
+    return lu->Determinant();
+  }
+  std::shared_ptr<const S21BasicCholesky<T>> cholesky = TryCholesky();
+  return cholesky != nullptr ? cholesky->Determinant() : LU().Determinant();
+}
+
+template <typename T>
+S21BasicLU<T> S21BasicMatrix<T>::LU() const { return S21BasicLU<T>(*this); }
+
+template <typename T>
+S21BasicCholesky<T> S21BasicMatrix<T>::Cholesky() const {
+  return S21BasicCholesky<T>(*this);
+}
+
+template <typename T>
+S21BasicQR<T> S21BasicMatrix<T>::QR() const { return S21BasicQR<T>(*this); }
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::LeastSquares(
+    const S21BasicMatrix &rhs) const {
+  return QR().Solve(rhs);
+}
+
+// точное сравнение: матрица, собранная как B^T * B или B + B^T, симметрична
+// побитово, а для почти симметричной Холецкий все равно был бы неточен
+template <typename T>
+bool S21BasicMatrix<T>::IsSymmetric() const {
+  if (rows_ != cols_) {
+    return false;
+  }
+  std::ptrdiff_t stride = Stride();
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < i; j++) {
+      if (data_[i * stride + j] != data_[j * stride + i]) {
+        return false;
       }
-      m_rows++;
     }
-  } else {
-    result = *this;
   }
-  return result;
+  return true;
+}
+
+// Разложение Холецкого симметричной положительно определенной матрицы
+// запоминается так же, как lu_; для остальных возвращается nullptr.
+// Неудачная попытка тоже запоминается, чтобы следующие Solve и
+// Determinant не повторяли ее.
+template <typename T>
+std::shared_ptr<const S21BasicCholesky<T>> S21BasicMatrix<T>::TryCholesky()
+    const {
+  if constexpr (std::is_integral<T>::value) {
+    return nullptr;
+  }
+  std::shared_ptr<const S21BasicCholesky<T>> cholesky =
+      std::atomic_load(&cholesky_);
+  if (cholesky != nullptr || rows_ == 0 ||
+      cholesky_failed_.load(std::memory_order_relaxed) || !IsSymmetric()) {
+    return cholesky;
+  }
+  cholesky = std::make_shared<const S21BasicCholesky<T>>(*this);
+  if (!cholesky->IsPositiveDefinite()) {
+    cholesky_failed_.store(true, std::memory_order_relaxed);
+    return nullptr;
+  }
+  std::atomic_store(&cholesky_, cholesky);
+  return cholesky;
 }
 
-double S21Matrix::Determinant() const {
+// Разложение строится при первом вызове и переиспользуется, пока матрица
+// не изменится. Если два потока строят его одновременно, сохраняется
+// любое из двух одинаковых.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Solve(const S21BasicMatrix &rhs) const {
   if (rows_ != cols_) {
     throw std::length_error("Error: matrix size is wrong");
   }
-  double result = 0.0;
-  if (rows_ == 1) {
-    result = matrix_[0][0];
-  } else {
-    for (int i = 0; i < cols_; i++) {
-      S21Matrix minor = Minor(0, i);
-      double minor_det = minor.Determinant();
-      if (i % 2 == 0) {
-        result += matrix_[0][i] * minor_det;
-      } else {
-        result -= matrix_[0][i] * minor_det;
+  std::shared_ptr<const S21BasicLU<T>> lu = std::atomic_load(&lu_);
+  if (lu == nullptr) {
+    std::shared_ptr<const S21BasicCholesky<T>> cholesky = TryCholesky();
+    if (cholesky != nullptr) {
+      return cholesky->Solve(rhs);
+    }
+    lu = std::make_shared<const S21BasicLU<T>>(*this);
+    std::atomic_store(&lu_, lu);
+  }
+  return lu->Solve(rhs);
+}
+
+// Итеративное уточнение, как в LAPACK dsgesv: x = LU_r^-1 * b, затем
+// x += LU_r^-1 * (b - A * x). Каждый шаг уменьшает ошибку примерно в
+// cond(A) * eps(Reduced) раз, поэтому если она не убывает хотя бы вдвое,
+// уточнение бесполезно и решение пересчитывается в полной точности.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::SolveMixed(
+    const S21BasicMatrix &rhs, S21RefinementReport *report) const {
+  if (rows_ != cols_) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (rhs.rows_ != rows_) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  if (std::is_integral<T>::value) {
+    throw std::logic_error("LU is not defined for integer matrices");
+  }
+  std::shared_ptr<const S21BasicLU<Reduced>> lu =
+      std::atomic_load(&reduced_lu_);
+  if (lu == nullptr && rows_ > 0 &&
+      MaxAbs(*this) <= std::numeric_limits<Reduced>::max()) {
+    lu = std::make_shared<const S21BasicLU<Reduced>>(
+        S21BasicMatrix<Reduced>(*this));
+    std::atomic_store(&reduced_lu_, lu);
+  }
+
+  S21RefinementReport result;
+  S21BasicMatrix x;
+  double a_norm = RowSumNorm(*this);
+  bool converged = false;
+  if (lu != nullptr && !lu->IsSingular()) {
+    double limit = std::sqrt(static_cast<double>(rows_)) *
+                   std::numeric_limits<T>::epsilon();
+    double previous = std::numeric_limits<double>::infinity();
+    x = S21BasicMatrix(lu->Solve(S21BasicMatrix<Reduced>(rhs)));
+    while (result.iterations <= kMaxRefinements) {
+      S21BasicMatrix residual = rhs;
+      residual -= *this * x;
+      MeasureResidual(residual, x, a_norm, &result);
+      if (result.backward_error <= limit) {
+        converged = true;
+        break;
+      }
+      if (!(result.backward_error <= 0.5 * previous)) {
+        break;
       }
+      previous = result.backward_error;
+      x += S21BasicMatrix(lu->Solve(S21BasicMatrix<Reduced>(residual)));
+      result.iterations++;
     }
   }
-  return result;
+  if (!converged) {
+    x = Solve(rhs);
+    result.fell_back = true;
+    if (report != nullptr) {
+      S21BasicMatrix residual = rhs;
+      residual -= *this * x;
+      MeasureResidual(residual, x, a_norm, &result);
+    }
+  }
+  if (report != nullptr) {
+    *report = result;
+  }
+  return x;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMixed(
+    S21RefinementReport *report) const {
+  if (cols_ != rows_) {
+    throw std::invalid_argument("Matrix is not square");
+  }
+  if (rows_ == 0) {
+    throw std::logic_error("Мatrix is not invertible.");
+  }
+  S21BasicMatrix identity(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    identity.data_[i * identity.Stride() + i] = 1;
+  }
+  return SolveMixed(identity, report);
+}
+
+// Произведение считается полосами столбцов: каждая полоса - обычный
+// S21Gemm со своим делением строк между потоками, а между полосами
+// проверяется отмена. Штрассен здесь не используется - его рекурсию
+// нельзя прервать посередине.
+template <typename T>
+std::future<S21BasicMatrix<T>> S21BasicMatrix<T>::MulMatrixAsync(
+    const S21BasicMatrix &other, S21AsyncOptions options) const {
+  if (cols_ != other.rows_) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number "
+        "of rows of the second matrix");
+  }
+  auto a = std::make_shared<const S21BasicMatrix>(*this);
+  auto b = std::make_shared<const S21BasicMatrix>(other);
+  return S21RunAsync<S21BasicMatrix>(std::move(options), [a, b]() {
+    int m = a->rows_, n = b->cols_, k = a->cols_;
+    if (m == 1 || n == 1 || k == 1) {
+      return a->Multiply(*b, S21MulAlgorithm::kClassic);
+    }
+    S21_PROFILE(S21Operation::kMulMatrix, m, n, 2.0 * m * n * k,
+                sizeof(T) * (1.0 * m * k + 1.0 * k * n + 1.0 * m * n));
+    S21BasicMatrix result;
+    result.rows_ = m;
+    result.cols_ = n;
+    result.AllocateMatrix();
+    for (int j = 0; j < n; j += kAsyncCols) {
+      S21Checkpoint(static_cast<double>(j) / n);
+      S21Gemm(m, std::min(kAsyncCols, n - j), k, a->data_, a->Stride(),
+              b->data_ + j, b->Stride(), result.data_ + j, result.Stride());
+    }
+    return result;
+  });
+}
+
+template <typename T>
+std::future<S21BasicMatrix<T>> S21BasicMatrix<T>::InverseAsync(
+    S21AsyncOptions options) const {
+  if (cols_ != rows_) {
+    throw std::invalid_argument("Matrix is not square");
+  }
+  auto a = std::make_shared<const S21BasicMatrix>(*this);
+  return S21RunAsync<S21BasicMatrix>(std::move(options),
+                                     [a]() { return a->InverseMatrix(); });
 }
 
-S21Matrix S21Matrix::CalcComplements() const {
-  if (matrix_ == nullptr && rows_ < 1) {
+template <typename T>
+std::future<T> S21BasicMatrix<T>::DeterminantAsync(
+    S21AsyncOptions options) const {
+  if (rows_ != cols_) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  auto a = std::make_shared<const S21BasicMatrix>(*this);
+  return S21RunAsync<T>(std::move(options),
+                        [a]() { return a->Determinant(); });
+}
+
+// Разложение строится в копии, поэтому в кэш исходной матрицы не попадает.
+template <typename T>
+std::future<S21BasicMatrix<T>> S21BasicMatrix<T>::SolveAsync(
+    const S21BasicMatrix &rhs, S21AsyncOptions options) const {
+  if (rows_ != cols_) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (rhs.rows_ != rows_) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  auto a = std::make_shared<const S21BasicMatrix>(*this);
+  auto b = std::make_shared<const S21BasicMatrix>(rhs);
+  return S21RunAsync<S21BasicMatrix>(std::move(options),
+                                     [a, b]() { return a->Solve(*b); });
+}
+
+// Вызывается перед любым изменением элементов. Изменять матрицу
+// одновременно с другими обращениями к ней нельзя, поэтому атомарность
+// здесь не нужна.
+template <typename T>
+void S21BasicMatrix<T>::DropCache() const {
+  if (lu_ != nullptr) {
+    lu_.reset();
+  }
+  if (reduced_lu_ != nullptr) {
+    reduced_lu_.reset();
+  }
+  if (cholesky_ != nullptr) {
+    cholesky_.reset();
+  }
+  cholesky_failed_ = false;
+}
+
+//Для обратимой матрицы дополнения получаются как det(A) * (A^-1)^T за
+//O(n^3); разложение по минорам остается для вырожденной матрицы и для
+//целых матриц, где обращение с делением неточно.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() const {
+  if (data_ == nullptr && rows_ < 1) {
     throw std::length_error("Matrix is empty");
   }
   if (cols_ != rows_) {
     throw std::invalid_argument("Matrix is not square");
   }
-  S21Matrix result(rows_, cols_);
   if (rows_ == 1) {
     throw std::invalid_argument(
         "СalcComplements does not exist for matrix size 1х1");
   }
+  S21_PROFILE(S21Operation::kComplements, rows_, cols_,
+              2.0 * rows_ * rows_ * rows_, 2.0 * sizeof(T) * rows_ * cols_);
+  if constexpr (!std::is_integral<T>::value) {
+    S21BasicMatrix inverse = *this;
+    T det = 0;
+    if (inverse.InvertInPlace(&det)) {
+      return std::move(inverse).Transpose() * det;
+    }
+  }
+
+  S21BasicMatrix result(rows_, cols_);
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
-      double minor_det = 0.0;
-      if (rows_ == 1 && cols_ == 1) {
-        minor_det = matrix_[0][0];
-      } else {
-        minor_det = Minor(i, j).Determinant();
-      }
+      T minor_det = Minor(i, j).Determinant();
       if ((i + j) % 2 == 0) {
-        result.matrix_[i][j] = minor_det;
+        result.data_[i * result.Stride() + j] = minor_det;
       } else {
-        result.matrix_[i][j] = -minor_det;
+        result.data_[i * result.Stride() + j] = -minor_det;
       }
     }
   }
@@ -355,76 +1153,157 @@ S21Matrix S21Matrix::CalcComplements() const {
 }
 
 //Обра́тная ма́трица — такая матрица при умножении которой на исходную матрицу
-// A получается единичная матрица
+// A получается единичная матрица. Целая матрица обратима в целых числах
+// только при det(A) = ±1, тогда A^-1 = det(A) * adj(A).
 
-S21Matrix S21Matrix::InverseMatrix() const {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() const {
   if (cols_ != rows_) {
     throw std::invalid_argument("Matrix is not square");
   }
-  double det = Determinant();
-  if (std::fabs(det) < epsilon) {
+  if (rows_ == 0) {
     throw std::logic_error("Мatrix is not invertible.");
   }
-  S21Matrix inverse_tmp(rows_, cols_);
-  if (rows_ == 1) {
-    inverse_tmp.matrix_[0][0] = 1.0 / matrix_[0][0];
-  } else {
-    S21Matrix tmp = CalcComplements().Transpose();
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        inverse_tmp.matrix_[i][j] = tmp.matrix_[i][j] / det;
-      }
+  S21_PROFILE(S21Operation::kInverse, rows_, cols_,
+              2.0 * rows_ * rows_ * rows_, 2.0 * sizeof(T) * rows_ * cols_);
+  if constexpr (std::is_integral<T>::value) {
+    T det = Determinant();
+    if (det != 1 && det != -1) {
+      throw std::logic_error("Мatrix is not invertible.");
     }
+    return rows_ == 1 ? *this : CalcComplements().Transpose() * det;
+  }
+  std::shared_ptr<const S21BasicCholesky<T>> cholesky = TryCholesky();
+  if (cholesky != nullptr) {
+    return cholesky->Inverse();
+  }
+  S21BasicMatrix inverse_tmp = *this;
+  if (!inverse_tmp.InvertInPlace(nullptr)) {
+    throw std::logic_error("Мatrix is not invertible.");
   }
   return inverse_tmp;
 }
 
-void S21Matrix::SetValue(int row, int col, double value) {
+//Обращение методом Гаусса-Жордана с выбором ведущего элемента по столбцу
+//прямо в буфере матрицы, O(n^3) без дополнительных матриц. Перестановки
+//строк запоминаются и в конце применяются к столбцам в обратном порядке.
+//Возвращает false, если ведущий элемент не превосходит порога
+//S21BasicLU::SingularThreshold (матрица вырождена, содержимое буфера тогда
+//не определено). В det, если он
+//передан, записывается определитель исходной матрицы.
+template <typename T>
+bool S21BasicMatrix<T>::InvertInPlace(T *det) {
+  DropCache();
+  int n = rows_;
+  std::ptrdiff_t stride = Stride();
+  std::vector<int> pivots(n);
+  T det_tmp = 1;
+  T threshold = S21BasicLU<T>::SingularThreshold(*this);
+
+  for (int k = 0; k < n; k++) {
+    // каждый шаг обновляет всю матрицу, работа растет линейно
+    S21Checkpoint(static_cast<double>(k) / n);
+    int pivot = k;
+    T max_abs = std::abs(data_[k * stride + k]);
+    for (int i = k + 1; i < n; i++) {
+      T value = std::abs(data_[i * stride + k]);
+      if (value > max_abs) {
+        max_abs = value;
+        pivot = i;
+      }
+    }
+    if (max_abs <= threshold) {
+      return false;
+    }
+    pivots[k] = pivot;
+    T *row_k = data_ + k * stride;
+    if (pivot != k) {
+      std::swap_ranges(row_k, row_k + n, data_ + pivot * stride);
+      det_tmp = -det_tmp;
+    }
+
+    T pivot_value = row_k[k];
+    det_tmp *= pivot_value;
+    row_k[k] = 1;
+    for (int j = 0; j < n; j++) {
+      row_k[j] /= pivot_value;
+    }
+    S21ParallelFor(0, n, static_cast<double>(n) * n, [&](int first, int last) {
+      for (int i = first; i < last; i++) {
+        if (i == k) {
+          continue;
+        }
+        T *row_i = data_ + i * stride;
+        T factor = row_i[k];
+        row_i[k] = 0;
+        for (int j = 0; j < n; j++) {
+          row_i[j] -= factor * row_k[j];
+        }
+      }
+    });
+  }
+
+  for (int k = n - 1; k >= 0; k--) {
+    if (pivots[k] != k) {
+      for (int i = 0; i < n; i++) {
+        std::swap(data_[i * stride + k], data_[i * stride + pivots[k]]);
+      }
+    }
+  }
+  if (det != nullptr) {
+    *det = det_tmp;
+  }
+  return true;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::SetValue(int row, int col, T value) {
   if (row >= 0 && row < rows_ && col >= 0 && col < cols_) {
-    matrix_[row][col] = value;
+    MakeWritable();
+    data_[row * Stride() + col] = value;
   } else {
     std::cout << "Error: incorrect matrix element indices." << std::endl;
   }
 }
 
-void S21Matrix::SetRows(int new_rows) {
+template <typename T>
+void S21BasicMatrix<T>::SetRows(int new_rows) {
   if (new_rows < 1) {
     throw std::invalid_argument("Rows is invalid");
   }
   if (rows_ != new_rows) {
-    S21Matrix tmp(new_rows, cols_);
-    int tmp_rows = 0;
-    if (new_rows < rows_) {
-      tmp_rows = new_rows;
-    } else {
-      tmp_rows = rows_;
-    }
-    for (int i = 0; i < tmp_rows; ++i) {
-      for (int j = 0; j < cols_; j++) {
-        tmp.matrix_[i][j] = matrix_[i][j];
-      }
-    }
-    *this = tmp;
+    Resize(new_rows, cols_);
   }
 }
 
-void S21Matrix::SetCols(int new_cols) {
+template <typename T>
+void S21BasicMatrix<T>::SetCols(int new_cols) {
   if (new_cols < 1) {
-    throw std::invalid_argument("Rows is invalid");
+    throw std::invalid_argument("Cols is invalid");
   }
   if (cols_ != new_cols) {
-    S21Matrix tmp(rows_, new_cols);
-    int tmp_cols = 0;
-    if (new_cols < rows_) {
-      tmp_cols = new_cols;
-    } else {
-      tmp_cols = cols_;
-    }
-    for (int i = 0; i < tmp_cols; ++i) {
-      for (int j = 0; j < cols_; j++) {
-        tmp.matrix_[i][j] = matrix_[i][j];
-      }
-    }
-    *this = tmp;
+    Resize(rows_, new_cols);
   }
-}
\ No newline at end of file
+}
+
+#define S21_INSTANTIATE_MATRIX(T)                                           \
+  template class S21BasicMatrix<T>;                                         \
+  template S21BasicMatrix<T> operator+(S21BasicMatrix<T> &&,                \
+                                       const S21BasicMatrix<T> &);          \
+  template S21BasicMatrix<T> operator+(const S21BasicMatrix<T> &,           \
+                                       S21BasicMatrix<T> &&);               \
+  template S21BasicMatrix<T> operator+(S21BasicMatrix<T> &&,                \
+                                       S21BasicMatrix<T> &&);               \
+  template S21BasicMatrix<T> operator-(S21BasicMatrix<T> &&,                \
+                                       const S21BasicMatrix<T> &);          \
+  template S21BasicMatrix<T> operator-(const S21BasicMatrix<T> &,           \
+                                       S21BasicMatrix<T> &&);               \
+  template S21BasicMatrix<T> operator-(S21BasicMatrix<T> &&,                \
+                                       S21BasicMatrix<T> &&);               \
+  template S21BasicMatrix<T> operator*(S21BasicMatrix<T> &&,                \
+                                       S21OperandScalar<S21BasicMatrix<T>>); \
+  template S21BasicMatrix<T> S21MulViews(const S21BasicMatrixView<const T> &, \
+                                         const S21BasicMatrixView<const T> &, \
+                                         S21MulAlgorithm);
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_MATRIX)
+#undef S21_INSTANTIATE_MATRIX
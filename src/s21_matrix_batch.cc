@@ -0,0 +1,686 @@
+#include "s21_matrix_batch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_MATRIX_X86 1
+#endif
+
+// Ядра пакетных операций написаны на векторных типах GCC: Lanes - восемь
+// double, по одному на матрицу. Тела ядер встраиваются (always_inline) в
+// обертки с атрибутом target, так что одна и та же запись компилируется в
+// SSE2, AVX2 или AVX-512; векторный тип передается только между
+// встроенными функциями, поэтому предупреждение об ABI таких параметров
+// (-Wpsabi) к ним не относится.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+#define S21_LANES_INLINE __attribute__((always_inline)) inline
+
+namespace {
+
+typedef double Lanes __attribute__((vector_size(64)));
+
+constexpr int kLanes = S21MatrixBatch::kLanes;
+static_assert(sizeof(Lanes) == kLanes * sizeof(double),
+              "one lane per matrix of the block");
+
+S21_LANES_INLINE Lanes Load(const double *p) {
+  Lanes v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+S21_LANES_INLINE void Store(double *p, const Lanes &v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+S21_LANES_INLINE Lanes Splat(double x) { return Lanes{} + x; }
+
+S21_LANES_INLINE Lanes Abs(const Lanes &x) { return x < 0.0 ? -x : x; }
+
+S21_LANES_INLINE Lanes Max(const Lanes &a, const Lanes &b) {
+  return a > b ? a : b;
+}
+
+S21_LANES_INLINE Lanes Det2(const Lanes *m) {
+  return m[0] * m[3] - m[1] * m[2];
+}
+
+S21_LANES_INLINE Lanes Det3(const Lanes *m) {
+  return m[0] * (m[4] * m[8] - m[5] * m[7]) -
+         m[1] * (m[3] * m[8] - m[5] * m[6]) +
+         m[2] * (m[3] * m[7] - m[4] * m[6]);
+}
+
+// Определитель и обратная 4 x 4 через миноры 2 x 2 первых двух строк (s)
+// и последних двух (c).
+struct Minors4 {
+  Lanes s[6];
+  Lanes c[6];
+};
+
+S21_LANES_INLINE void CalcMinors4(const Lanes *m, Minors4 *out) {
+  out->s[0] = m[0] * m[5] - m[4] * m[1];
+  out->s[1] = m[0] * m[6] - m[4] * m[2];
+  out->s[2] = m[0] * m[7] - m[4] * m[3];
+  out->s[3] = m[1] * m[6] - m[5] * m[2];
+  out->s[4] = m[1] * m[7] - m[5] * m[3];
+  out->s[5] = m[2] * m[7] - m[6] * m[3];
+  out->c[5] = m[10] * m[15] - m[14] * m[11];
+  out->c[4] = m[9] * m[15] - m[13] * m[11];
+  out->c[3] = m[9] * m[14] - m[13] * m[10];
+  out->c[2] = m[8] * m[15] - m[12] * m[11];
+  out->c[1] = m[8] * m[14] - m[12] * m[10];
+  out->c[0] = m[8] * m[13] - m[12] * m[9];
+}
+
+S21_LANES_INLINE Lanes Det4(const Minors4 &k) {
+  return k.s[0] * k.c[5] - k.s[1] * k.c[4] + k.s[2] * k.c[3] +
+         k.s[3] * k.c[2] - k.s[4] * k.c[1] + k.s[5] * k.c[0];
+}
+
+S21_LANES_INLINE Lanes ClosedDeterminant(int n, const Lanes *m) {
+  if (n == 1) {
+    return m[0];
+  }
+  if (n == 2) {
+    return Det2(m);
+  }
+  if (n == 3) {
+    return Det3(m);
+  }
+  Minors4 minors;
+  CalcMinors4(m, &minors);
+  return Det4(minors);
+}
+
+// присоединенная матрица (транспонированные алгебраические дополнения)
+S21_LANES_INLINE void Adjugate(int n, const Lanes *m, Lanes *adj) {
+  if (n == 1) {
+    adj[0] = Splat(1.0);
+  } else if (n == 2) {
+    adj[0] = m[3];
+    adj[1] = -m[1];
+    adj[2] = -m[2];
+    adj[3] = m[0];
+  } else if (n == 3) {
+    adj[0] = m[4] * m[8] - m[5] * m[7];
+    adj[1] = m[2] * m[7] - m[1] * m[8];
+    adj[2] = m[1] * m[5] - m[2] * m[4];
+    adj[3] = m[5] * m[6] - m[3] * m[8];
+    adj[4] = m[0] * m[8] - m[2] * m[6];
+    adj[5] = m[2] * m[3] - m[0] * m[5];
+    adj[6] = m[3] * m[7] - m[4] * m[6];
+    adj[7] = m[1] * m[6] - m[0] * m[7];
+    adj[8] = m[0] * m[4] - m[1] * m[3];
+  } else {
+    Minors4 k;
+    CalcMinors4(m, &k);
+    adj[0] = m[5] * k.c[5] - m[6] * k.c[4] + m[7] * k.c[3];
+    adj[1] = -m[1] * k.c[5] + m[2] * k.c[4] - m[3] * k.c[3];
+    adj[2] = m[13] * k.s[5] - m[14] * k.s[4] + m[15] * k.s[3];
+    adj[3] = -m[9] * k.s[5] + m[10] * k.s[4] - m[11] * k.s[3];
+    adj[4] = -m[4] * k.c[5] + m[6] * k.c[2] - m[7] * k.c[1];
+    adj[5] = m[0] * k.c[5] - m[2] * k.c[2] + m[3] * k.c[1];
+    adj[6] = -m[12] * k.s[5] + m[14] * k.s[2] - m[15] * k.s[1];
+    adj[7] = m[8] * k.s[5] - m[10] * k.s[2] + m[11] * k.s[1];
+    adj[8] = m[4] * k.c[4] - m[5] * k.c[2] + m[7] * k.c[0];
+    adj[9] = -m[0] * k.c[4] + m[1] * k.c[2] - m[3] * k.c[0];
+    adj[10] = m[12] * k.s[4] - m[13] * k.s[2] + m[15] * k.s[0];
+    adj[11] = -m[8] * k.s[4] + m[9] * k.s[2] - m[11] * k.s[0];
+    adj[12] = -m[4] * k.c[3] + m[5] * k.c[1] - m[6] * k.c[0];
+    adj[13] = m[0] * k.c[3] - m[1] * k.c[1] + m[2] * k.c[0];
+    adj[14] = -m[12] * k.s[3] + m[13] * k.s[1] - m[14] * k.s[0];
+    adj[15] = m[8] * k.s[3] - m[9] * k.s[1] + m[10] * k.s[0];
+  }
+}
+
+// Порог вырожденности для обратной n <= 4: порог ведущего элемента
+// S21LU n * eps * max|a|, пересчитанный на произведение n ведущих
+// элементов, то есть n * eps * max|a|^n. На определитель не влияет.
+S21_LANES_INLINE Lanes DeterminantLimit(int n, const Lanes *m) {
+  Lanes max_abs = Lanes{};
+  for (int k = 0; k < n * n; k++) {
+    max_abs = Max(max_abs, Abs(m[k]));
+  }
+  Lanes limit = Splat(n * std::numeric_limits<double>::epsilon());
+  for (int k = 0; k < n; k++) {
+    limit *= max_abs;
+  }
+  return limit;
+}
+
+S21_LANES_INLINE void StoreFlags(const Lanes &bad, std::uint8_t *flags) {
+  for (int l = 0; l < kLanes; l++) {
+    flags[l] = bad[l] != 0.0;
+  }
+}
+
+// Исключение Гаусса-Жордана в каждой дорожке для n > 4. Ведущий элемент
+// выбирается по столбцу отдельно для каждой матрицы, поэтому перестановка
+// строк делается смешиванием по маске. Дорожка с ведущим элементом ниже
+// порога отмечается в bad, но исключение в ней идет дальше, чтобы
+// определитель остался произведением ведущих элементов; нулевой ведущий
+// элемент подменяется единицей, чтобы не плодить бесконечности.
+// inverse == nullptr - только определитель.
+S21_LANES_INLINE void EliminateBlock(int n, const double *a, int stride,
+                                     double *work, double *det,
+                                     double *inverse, std::uint8_t *singular) {
+  std::size_t nn = static_cast<std::size_t>(n) * n;
+  double *w = work;
+  double *inv = work + nn * kLanes;
+  Lanes max_abs = Lanes{};
+  for (std::size_t k = 0; k < nn; k++) {
+    Lanes value = Load(a + k * stride);
+    max_abs = Max(max_abs, Abs(value));
+    Store(w + k * kLanes, value);
+    if (inverse != nullptr) {
+      Store(inv + k * kLanes, Splat(k / n == k % n ? 1.0 : 0.0));
+    }
+  }
+  Lanes threshold = max_abs * (n * std::numeric_limits<double>::epsilon());
+  Lanes result = Splat(1.0);
+  Lanes bad = Lanes{};
+  auto at = [n](double *base, int i, int j) {
+    return base + (static_cast<std::size_t>(i) * n + j) * kLanes;
+  };
+  for (int k = 0; k < n; k++) {
+    Lanes best = Abs(Load(at(w, k, k)));
+    Lanes pivot_row = Splat(k);
+    for (int i = k + 1; i < n; i++) {
+      Lanes value = Abs(Load(at(w, i, k)));
+      pivot_row = value > best ? Splat(i) : pivot_row;
+      best = Max(best, value);
+    }
+    for (int i = k + 1; i < n; i++) {
+      auto take = pivot_row == Splat(i);
+      for (int j = 0; j < n; j++) {
+        Lanes upper = Load(at(w, k, j));
+        Lanes lower = Load(at(w, i, j));
+        Store(at(w, k, j), take ? lower : upper);
+        Store(at(w, i, j), take ? upper : lower);
+        if (inverse != nullptr) {
+          upper = Load(at(inv, k, j));
+          lower = Load(at(inv, i, j));
+          Store(at(inv, k, j), take ? lower : upper);
+          Store(at(inv, i, j), take ? upper : lower);
+        }
+      }
+    }
+    Lanes pivot = Load(at(w, k, k));
+    result = pivot_row != Splat(k) ? -result : result;
+    result *= pivot;
+    bad = best <= threshold ? Splat(1.0) : bad;
+    pivot = pivot == 0.0 ? Splat(1.0) : pivot;
+    Lanes reciprocal = 1.0 / pivot;
+    if (inverse == nullptr) {
+      for (int i = k + 1; i < n; i++) {
+        Lanes factor = Load(at(w, i, k)) * reciprocal;
+        for (int j = k + 1; j < n; j++) {
+          Store(at(w, i, j), Load(at(w, i, j)) - factor * Load(at(w, k, j)));
+        }
+      }
+      continue;
+    }
+    for (int j = 0; j < n; j++) {
+      Store(at(w, k, j), Load(at(w, k, j)) * reciprocal);
+      Store(at(inv, k, j), Load(at(inv, k, j)) * reciprocal);
+    }
+    for (int i = 0; i < n; i++) {
+      if (i == k) {
+        continue;
+      }
+      Lanes factor = Load(at(w, i, k));
+      for (int j = 0; j < n; j++) {
+        Store(at(w, i, j), Load(at(w, i, j)) - factor * Load(at(w, k, j)));
+        Store(at(inv, i, j),
+              Load(at(inv, i, j)) - factor * Load(at(inv, k, j)));
+      }
+    }
+  }
+  if (det != nullptr) {
+    Store(det, result);
+  }
+  if (inverse != nullptr) {
+    Lanes nan = Splat(std::numeric_limits<double>::quiet_NaN());
+    for (std::size_t k = 0; k < nn; k++) {
+      Lanes value = Load(inv + k * kLanes);
+      Store(inverse + k * stride, bad != 0.0 ? nan : value);
+    }
+    StoreFlags(bad, singular);
+  }
+}
+
+S21_LANES_INLINE void DeterminantLanes(int n, const double *a, int stride,
+                                       int first, int last, double *det) {
+  if (n > 4) {
+    S21ScratchBuffer work(2 * static_cast<std::size_t>(n) * n * kLanes);
+    for (int b = first; b < last; b += kLanes) {
+      EliminateBlock(n, a + b, stride, work.Get(), det + b, nullptr, nullptr);
+    }
+    return;
+  }
+  Lanes m[16];
+  for (int b = first; b < last; b += kLanes) {
+    for (int k = 0; k < n * n; k++) {
+      m[k] = Load(a + static_cast<std::size_t>(k) * stride + b);
+    }
+    Store(det + b, ClosedDeterminant(n, m));
+  }
+}
+
+// для n <= 4 обратная - присоединенная матрица, деленная на определитель
+S21_LANES_INLINE void InverseLanes(int n, const double *a, int stride,
+                                   int first, int last, double *inverse,
+                                   std::uint8_t *singular) {
+  if (n > 4) {
+    S21ScratchBuffer work(2 * static_cast<std::size_t>(n) * n * kLanes);
+    for (int b = first; b < last; b += kLanes) {
+      EliminateBlock(n, a + b, stride, work.Get(), nullptr, inverse + b,
+                     singular + b);
+    }
+    return;
+  }
+  Lanes m[16];
+  Lanes adj[16];
+  Lanes nan = Splat(std::numeric_limits<double>::quiet_NaN());
+  for (int b = first; b < last; b += kLanes) {
+    for (int k = 0; k < n * n; k++) {
+      m[k] = Load(a + static_cast<std::size_t>(k) * stride + b);
+    }
+    Lanes det = ClosedDeterminant(n, m);
+    auto degenerate = Abs(det) <= DeterminantLimit(n, m);
+    Lanes reciprocal = 1.0 / (degenerate ? Splat(1.0) : det);
+    Adjugate(n, m, adj);
+    for (int k = 0; k < n * n; k++) {
+      Store(inverse + static_cast<std::size_t>(k) * stride + b,
+            degenerate ? nan : adj[k] * reciprocal);
+    }
+    StoreFlags(degenerate ? Splat(1.0) : Lanes{}, singular + b);
+  }
+}
+
+S21_LANES_INLINE void MultiplyLanes(int m, int k, int n, const double *a,
+                                    const double *b, int stride, int first,
+                                    int last, double *c) {
+  for (int lane = first; lane < last; lane += kLanes) {
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        Lanes sum = Lanes{};
+        for (int p = 0; p < k; p++) {
+          sum += Load(a + static_cast<std::size_t>(i * k + p) * stride + lane) *
+                 Load(b + static_cast<std::size_t>(p * n + j) * stride + lane);
+        }
+        Store(c + static_cast<std::size_t>(i * n + j) * stride + lane, sum);
+      }
+    }
+  }
+}
+
+void DeterminantGeneric(int n, const double *a, int stride, int first,
+                        int last, double *det) {
+  DeterminantLanes(n, a, stride, first, last, det);
+}
+
+void InverseGeneric(int n, const double *a, int stride, int first, int last,
+                    double *inverse, std::uint8_t *singular) {
+  InverseLanes(n, a, stride, first, last, inverse, singular);
+}
+
+void MultiplyGeneric(int m, int k, int n, const double *a, const double *b,
+                     int stride, int first, int last, double *c) {
+  MultiplyLanes(m, k, n, a, b, stride, first, last, c);
+}
+
+const S21BatchKernels kGenericKernels = {S21Isa::kScalar, DeterminantGeneric,
+                                         InverseGeneric, MultiplyGeneric};
+
+#ifdef S21_MATRIX_X86
+
+__attribute__((target("avx2"))) void DeterminantAvx2(int n, const double *a,
+                                                     int stride, int first,
+                                                     int last, double *det) {
+  DeterminantLanes(n, a, stride, first, last, det);
+}
+
+__attribute__((target("avx2"))) void InverseAvx2(int n, const double *a,
+                                                 int stride, int first,
+                                                 int last, double *inverse,
+                                                 std::uint8_t *singular) {
+  InverseLanes(n, a, stride, first, last, inverse, singular);
+}
+
+__attribute__((target("avx2"))) void MultiplyAvx2(int m, int k, int n,
+                                                  const double *a,
+                                                  const double *b, int stride,
+                                                  int first, int last,
+                                                  double *c) {
+  MultiplyLanes(m, k, n, a, b, stride, first, last, c);
+}
+
+__attribute__((target("avx512f"))) void DeterminantAvx512(
+    int n, const double *a, int stride, int first, int last, double *det) {
+  DeterminantLanes(n, a, stride, first, last, det);
+}
+
+__attribute__((target("avx512f"))) void InverseAvx512(
+    int n, const double *a, int stride, int first, int last, double *inverse,
+    std::uint8_t *singular) {
+  InverseLanes(n, a, stride, first, last, inverse, singular);
+}
+
+__attribute__((target("avx512f"))) void MultiplyAvx512(
+    int m, int k, int n, const double *a, const double *b, int stride,
+    int first, int last, double *c) {
+  MultiplyLanes(m, k, n, a, b, stride, first, last, c);
+}
+
+const S21BatchKernels kAvx2Kernels = {S21Isa::kAvx2, DeterminantAvx2,
+                                      InverseAvx2, MultiplyAvx2};
+const S21BatchKernels kAvx512Kernels = {S21Isa::kAvx512, DeterminantAvx512,
+                                        InverseAvx512, MultiplyAvx512};
+
+#endif
+
+// делит блоки дорожек [0, stride) между потоками; work - оценка flop на
+// одну матрицу
+void ForEachLaneBlock(int stride, double work,
+                      const std::function<void(int, int)> &body) {
+  int blocks = stride / kLanes;
+  S21ParallelFor(0, blocks, work * stride,
+                 [&body](int first, int last) {
+                   body(first * kLanes, last * kLanes);
+                 });
+}
+
+}  // namespace
+
+// SSE2 и скалярный набор используют общую версию: на x86-64 она и так
+// собирается в инструкции SSE2
+const S21BatchKernels *S21BatchKernelsFor(S21Isa isa) {
+  if (S21KernelsFor(isa) == nullptr) {
+    return nullptr;
+  }
+  switch (isa) {
+#ifdef S21_MATRIX_X86
+    case S21Isa::kAvx2:
+      return &kAvx2Kernels;
+    case S21Isa::kAvx512:
+      return &kAvx512Kernels;
+#endif
+    default:
+      return &kGenericKernels;
+  }
+}
+
+const S21BatchKernels &S21ActiveBatchKernels() {
+  static const S21BatchKernels &kernels =
+      *S21BatchKernelsFor(S21ActiveKernels().isa);
+  return kernels;
+}
+
+S21MatrixBatch::S21MatrixBatch()
+    : count_(0),
+      rows_(0),
+      cols_(0),
+      stride_(0),
+      data_(nullptr),
+      allocator_(nullptr) {}
+
+S21MatrixBatch::S21MatrixBatch(int count, int rows, int cols)
+    : S21MatrixBatch() {
+  if (count < 0 || rows < 1 || cols < 1) {
+    throw std::invalid_argument("Invalid batch size");
+  }
+  Allocate(count, rows, cols);
+  std::fill_n(data_, Size(), 0.0);
+}
+
+S21MatrixBatch::S21MatrixBatch(const S21MatrixBatch &other)
+    : S21MatrixBatch() {
+  if (other.data_ != nullptr) {
+    Allocate(other.count_, other.rows_, other.cols_);
+    std::copy_n(other.data_, Size(), data_);
+  }
+}
+
+S21MatrixBatch::S21MatrixBatch(S21MatrixBatch &&other) noexcept
+    : S21MatrixBatch() {
+  *this = std::move(other);
+}
+
+S21MatrixBatch &S21MatrixBatch::operator=(const S21MatrixBatch &other) {
+  if (this != &other) {
+    *this = S21MatrixBatch(other);
+  }
+  return *this;
+}
+
+S21MatrixBatch &S21MatrixBatch::operator=(S21MatrixBatch &&other) noexcept {
+  std::swap(count_, other.count_);
+  std::swap(rows_, other.rows_);
+  std::swap(cols_, other.cols_);
+  std::swap(stride_, other.stride_);
+  std::swap(data_, other.data_);
+  std::swap(allocator_, other.allocator_);
+  return *this;
+}
+
+S21MatrixBatch::~S21MatrixBatch() { Free(); }
+
+int S21MatrixBatch::Count() const { return count_; }
+
+int S21MatrixBatch::GetRows() const { return rows_; }
+
+int S21MatrixBatch::GetCols() const { return cols_; }
+
+double S21MatrixBatch::operator()(int index, int row, int col) const {
+  if (index < 0 || index >= count_ || row < 0 || row >= rows_ || col < 0 ||
+      col >= cols_) {
+    throw std::out_of_range("Invalid index, rows or/and columns!");
+  }
+  return Plane(row, col)[index];
+}
+
+double &S21MatrixBatch::operator()(int index, int row, int col) {
+  if (index < 0 || index >= count_ || row < 0 || row >= rows_ || col < 0 ||
+      col >= cols_) {
+    throw std::out_of_range("Invalid index, rows or/and columns!");
+  }
+  return Plane(row, col)[index];
+}
+
+double *S21MatrixBatch::Plane(int row, int col) {
+  return data_ + (static_cast<std::size_t>(row) * cols_ + col) * stride_;
+}
+
+const double *S21MatrixBatch::Plane(int row, int col) const {
+  return data_ + (static_cast<std::size_t>(row) * cols_ + col) * stride_;
+}
+
+int S21MatrixBatch::PlaneStride() const { return stride_; }
+
+S21Matrix S21MatrixBatch::Get(int index) const {
+  if (index < 0 || index >= count_) {
+    throw std::out_of_range("Invalid batch index");
+  }
+  S21Matrix result(rows_, cols_);
+  double *to = result.Data();
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      to[i * result.Stride() + j] = Plane(i, j)[index];
+    }
+  }
+  return result;
+}
+
+void S21MatrixBatch::Set(int index, const S21Matrix &matrix) {
+  if (index < 0 || index >= count_) {
+    throw std::out_of_range("Invalid batch index");
+  }
+  if (matrix.GetRows() != rows_ || matrix.GetCols() != cols_) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  const double *from = matrix.Data();
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      Plane(i, j)[index] = from[i * matrix.Stride() + j];
+    }
+  }
+}
+
+// плоскости обоих наборов лежат одинаково, поэтому поэлементные операции
+// проходят весь буфер обычными ядрами
+void S21MatrixBatch::SumBatch(const S21MatrixBatch &other) {
+  CheckSize(other);
+  std::size_t size = Size();
+  S21ParallelFor(0, static_cast<int>(size / kLanes), static_cast<double>(size),
+                 [&](int first, int last) {
+                   std::size_t from = static_cast<std::size_t>(first) * kLanes;
+                   S21ActiveKernels().add((last - first) * kLanes,
+                                          data_ + from, other.data_ + from);
+                 });
+}
+
+void S21MatrixBatch::SubBatch(const S21MatrixBatch &other) {
+  CheckSize(other);
+  std::size_t size = Size();
+  S21ParallelFor(0, static_cast<int>(size / kLanes), static_cast<double>(size),
+                 [&](int first, int last) {
+                   std::size_t from = static_cast<std::size_t>(first) * kLanes;
+                   S21ActiveKernels().sub((last - first) * kLanes,
+                                          data_ + from, other.data_ + from);
+                 });
+}
+
+void S21MatrixBatch::MulNumber(double num) {
+  std::size_t size = Size();
+  S21ParallelFor(0, static_cast<int>(size / kLanes), static_cast<double>(size),
+                 [&](int first, int last) {
+                   std::size_t from = static_cast<std::size_t>(first) * kLanes;
+                   S21ActiveKernels().scale((last - first) * kLanes,
+                                            data_ + from, num);
+                 });
+}
+
+S21MatrixBatch S21MatrixBatch::MulBatch(const S21MatrixBatch &other) const {
+  if (count_ != other.count_) {
+    throw std::invalid_argument("Different batch size");
+  }
+  if (cols_ != other.rows_) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number "
+        "of rows of the second matrix");
+  }
+  S21MatrixBatch result;
+  result.Allocate(count_, rows_, other.cols_);
+  const S21BatchKernels &kernels = S21ActiveBatchKernels();
+  ForEachLaneBlock(stride_, 2.0 * rows_ * cols_ * other.cols_,
+                   [&](int first, int last) {
+                     kernels.multiply(rows_, cols_, other.cols_, data_,
+                                      other.data_, stride_, first, last,
+                                      result.data_);
+                   });
+  return result;
+}
+
+// транспонирование только переставляет плоскости
+S21MatrixBatch S21MatrixBatch::Transpose() const {
+  S21MatrixBatch result;
+  if (data_ == nullptr) {
+    return result;
+  }
+  result.Allocate(count_, cols_, rows_);
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      std::copy_n(Plane(i, j), stride_, result.Plane(j, i));
+    }
+  }
+  return result;
+}
+
+std::vector<double> S21MatrixBatch::Determinant() const {
+  if (rows_ != cols_) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (count_ == 0) {
+    return {};
+  }
+  std::vector<double> result(stride_);
+  const S21BatchKernels &kernels = S21ActiveBatchKernels();
+  ForEachLaneBlock(stride_, 2.0 / 3.0 * rows_ * rows_ * rows_,
+                   [&](int first, int last) {
+                     kernels.determinant(rows_, data_, stride_, first, last,
+                                         result.data());
+                   });
+  result.resize(count_);
+  return result;
+}
+
+S21MatrixBatch S21MatrixBatch::InverseMatrix(
+    std::vector<std::uint8_t> *singular) const {
+  if (cols_ != rows_) {
+    throw std::invalid_argument("Matrix is not square");
+  }
+  S21MatrixBatch result;
+  if (count_ == 0) {
+    result.Allocate(0, rows_, cols_);
+    if (singular != nullptr) {
+      singular->clear();
+    }
+    return result;
+  }
+  result.Allocate(count_, rows_, cols_);
+  std::vector<std::uint8_t> flags(stride_);
+  const S21BatchKernels &kernels = S21ActiveBatchKernels();
+  ForEachLaneBlock(stride_, 2.0 * rows_ * rows_ * rows_,
+                   [&](int first, int last) {
+                     kernels.inverse(rows_, data_, stride_, first, last,
+                                     result.data_, flags.data());
+                   });
+  if (singular != nullptr) {
+    flags.resize(count_);
+    *singular = std::move(flags);
+  }
+  return result;
+}
+
+void S21MatrixBatch::Allocate(int count, int rows, int cols) {
+  Free();
+  count_ = count;
+  rows_ = rows;
+  cols_ = cols;
+  stride_ = (count + kLanes - 1) / kLanes * kLanes;
+  S21Allocator &allocator = S21CurrentAllocator();
+  data_ = static_cast<double *>(
+      allocator.Allocate(std::max<std::size_t>(Size(), 1) * sizeof(double)));
+  allocator_ = &allocator;
+}
+
+void S21MatrixBatch::Free() {
+  if (data_ != nullptr) {
+    allocator_->Deallocate(
+        data_, std::max<std::size_t>(Size(), 1) * sizeof(double));
+    data_ = nullptr;
+    allocator_ = nullptr;
+  }
+  count_ = rows_ = cols_ = stride_ = 0;
+}
+
+std::size_t S21MatrixBatch::Size() const {
+  return static_cast<std::size_t>(rows_) * cols_ * stride_;
+}
+
+void S21MatrixBatch::CheckSize(const S21MatrixBatch &other) const {
+  if (count_ != other.count_ || rows_ != other.rows_ ||
+      cols_ != other.cols_) {
+    throw std::invalid_argument("Different matrix size");
+  }
+}
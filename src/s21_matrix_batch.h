@@ -0,0 +1,74 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_BATCH_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_BATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Набор из Count() матриц одного размера rows x cols в раскладке
+// "структура массивов": элемент (i, j) всех матриц лежит подряд в своей
+// плоскости, Plane(i, j)[b] - элемент матрицы b. Пакетные операции
+// обрабатывают по матрице в каждой дорожке SIMD-регистра и делят набор
+// между потоками по текущей S21ExecutionPolicy, так что накладные расходы
+// на вызов приходятся на весь набор, а не на каждую матрицу.
+//
+// Плоскости дополнены до кратного kLanes числа матриц; дорожки
+// дополнения участвуют в вычислениях, но их значения не определены.
+class S21MatrixBatch {
+ public:
+  // ширина блока дорожек, с которой работают ядра
+  static constexpr int kLanes = 8;
+
+  S21MatrixBatch();
+  // count нулевых матриц rows x cols
+  S21MatrixBatch(int count, int rows, int cols);
+  S21MatrixBatch(const S21MatrixBatch &other);
+  S21MatrixBatch(S21MatrixBatch &&other) noexcept;
+  S21MatrixBatch &operator=(const S21MatrixBatch &other);
+  S21MatrixBatch &operator=(S21MatrixBatch &&other) noexcept;
+  ~S21MatrixBatch();
+
+  int Count() const;
+  int GetRows() const;
+  int GetCols() const;
+  double operator()(int index, int row, int col) const;
+  double &operator()(int index, int row, int col);
+  // плоскость элемента (row, col): PlaneStride() значений подряд
+  double *Plane(int row, int col);
+  const double *Plane(int row, int col) const;
+  int PlaneStride() const;
+
+  S21Matrix Get(int index) const;
+  void Set(int index, const S21Matrix &matrix);
+
+  void SumBatch(const S21MatrixBatch &other);
+  void SubBatch(const S21MatrixBatch &other);
+  void MulNumber(double num);
+  // попарные произведения: результат[b] = this[b] * other[b]
+  S21MatrixBatch MulBatch(const S21MatrixBatch &other) const;
+  S21MatrixBatch Transpose() const;
+  // Определители всех матриц: до 4 x 4 - явные формулы, больше -
+  // исключение Гаусса с выбором ведущего элемента в каждой дорожке.
+  std::vector<double> Determinant() const;
+  // Обратные матрицы. Вырожденные (ведущий элемент или определитель ниже
+  // порога S21LU::SingularThreshold) не бросают исключение: если передан
+  // singular, в singular[b] пишется 1, а матрица b результата заполняется
+  // NaN.
+  S21MatrixBatch InverseMatrix(std::vector<std::uint8_t> *singular = nullptr)
+      const;
+
+ private:
+  int count_, rows_, cols_;
+  // число матриц, округленное вверх до kLanes
+  int stride_;
+  double *data_;
+  S21Allocator *allocator_;
+  void Allocate(int count, int rows, int cols);
+  void Free();
+  std::size_t Size() const;
+  void CheckSize(const S21MatrixBatch &other) const;
+};
+
+#endif
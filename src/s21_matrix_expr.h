@@ -0,0 +1,368 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_EXPR_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_EXPR_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_matrix_oop.h"
+
+// Ленивые выражения над S21BasicMatrix. Операторы +, - и умножение на
+// число не вычисляют результат сразу, а строят дерево выражения; размеры
+// операндов проверяются в момент построения. Цепочка вида A + B - C * 2.0
+// вычисляется одним проходом по памяти при присваивании в матрицу (или
+// при создании матрицы из выражения), без промежуточных матриц.
+//
+// Выражение хранит указатели на данные операндов, поэтому его нельзя
+// сохранять (например, в auto) дольше, чем живут сами матрицы.
+//
+// Каждый узел умеет сказать, может ли он прочитать элемент из диапазона
+// памяти [first, last) не по тому же индексу, по которому пишется
+// результат (MayAlias). Матрица читается только по тому же индексу, а вид
+// (транспонированный, сдвинутый блок) - по любому.
+
+class S21MatrixExprTag {};
+// отличает виды (s21_matrix_view.h) от прочих выражений
+class S21MatrixViewTag {};
+
+template <typename T>
+constexpr bool kS21IsBasicMatrix = false;
+template <typename T>
+constexpr bool kS21IsBasicMatrix<S21BasicMatrix<T>> = true;
+
+// S21BasicMatrix или выражение над матрицами
+template <typename T>
+constexpr bool kS21IsMatrixOperand =
+    kS21IsBasicMatrix<T> || std::is_base_of_v<S21MatrixExprTag, T>;
+
+// тип элементов операнда; для прочих типов type не определен
+template <typename T, typename = void>
+struct S21OperandScalarOf {};
+
+template <typename T>
+struct S21OperandScalarOf<T, std::enable_if_t<kS21IsBasicMatrix<T>>> {
+  using type = typename T::value_type;
+};
+
+template <typename T>
+struct S21OperandScalarOf<
+    T, std::enable_if_t<std::is_base_of_v<S21MatrixExprTag, T>>> {
+  using type = std::decay_t<decltype(std::declval<const T &>().At(0))>;
+};
+
+template <typename T>
+using S21OperandScalar = typename S21OperandScalarOf<T>::type;
+
+template <typename E>
+class S21MatrixExpr : public S21MatrixExprTag {
+ public:
+  const E &Self() const { return static_cast<const E &>(*this); }
+  int GetRows() const { return Self().GetRows(); }
+  int GetCols() const { return Self().GetCols(); }
+  auto operator()(int row, int col) const {
+    if (row < 0 || col < 0 || col >= GetCols() || row >= GetRows()) {
+      throw std::out_of_range("Invalid rows or/and columns!");
+    }
+    return Self().At(static_cast<std::size_t>(row) * GetCols() + col);
+  }
+  auto Evaluate() const {
+    return S21BasicMatrix<S21OperandScalar<E>>(*this);
+  }
+};
+
+// лист выражения - ссылка на данные готовой матрицы
+template <typename T>
+class S21MatrixRef : public S21MatrixExpr<S21MatrixRef<T>> {
+ public:
+  explicit S21MatrixRef(const S21BasicMatrix<T> &matrix)
+      : rows_(matrix.GetRows()),
+        cols_(matrix.GetCols()),
+        data_(matrix.Data()) {}
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  T At(std::size_t k) const { return data_[k]; }
+  bool MayAlias(const void *, const void *) const { return false; }
+
+ private:
+  int rows_, cols_;
+  const T *data_;
+};
+
+struct S21AddOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return lhs + rhs;
+  }
+};
+
+struct S21SubOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return lhs - rhs;
+  }
+};
+
+template <typename L, typename R, typename Op>
+class S21BinaryExpr : public S21MatrixExpr<S21BinaryExpr<L, R, Op>> {
+ public:
+  S21BinaryExpr(const L &lhs, const R &rhs) : lhs_(lhs), rhs_(rhs) {
+    if (lhs.GetRows() != rhs.GetRows() || lhs.GetCols() != rhs.GetCols()) {
+      throw std::invalid_argument("Different matrix size");
+    }
+  }
+  int GetRows() const { return lhs_.GetRows(); }
+  int GetCols() const { return lhs_.GetCols(); }
+  auto At(std::size_t k) const { return Op::Apply(lhs_.At(k), rhs_.At(k)); }
+  bool MayAlias(const void *first, const void *last) const {
+    return lhs_.MayAlias(first, last) || rhs_.MayAlias(first, last);
+  }
+
+ private:
+  L lhs_;
+  R rhs_;
+};
+
+template <typename E>
+class S21ScaleExpr : public S21MatrixExpr<S21ScaleExpr<E>> {
+ public:
+  using Scalar = S21OperandScalar<E>;
+  S21ScaleExpr(const E &expr, Scalar num) : expr_(expr), num_(num) {}
+  int GetRows() const { return expr_.GetRows(); }
+  int GetCols() const { return expr_.GetCols(); }
+  Scalar At(std::size_t k) const { return expr_.At(k) * num_; }
+  bool MayAlias(const void *first, const void *last) const {
+    return expr_.MayAlias(first, last);
+  }
+
+ private:
+  E expr_;
+  Scalar num_;
+};
+
+// оба операнда - матрицы или выражения с одним типом элементов; матрицы с
+// разными типами сначала приводятся явно (конструктор S21BasicMatrix<U>)
+template <typename L, typename R, typename = void>
+constexpr bool kS21IsMatrixOperands = false;
+template <typename L, typename R>
+constexpr bool kS21IsMatrixOperands<
+    L, R, std::enable_if_t<kS21IsMatrixOperand<L> && kS21IsMatrixOperand<R>>> =
+    std::is_same_v<S21OperandScalar<L>, S21OperandScalar<R>>;
+
+// хотя бы один операнд - вид на матрицу; для таких операндов умножение и
+// сравнение работают прямо по данным (см. s21_matrix_view.h)
+template <typename L, typename R>
+constexpr bool kS21IsViewOperands =
+    kS21IsMatrixOperands<L, R> && (std::is_base_of_v<S21MatrixViewTag, L> ||
+                                   std::is_base_of_v<S21MatrixViewTag, R>);
+
+// хотя бы один операнд - выражение, а не готовая матрица (и не вид)
+template <typename L, typename R>
+constexpr bool kS21IsMixedOperands =
+    kS21IsMatrixOperands<L, R> &&
+    !(kS21IsBasicMatrix<L> && kS21IsBasicMatrix<R>) &&
+    !kS21IsViewOperands<L, R>;
+
+// узел дерева, которым операнд хранится внутри выражения
+template <typename T>
+using S21ExprNode =
+    std::conditional_t<kS21IsBasicMatrix<T>,
+                       S21MatrixRef<S21OperandScalar<T>>, T>;
+
+template <typename T>
+S21MatrixRef<T> S21AsExpr(const S21BasicMatrix<T> &matrix) {
+  return S21MatrixRef<T>(matrix);
+}
+
+template <typename E>
+const E &S21AsExpr(const S21MatrixExpr<E> &expr) {
+  return expr.Self();
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<kS21IsMatrixOperands<L, R>>>
+S21BinaryExpr<S21ExprNode<L>, S21ExprNode<R>, S21AddOp> operator+(
+    const L &lhs, const R &rhs) {
+  return {S21AsExpr(lhs), S21AsExpr(rhs)};
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<kS21IsMatrixOperands<L, R>>>
+S21BinaryExpr<S21ExprNode<L>, S21ExprNode<R>, S21SubOp> operator-(
+    const L &lhs, const R &rhs) {
+  return {S21AsExpr(lhs), S21AsExpr(rhs)};
+}
+
+// тип числа берется из операнда, поэтому A * 2 работает и для double, и для
+// целых матриц
+template <typename E, typename = std::enable_if_t<kS21IsMatrixOperand<E>>>
+S21ScaleExpr<S21ExprNode<E>> operator*(const E &expr,
+                                       S21OperandScalar<E> num) {
+  return {S21AsExpr(expr), num};
+}
+
+// умножение матриц не поэлементное, поэтому выражение сначала вычисляется
+template <typename L, typename R,
+          typename = std::enable_if_t<kS21IsMixedOperands<L, R>>>
+S21BasicMatrix<S21OperandScalar<L>> operator*(const L &lhs, const R &rhs) {
+  using Matrix = S21BasicMatrix<S21OperandScalar<L>>;
+  Matrix result(lhs);
+  result.MulMatrix(Matrix(rhs));
+  return result;
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<kS21IsMixedOperands<L, R>>>
+bool operator==(const L &lhs, const R &rhs) {
+  using Matrix = S21BasicMatrix<S21OperandScalar<L>>;
+  return Matrix(lhs).EqMatrix(Matrix(rhs));
+}
+
+// Если операнд - временная матрица, ленивое выражение не строится:
+// результат сразу пишется в буфер временной матрицы, и она возвращается.
+// Так std::move(A) + B и (A * B) + C не выделяют память под результат.
+template <typename T>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T> &&lhs,
+                            const S21BasicMatrix<T> &rhs);
+template <typename T>
+S21BasicMatrix<T> operator+(const S21BasicMatrix<T> &lhs,
+                            S21BasicMatrix<T> &&rhs);
+template <typename T>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T> &&lhs, S21BasicMatrix<T> &&rhs);
+template <typename T>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T> &&lhs,
+                            const S21BasicMatrix<T> &rhs);
+template <typename T>
+S21BasicMatrix<T> operator-(const S21BasicMatrix<T> &lhs,
+                            S21BasicMatrix<T> &&rhs);
+template <typename T>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T> &&lhs, S21BasicMatrix<T> &&rhs);
+template <typename T>
+S21BasicMatrix<T> operator*(S21BasicMatrix<T> &&lhs,
+                            S21OperandScalar<S21BasicMatrix<T>> num);
+
+// выражение принимается как const E &, а не как ссылка на базовый класс,
+// иначе такие перегрузки конкурировали бы с общими шаблонами выше
+template <typename T, typename E>
+using S21EnableIfExpr =
+    std::enable_if_t<std::is_base_of_v<S21MatrixExprTag, E> &&
+                     kS21IsMatrixOperands<S21BasicMatrix<T>, E>>;
+
+template <typename T, typename E, typename = S21EnableIfExpr<T, E>>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T> &&lhs, const E &rhs) {
+  lhs += rhs;
+  return std::move(lhs);
+}
+
+template <typename T, typename E, typename = S21EnableIfExpr<T, E>>
+S21BasicMatrix<T> operator+(const E &lhs, S21BasicMatrix<T> &&rhs) {
+  rhs += lhs;
+  return std::move(rhs);
+}
+
+template <typename T, typename E, typename = S21EnableIfExpr<T, E>>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T> &&lhs, const E &rhs) {
+  lhs -= rhs;
+  return std::move(lhs);
+}
+
+template <typename T, typename E, typename = S21EnableIfExpr<T, E>>
+S21BasicMatrix<T> operator-(const E &lhs, S21BasicMatrix<T> &&rhs) {
+  rhs = lhs - rhs;
+  return std::move(rhs);
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>::S21BasicMatrix(const S21MatrixExpr<E> &expr)
+    : rows_(expr.GetRows()),
+      cols_(expr.GetCols()),
+      data_(nullptr),
+      capacity_(0),
+      allocator_(nullptr),
+      storage_(S21Storage::kOwned),
+      rows_view_(nullptr) {
+  AllocateMatrix();
+  Apply(expr.Self(), [](T &dst, T value) { dst = value; });
+}
+
+// При совпадении размеров результат пишется прямо в буфер матрицы. Сама
+// матрица может входить в выражение: она читается по тому же индексу, что
+// и пишется. Вид на ее данные (A = A.View().Transposed() + B) читал бы уже
+// перезаписанные элементы, поэтому такое выражение вычисляется во
+// временную матрицу.
+template <typename T>
+template <typename E>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator=(
+    const S21MatrixExpr<E> &expr) {
+  if (data_ != nullptr && rows_ == expr.GetRows() &&
+      cols_ == expr.GetCols() && storage_ != S21Storage::kMappedReadOnly &&
+      !ExprMayAlias(expr.Self())) {
+    Apply(expr.Self(), [](T &dst, T value) { dst = value; });
+  } else {
+    *this = S21BasicMatrix(expr);
+  }
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator+=(
+    const S21MatrixExpr<E> &expr) {
+  if (rows_ != expr.GetRows() || cols_ != expr.GetCols()) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  if (ExprMayAlias(expr.Self())) {
+    return *this += S21BasicMatrix(expr);
+  }
+  Apply(expr.Self(), [](T &dst, T value) { dst += value; });
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T> &S21BasicMatrix<T>::operator-=(
+    const S21MatrixExpr<E> &expr) {
+  if (rows_ != expr.GetRows() || cols_ != expr.GetCols()) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  if (ExprMayAlias(expr.Self())) {
+    return *this -= S21BasicMatrix(expr);
+  }
+  Apply(expr.Self(), [](T &dst, T value) { dst -= value; });
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+bool S21BasicMatrix<T>::ExprMayAlias(const E &expr) const {
+  return data_ != nullptr &&
+         expr.MayAlias(data_, data_ + static_cast<std::size_t>(rows_) *
+                                          Stride());
+}
+
+// один проход по буферу: store(data_[k], expr.At(k)) для всех элементов
+template <typename T>
+template <typename E, typename Store>
+void S21BasicMatrix<T>::Apply(const E &expr, Store store) {
+  if (storage_ == S21Storage::kMappedReadOnly) {
+    // выражение может читать само отображение, поэтому оно снимается
+    // только после вычисления в копию
+    S21BasicMatrix copy(*this);
+    copy.Apply(expr, store);
+    *this = std::move(copy);
+    return;
+  }
+  S21_PROFILE(S21Operation::kExpression, rows_, cols_, 0.0,
+              double(sizeof(T)) * rows_ * cols_);
+  DropCache();
+  T *data = data_;
+  ForEachBlock(static_cast<std::size_t>(rows_) * cols_,
+               [data, &expr, store](std::size_t from, std::size_t count) {
+                 for (std::size_t k = from; k < from + count; k++) {
+                   store(data[k], expr.At(k));
+                 }
+               });
+}
+
+#endif
@@ -0,0 +1,379 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "s21_matrix_oop.h"
+
+namespace {
+
+constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+[[noreturn]] void ThrowSystemError(const std::string &path) {
+  throw std::system_error(errno, std::generic_category(), path);
+}
+
+std::uint32_t Swap32(std::uint32_t value) { return __builtin_bswap32(value); }
+
+std::uint64_t Swap64(std::uint64_t value) { return __builtin_bswap64(value); }
+
+// Байт значения в элементе: у 80-битного long double x87 остальные байты
+// - выравнивание с произвольным содержимым.
+template <typename T>
+constexpr std::size_t kValueBytes =
+    std::is_floating_point<T>::value && std::numeric_limits<T>::digits == 64
+        ? 10
+        : sizeof(T);
+
+// Значение элемента как 64-битное слово (или два для long double) в
+// порядке байт машины; swapped - байты элемента записаны наоборот.
+// Long double перестановкой байт не читается, см. S21DType::kLongDouble.
+template <typename T, typename Body>
+void ForEachWord(const T &element, bool swapped, Body body) {
+  if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &element, sizeof(bits));
+    body(swapped ? Swap32(bits) : bits);
+  } else if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &element, sizeof(bits));
+    body(swapped ? Swap64(bits) : bits);
+  } else {
+    for (std::size_t offset = 0; offset < kValueBytes<T>; offset += 8) {
+      std::uint64_t bits = 0;
+      std::memcpy(&bits, reinterpret_cast<const char *>(&element) + offset,
+                  std::min<std::size_t>(8, kValueBytes<T> - offset));
+      body(bits);
+    }
+  }
+}
+
+template <typename T>
+void SwapElements(T *data, std::size_t count) {
+  static_assert(sizeof(T) == 4 || sizeof(T) == 8, "no byte swap for T");
+  for (std::size_t k = 0; k < count; k++) {
+    ForEachWord(data[k], true, [&](auto bits) {
+      std::memcpy(data + k, &bits, sizeof(bits));
+    });
+  }
+}
+
+// тип элементов файла должен совпадать с типом матрицы
+template <typename T>
+void CheckFileType(const std::string &path, const S21MatrixFileHeader &header,
+                   bool swapped) {
+  if (header.dtype != static_cast<std::uint32_t>(S21MatrixTraits<T>::kDType)) {
+    throw std::runtime_error(path + ": element type differs");
+  }
+  if (swapped && header.dtype == static_cast<std::uint32_t>(
+                                     S21DType::kLongDouble)) {
+    throw std::runtime_error(path + ": byte order differs");
+  }
+}
+
+// Отображение файла, которое матрица освобождает через свой распределитель:
+// Deallocate снимает отображение целиком и уничтожает объект. Новых блоков
+// не выдает.
+class S21FileMapping : public S21Allocator {
+ public:
+  S21FileMapping(int fd, std::size_t length, int protection,
+                 const std::string &path)
+      : base_(::mmap(nullptr, length, protection, MAP_PRIVATE, fd, 0)),
+        length_(length) {
+    if (base_ == MAP_FAILED) {
+      ThrowSystemError(path);
+    }
+  }
+
+  char *Base() const { return static_cast<char *>(base_); }
+
+  void *Allocate(std::size_t) override { throw std::bad_alloc(); }
+
+  void Deallocate(void *, std::size_t) override {
+    ::munmap(base_, length_);
+    delete this;
+  }
+
+ private:
+  void *base_;
+  std::size_t length_;
+};
+
+}  // namespace
+
+S21File::S21File(const std::string &path, int flags)
+    : fd_(::open(path.c_str(), flags, 0644)), path_(path) {
+  if (fd_ < 0) {
+    ThrowSystemError(path_);
+  }
+}
+
+S21File::~S21File() { ::close(fd_); }
+
+int S21File::Get() const { return fd_; }
+
+const std::string &S21File::Path() const { return path_; }
+
+void S21File::ReadAt(void *buffer, std::size_t bytes,
+                     std::uint64_t offset) const {
+  char *to = static_cast<char *>(buffer);
+  while (bytes > 0) {
+    ssize_t done = ::pread(fd_, to, bytes, static_cast<off_t>(offset));
+    if (done < 0 && errno == EINTR) {
+      continue;
+    }
+    if (done < 0) {
+      ThrowSystemError(path_);
+    }
+    if (done == 0) {
+      throw std::runtime_error(path_ + ": unexpected end of file");
+    }
+    to += done;
+    bytes -= static_cast<std::size_t>(done);
+    offset += static_cast<std::uint64_t>(done);
+  }
+}
+
+void S21File::WriteAt(const void *buffer, std::size_t bytes,
+                      std::uint64_t offset) const {
+  const char *from = static_cast<const char *>(buffer);
+  while (bytes > 0) {
+    ssize_t done = ::pwrite(fd_, from, bytes, static_cast<off_t>(offset));
+    if (done < 0 && errno == EINTR) {
+      continue;
+    }
+    if (done < 0) {
+      ThrowSystemError(path_);
+    }
+    from += done;
+    bytes -= static_cast<std::size_t>(done);
+    offset += static_cast<std::uint64_t>(done);
+  }
+}
+
+std::size_t S21DTypeBytes(std::uint32_t dtype) {
+  switch (static_cast<S21DType>(dtype)) {
+    case S21DType::kFloat64:
+      return sizeof(double);
+    case S21DType::kFloat32:
+      return sizeof(float);
+    case S21DType::kInt64:
+      return sizeof(std::int64_t);
+    case S21DType::kLongDouble:
+      return sizeof(long double);
+  }
+  return 0;
+}
+
+template <typename T>
+std::uint64_t S21MatrixChecksum(const T *data, std::size_t count,
+                                bool swapped, std::uint64_t seed) {
+  std::uint64_t hash = seed;
+  for (std::size_t k = 0; k < count; k++) {
+    ForEachWord(data[k], swapped, [&hash](std::uint64_t word) {
+      hash = (hash ^ word) * kFnvPrime;
+      // умножение переносит влияние бит только вверх, сдвиг возвращает вниз
+      hash ^= hash >> 32;
+    });
+  }
+  return hash;
+}
+
+S21MatrixFileHeader S21MakeMatrixHeader(int rows, int cols,
+                                        std::uint64_t checksum,
+                                        S21DType dtype) {
+  S21MatrixFileHeader header{};
+  std::memcpy(header.magic, kS21MatrixMagic, sizeof(header.magic));
+  header.version = kS21MatrixFileVersion;
+  header.byte_order = kS21ByteOrderMark;
+  header.dtype = static_cast<std::uint32_t>(dtype);
+  header.header_bytes = sizeof(S21MatrixFileHeader);
+  header.rows = static_cast<std::uint64_t>(rows);
+  header.cols = static_cast<std::uint64_t>(cols);
+  header.checksum = checksum;
+  return header;
+}
+
+S21MatrixFileHeader S21ReadMatrixHeader(const S21File &file, bool *swapped) {
+  const std::string &path = file.Path();
+  struct stat info;
+  if (::fstat(file.Get(), &info) != 0) {
+    ThrowSystemError(path);
+  }
+  std::uint64_t file_bytes = static_cast<std::uint64_t>(info.st_size);
+  if (file_bytes < sizeof(S21MatrixFileHeader)) {
+    throw std::runtime_error(path + ": not a matrix file");
+  }
+  S21MatrixFileHeader header;
+  file.ReadAt(&header, sizeof(header), 0);
+  if (std::memcmp(header.magic, kS21MatrixMagic, sizeof(header.magic)) != 0) {
+    throw std::runtime_error(path + ": not a matrix file");
+  }
+  *swapped = header.byte_order != kS21ByteOrderMark;
+  if (*swapped) {
+    if (Swap32(header.byte_order) != kS21ByteOrderMark) {
+      throw std::runtime_error(path + ": unknown byte order");
+    }
+    header.version = Swap32(header.version);
+    header.byte_order = kS21ByteOrderMark;
+    header.dtype = Swap32(header.dtype);
+    header.header_bytes = Swap32(header.header_bytes);
+    header.rows = Swap64(header.rows);
+    header.cols = Swap64(header.cols);
+    header.checksum = Swap64(header.checksum);
+  }
+  if (header.version != kS21MatrixFileVersion) {
+    throw std::runtime_error(path + ": unsupported format version");
+  }
+  std::size_t element_bytes = S21DTypeBytes(header.dtype);
+  if (element_bytes == 0) {
+    throw std::runtime_error(path + ": unsupported element type");
+  }
+  if (header.header_bytes != sizeof(S21MatrixFileHeader) ||
+      header.rows > static_cast<std::uint64_t>(
+                        std::numeric_limits<int>::max()) ||
+      header.cols > static_cast<std::uint64_t>(
+                        std::numeric_limits<int>::max()) ||
+      (header.rows == 0) != (header.cols == 0)) {
+    throw std::runtime_error(path + ": corrupted header");
+  }
+  // Размер сверяется делением: произведение rows * cols * element_bytes
+  // у испорченного заголовка переполняет и 64 бита. После первой проверки
+  // оно не больше payload и считается точно.
+  std::uint64_t payload = file_bytes - header.header_bytes;
+  if (header.rows != 0 &&
+      header.rows > payload / element_bytes / header.cols) {
+    throw std::runtime_error(path + ": file size does not match the header");
+  }
+  std::uint64_t count = header.rows * header.cols;
+  if (count * element_bytes != payload) {
+    throw std::runtime_error(path + ": file size does not match the header");
+  }
+  // смещения элементов в матрице - std::ptrdiff_t
+  if (count > static_cast<std::uint64_t>(
+                  std::numeric_limits<std::ptrdiff_t>::max()) /
+                  element_bytes) {
+    throw std::runtime_error(path + ": matrix is too large");
+  }
+  return header;
+}
+
+// Файл пишется заголовком и одним проходом по буферу; контрольная сумма
+// считается заранее, чтобы заголовок не приходилось дописывать. У long
+// double байты выравнивания не определены, поэтому они обнуляются в копии.
+template <typename T>
+void S21BasicMatrix<T>::Save(const std::string &path) const {
+  std::size_t count = static_cast<std::size_t>(rows_) * cols_;
+  S21MatrixFileHeader header =
+      S21MakeMatrixHeader(rows_, cols_, S21MatrixChecksum(data_, count),
+                          S21MatrixTraits<T>::kDType);
+  S21File file(path, O_WRONLY | O_CREAT | O_TRUNC);
+  file.WriteAt(&header, sizeof(header), 0);
+  if constexpr (kValueBytes<T> != sizeof(T)) {
+    std::vector<unsigned char> bytes(count * sizeof(T));
+    for (std::size_t k = 0; k < count; k++) {
+      std::memcpy(bytes.data() + k * sizeof(T), data_ + k, kValueBytes<T>);
+    }
+    file.WriteAt(bytes.data(), bytes.size(), sizeof(header));
+  } else {
+    file.WriteAt(data_, count * sizeof(T), sizeof(header));
+  }
+}
+
+// чтение в буфер из текущего распределителя со сверкой контрольной суммы
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Load(const std::string &path) {
+  S21File file(path, O_RDONLY);
+  bool swapped = false;
+  S21MatrixFileHeader header = S21ReadMatrixHeader(file, &swapped);
+  CheckFileType<T>(path, header, swapped);
+  S21BasicMatrix result;
+  if (header.rows == 0) {
+    return result;
+  }
+  result.rows_ = static_cast<int>(header.rows);
+  result.cols_ = static_cast<int>(header.cols);
+  result.AllocateMatrix();
+  std::size_t count = static_cast<std::size_t>(result.rows_) * result.cols_;
+  file.ReadAt(result.data_, count * sizeof(T), header.header_bytes);
+  if (S21MatrixChecksum(result.data_, count, swapped) != header.checksum) {
+    throw std::runtime_error(path + ": checksum mismatch");
+  }
+  if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+    if (swapped) {
+      SwapElements(result.data_, count);
+    }
+  }
+  return result;
+}
+
+// Отображение всего файла. Проверяется только заголовок: сверка
+// контрольной суммы прочитала бы все страницы, для нее есть Load().
+// Файл с другим порядком байт отобразить нельзя.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::MapFile(const std::string &path,
+                                             S21MapMode mode) {
+  S21File file(path, O_RDONLY);
+  bool swapped = false;
+  S21MatrixFileHeader header = S21ReadMatrixHeader(file, &swapped);
+  CheckFileType<T>(path, header, false);
+  if (swapped) {
+    throw std::runtime_error(path + ": byte order differs, use Load()");
+  }
+  S21BasicMatrix result;
+  if (header.rows == 0) {
+    return result;
+  }
+  std::size_t count = static_cast<std::size_t>(header.rows) *
+                      static_cast<std::size_t>(header.cols);
+  std::size_t length = header.header_bytes + count * sizeof(T);
+  int protection = mode == S21MapMode::kReadOnly ? PROT_READ
+                                                 : PROT_READ | PROT_WRITE;
+  S21FileMapping *mapping =
+      new S21FileMapping(file.Get(), length, protection, path);
+  result.rows_ = static_cast<int>(header.rows);
+  result.cols_ = static_cast<int>(header.cols);
+  result.data_ =
+      reinterpret_cast<T *>(mapping->Base() + header.header_bytes);
+  result.capacity_ = count;
+  result.allocator_ = mapping;
+  result.storage_ = mode == S21MapMode::kReadOnly
+                        ? S21Storage::kMappedReadOnly
+                        : S21Storage::kMappedCopyOnWrite;
+  return result;
+}
+
+template <typename T>
+S21Storage S21BasicMatrix<T>::Storage() const {
+  return storage_;
+}
+
+// Перед первой записью в матрицу, отображенную только для чтения,
+// элементы копируются в обычный буфер, а отображение снимается.
+// Указатели и виды, полученные до этого, становятся недействительными.
+// Запомненное для Solve разложение сбрасывается при любой записи.
+template <typename T>
+void S21BasicMatrix<T>::MakeWritable() {
+  DropCache();
+  if (storage_ == S21Storage::kMappedReadOnly) {
+    *this = S21BasicMatrix(*this);
+  }
+}
+
+#define S21_INSTANTIATE_IO(T)                                               \
+  template std::uint64_t S21MatrixChecksum<T>(const T *, std::size_t, bool, \
+                                              std::uint64_t);               \
+  template void S21BasicMatrix<T>::Save(const std::string &) const;         \
+  template S21BasicMatrix<T> S21BasicMatrix<T>::Load(const std::string &);  \
+  template S21BasicMatrix<T> S21BasicMatrix<T>::MapFile(const std::string &, \
+                                                        S21MapMode);        \
+  template S21Storage S21BasicMatrix<T>::Storage() const;                   \
+  template void S21BasicMatrix<T>::MakeWritable();
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_IO)
+#undef S21_INSTANTIATE_IO
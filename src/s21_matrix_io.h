@@ -0,0 +1,101 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_IO_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_IO_H_
+
+// Двоичный формат матрицы: заголовок S21MatrixFileHeader (64 байта), за
+// ним элементы по строкам без промежутков. Заголовок и элементы пишутся в
+// порядке байт машины, который отмечен в byte_order; чтение на машине с
+// другим порядком переставляет байты. Благодаря размеру заголовка элементы
+// отображенного файла выровнены так же, как буфер обычной матрицы.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// как S21Matrix::MapFile отображает файл
+enum class S21MapMode {
+  kReadOnly,     // страницы только для чтения, запись отцепляет копию
+  kCopyOnWrite,  // записи попадают в частные копии страниц, файл не меняется
+};
+
+// откуда взят буфер элементов матрицы
+enum class S21Storage { kOwned, kMappedReadOnly, kMappedCopyOnWrite };
+
+// Тип элементов в файле. kLongDouble - long double машины автора,
+// sizeof(long double) байт на элемент; такой файл читается только там, где
+// long double устроен так же, и без перестановки байт.
+enum class S21DType : std::uint32_t {
+  kFloat64 = 1,
+  kFloat32 = 2,
+  kInt64 = 3,
+  kLongDouble = 4,
+};
+
+// размер элемента в файле или 0 для неизвестного типа
+std::size_t S21DTypeBytes(std::uint32_t dtype);
+
+struct S21MatrixFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;  // kS21ByteOrderMark в порядке байт автора
+  std::uint32_t dtype;       // S21DType
+  std::uint32_t header_bytes;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  // S21MatrixChecksum элементов в том виде, в каком они лежат в файле
+  std::uint64_t checksum;
+  std::uint8_t reserved[16];
+};
+
+static_assert(sizeof(S21MatrixFileHeader) == 64,
+              "the header must keep the elements 64-byte aligned");
+
+constexpr char kS21MatrixMagic[8] = "S21MTRX";
+constexpr std::uint32_t kS21MatrixFileVersion = 1;
+constexpr std::uint32_t kS21ByteOrderMark = 0x01020304;
+
+constexpr std::uint64_t kS21ChecksumSeed = 14695981039346656037ull;
+
+// FNV-1a по элементам: каждый элемент - одно 64-битное слово (float
+// дополняется нулями, у long double берутся только значащие байты, без
+// выравнивания). swapped - элементы записаны в обратном порядке байт,
+// контрольная сумма считается по их значениям в порядке автора. Для
+// подсчета по частям в seed передается сумма предыдущих элементов.
+// Определена для типов из S21_FOR_EACH_SCALAR.
+template <typename T>
+std::uint64_t S21MatrixChecksum(const T *data, std::size_t count,
+                                bool swapped = false,
+                                std::uint64_t seed = kS21ChecksumSeed);
+
+// заголовок файла матрицы rows x cols в порядке байт текущей машины
+S21MatrixFileHeader S21MakeMatrixHeader(
+    int rows, int cols, std::uint64_t checksum,
+    S21DType dtype = S21DType::kFloat64);
+
+// Открытый файл, закрывается в деструкторе. Ошибки открытия, чтения и
+// записи - std::system_error с путем к файлу.
+class S21File {
+ public:
+  S21File(const std::string &path, int flags);
+  ~S21File();
+  S21File(const S21File &) = delete;
+  S21File &operator=(const S21File &) = delete;
+
+  int Get() const;
+  const std::string &Path() const;
+  // pread/pwrite ровно bytes байт, с повтором после частичной передачи
+  void ReadAt(void *buffer, std::size_t bytes, std::uint64_t offset) const;
+  void WriteAt(const void *buffer, std::size_t bytes,
+               std::uint64_t offset) const;
+
+ private:
+  int fd_;
+  std::string path_;
+};
+
+// Читает и проверяет заголовок файла (магия, версия, известный тип,
+// размеры против длины файла) и приводит его поля к порядку байт машины.
+// swapped - порядок байт файла отличается от текущего. Неверный формат -
+// std::runtime_error. Совпадение типа с ожидаемым проверяет вызывающий.
+S21MatrixFileHeader S21ReadMatrixHeader(const S21File &file, bool *swapped);
+
+#endif
@@ -2,57 +2,417 @@
 #define CPP1_S21_MATRIXPLUS_S21_MATRIX_OOP_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
 #include <vector>
 
+#include "s21_allocator.h"
+#include "s21_async.h"
+#include "s21_matrix_io.h"
+#include "s21_profiler.h"
+#include "s21_thread_pool.h"
+
 constexpr double epsilon = 1e-7;
 
-class S21Matrix {
+// Свойства типа элементов матрицы: kTolerance - допуск поэлементного
+// сравнения (EqMatrix, ==), kDType - тип элементов в файле
+// (s21_matrix_io.h). Целые матрицы сравниваются точно, определитель у них
+// считается без деления (алгоритм Барейса), а LU, Solve и обращение
+// неунимодулярной матрицы бросают std::logic_error. Reduced - тип, в
+// котором SolveMixed строит разложение.
+template <typename T>
+struct S21MatrixTraits;
+
+template <>
+struct S21MatrixTraits<float> {
+  static constexpr float kTolerance = 1e-4f;
+  static constexpr S21DType kDType = S21DType::kFloat32;
+  using Reduced = float;
+};
+
+template <>
+struct S21MatrixTraits<double> {
+  static constexpr double kTolerance = epsilon;
+  static constexpr S21DType kDType = S21DType::kFloat64;
+  using Reduced = float;
+};
+
+template <>
+struct S21MatrixTraits<long double> {
+  static constexpr long double kTolerance = 1e-10L;
+  static constexpr S21DType kDType = S21DType::kLongDouble;
+  using Reduced = double;
+};
+
+template <>
+struct S21MatrixTraits<std::int64_t> {
+  static constexpr std::int64_t kTolerance = 0;
+  static constexpr S21DType kDType = S21DType::kInt64;
+  using Reduced = double;
+};
+
+// Типы элементов, для которых библиотека содержит явные инстанциации
+// шаблонов; X(T) раскрывается для каждого из них.
+#define S21_FOR_EACH_SCALAR(X) \
+  X(float)                     \
+  X(double)                    \
+  X(long double)               \
+  X(std::int64_t)
+
+template <typename T>
+class S21BasicMatrix;
+using S21Matrix = S21BasicMatrix<double>;
+template <typename T>
+class S21BasicLU;
+using S21LU = S21BasicLU<double>;
+template <typename T>
+class S21BasicCholesky;
+using S21Cholesky = S21BasicCholesky<double>;
+template <typename T>
+class S21BasicQR;
+using S21QR = S21BasicQR<double>;
+template <typename E>
+class S21MatrixExpr;
+template <typename Element>
+class S21BasicMatrixView;
+using S21MatrixView = S21BasicMatrixView<double>;
+using S21ConstMatrixView = S21BasicMatrixView<const double>;
+class S21SparseMatrix;
+
+// алгоритм умножения матриц: kAuto выбирает по размеру (см.
+// S21ExecutionPolicy::strassen_threshold)
+enum class S21MulAlgorithm { kAuto, kClassic, kStrassen };
+
+// набор инструкций, которым выполняются поэлементные операции
+enum class S21Isa { kScalar, kSse2, kAvx2, kAvx512 };
+
+// итог SolveMixed / InverseMixed
+struct S21RefinementReport {
+  // число шагов уточнения (0, если хватило первого решения)
+  int iterations = 0;
+  // max |B - A * X| по всем элементам итогового решения
+  double residual_norm = 0.0;
+  // max по столбцам ||b - A * x||_inf / (||A||_inf * ||x||_inf)
+  double backward_error = 0.0;
+  // уточнение не сошлось, и X получен разложением в полной точности
+  bool fell_back = false;
+};
+
+template <typename T>
+S21BasicMatrix<T> S21MulViews(
+    const S21BasicMatrixView<const T> &lhs,
+    const S21BasicMatrixView<const T> &rhs,
+    S21MulAlgorithm algorithm = S21MulAlgorithm::kAuto);
+
+// Плотная матрица с элементами типа T. Определения членов лежат в .cc и
+// явно инстанцированы для типов из S21_FOR_EACH_SCALAR; S21Matrix - версия
+// для double. Члены, связанные с разреженными матрицами, есть только у
+// S21Matrix.
+template <typename T>
+class S21BasicMatrix {
  public:
-  S21Matrix();
-  S21Matrix(int inrows, int incols);
-  S21Matrix(const S21Matrix &other);
-  S21Matrix(S21Matrix &&other);
-  ~S21Matrix();
-
-  S21Matrix operator+(const S21Matrix &other) const;
-  S21Matrix operator-(const S21Matrix &other) const;
-  S21Matrix operator*(const S21Matrix &other) const;
-  S21Matrix operator*(const double num) const;
-  S21Matrix &operator=(S21Matrix &&other) noexcept;
-  S21Matrix &operator=(const S21Matrix &other);
-  S21Matrix &operator+=(const S21Matrix &other);
-  S21Matrix &operator-=(const S21Matrix &other);
-  S21Matrix &operator*=(const S21Matrix &other);
-  S21Matrix &operator*=(double num);
-  bool operator==(const S21Matrix &other) const;
-  double operator()(int row, int col) const;
-  double &operator()(int row, int col);
-  bool EqMatrix(const S21Matrix &other) const;
-  void SumMatrix(const S21Matrix &other);
-  void SubMatrix(const S21Matrix &other);
-  void MulNumber(const double num);
-  void MulMatrix(const S21Matrix &other);
-  S21Matrix Transpose() const;
-  S21Matrix CalcComplements() const;
-  double Determinant() const;
-  S21Matrix InverseMatrix() const;
+  using value_type = T;
+
+  S21BasicMatrix();
+  S21BasicMatrix(int inrows, int incols);
+  S21BasicMatrix(const S21BasicMatrix &other);
+  S21BasicMatrix(S21BasicMatrix &&other);
+  // поэлементное приведение из матрицы с другим типом элементов
+  template <typename U,
+            typename = std::enable_if_t<!std::is_same<U, T>::value>>
+  explicit S21BasicMatrix(const S21BasicMatrix<U> &other);
+  template <typename E>
+  S21BasicMatrix(const S21MatrixExpr<E> &expr);
+  ~S21BasicMatrix();
+
+  // +, - и умножение на число возвращают ленивые выражения, см.
+  // s21_matrix_expr.h
+  S21BasicMatrix operator*(const S21BasicMatrix &other) const;
+  S21BasicMatrix &operator=(S21BasicMatrix &&other) noexcept;
+  S21BasicMatrix &operator=(const S21BasicMatrix &other);
+  template <typename E>
+  S21BasicMatrix &operator=(const S21MatrixExpr<E> &expr);
+  S21BasicMatrix &operator+=(const S21BasicMatrix &other);
+  S21BasicMatrix &operator-=(const S21BasicMatrix &other);
+  template <typename E>
+  S21BasicMatrix &operator+=(const S21MatrixExpr<E> &expr);
+  template <typename E>
+  S21BasicMatrix &operator-=(const S21MatrixExpr<E> &expr);
+  S21BasicMatrix &operator*=(const S21BasicMatrix &other);
+  S21BasicMatrix &operator*=(T num);
+  bool operator==(const S21BasicMatrix &other) const;
+  T operator()(int row, int col) const;
+  T &operator()(int row, int col);
+  bool EqMatrix(const S21BasicMatrix &other) const;
+  void SumMatrix(const S21BasicMatrix &other);
+  void SubMatrix(const S21BasicMatrix &other);
+  void MulNumber(const T num);
+  void MulMatrix(const S21BasicMatrix &other);
+  void MulMatrix(const S21BasicMatrix &other, S21MulAlgorithm algorithm);
+  // A * x для столбца x (cols x 1) или x * A для строки x (1 x rows)
+  // векторными ядрами без упаковки; operator* и MulMatrix выбирают их сами.
+  // Если размер out уже подходит, память не выделяется.
+  void MulVector(const S21BasicMatrix &vector, S21BasicMatrix *out) const;
+  S21BasicMatrix MulVector(const S21BasicMatrix &vector) const;
+  // разреженный множитель не переводится в плотный вид
+  template <typename U = T,
+            typename = std::enable_if_t<std::is_same<U, double>::value>>
+  void MulMatrix(const S21SparseMatrix &other);
+  S21BasicMatrix Transpose() const &;
+  S21BasicMatrix Transpose() &&;
+  void TransposeInPlace();
+  S21BasicMatrix CalcComplements() const;
+  // Для точно симметричной матрицы Determinant, InverseMatrix и Solve
+  // сначала пробуют разложение Холецкого (вдвое меньше операций, чем LU)
+  // и переходят к LU, если матрица не положительно определена.
+  T Determinant() const;
+  S21BasicMatrix InverseMatrix() const;
+  S21BasicLU<T> LU() const;
+  S21BasicCholesky<T> Cholesky() const;
+  S21BasicQR<T> QR() const;
+  // X с наименьшей ||A * X - B|| для A с rows >= cols полного ранга, через
+  // QR-разложение; для квадратной A совпадает с Solve
+  S21BasicMatrix LeastSquares(const S21BasicMatrix &rhs) const;
+  // Решение A * X = B для квадратной A и любого числа столбцов B через
+  // LU-разложение. Разложение запоминается в матрице, так что следующие
+  // вызовы стоят O(n^2) на столбец B; любой изменяющий метод (включая
+  // неконстантные operator(), Data(), View() и GetMatrix()) сбрасывает его.
+  // Запись через указатели, полученные до вызова Solve, не отслеживается.
+  // Вырожденная A - std::logic_error, как в InverseMatrix.
+  S21BasicMatrix Solve(const S21BasicMatrix &rhs) const;
+  // То же со смешанной точностью: разложение в S21MatrixTraits<T>::Reduced
+  // (для double - во float, тоже запоминается в матрице), невязка и
+  // поправки - в T. Уточнение останавливается, когда обратная ошибка
+  // опускается до уровня округления T; если она перестает убывать вдвое
+  // за шаг (плохо обусловленная A) или разложение в Reduced вырождено,
+  // решение строится Solve. report, если передан, получает итог.
+  S21BasicMatrix SolveMixed(const S21BasicMatrix &rhs,
+                            S21RefinementReport *report = nullptr) const;
+  // SolveMixed с единичной правой частью
+  S21BasicMatrix InverseMixed(S21RefinementReport *report = nullptr) const;
+  // Асинхронные варианты (s21_async.h): операнды копируются при вызове,
+  // ошибки размеров бросаются сразу, остальные (вырожденность, отмена -
+  // S21OperationCancelled) приходят через future.
+  std::future<S21BasicMatrix> MulMatrixAsync(
+      const S21BasicMatrix &other, S21AsyncOptions options = {}) const;
+  std::future<S21BasicMatrix> InverseAsync(S21AsyncOptions options = {}) const;
+  std::future<T> DeterminantAsync(S21AsyncOptions options = {}) const;
+  std::future<S21BasicMatrix> SolveAsync(const S21BasicMatrix &rhs,
+                                         S21AsyncOptions options = {}) const;
   int GetCols() const;
   int GetRows() const;
   void SetRows(int new_rows);
   void SetCols(int new_cols);
-  void SetValue(int row, int col, double value);
-  double **GetMatrix() const;
+  void SetValue(int row, int col, T value);
+  T **GetMatrix() const;
+  T *Data();
+  const T *Data() const;
+  // шаг строк в элементах; тип со знаком шире int, чтобы i * Stride() не
+  // переполнялся у матриц больше 2^31 элементов
+  std::ptrdiff_t Stride() const;
+  // вид на всю матрицу без копирования, см. s21_matrix_view.h
+  S21BasicMatrixView<T> View();
+  S21BasicMatrixView<const T> View() const;
+  // набор инструкций поэлементных ядер для типа T
+  static S21Isa ActiveIsa();
+
+  // двоичный формат из s21_matrix_io.h; Load сверяет контрольную сумму
+  void Save(const std::string &path) const;
+  static S21BasicMatrix Load(const std::string &path);
+  // Матрица поверх отображенного в память файла: открытие читает только
+  // заголовок, без выделения памяти, страницы подгружаются при обращении.
+  // В режиме kReadOnly первая запись через неконстантный интерфейс копирует
+  // элементы в обычный буфер; GetMatrix() и константный Data() указывают в
+  // отображение, писать через них нельзя.
+  static S21BasicMatrix MapFile(const std::string &path,
+                                S21MapMode mode = S21MapMode::kReadOnly);
+  S21Storage Storage() const;
+
+  // выравнивание буфера данных (одна кэш-линия)
+  static constexpr std::size_t kAlignment = 64;
 
  private:
+  template <typename>
+  friend class S21BasicMatrix;
+
   int rows_, cols_;
-  double **matrix_;
+  // элементы хранятся одним выровненным буфером по строкам,
+  // элемент (i, j) лежит по адресу data_[i * Stride() + j]
+  T *data_;
+  // число элементов в буфере и распределитель, который его выдал
+  std::size_t capacity_;
+  S21Allocator *allocator_;
+  S21Storage storage_;
+  // таблица указателей на строки, строится лениво только для GetMatrix()
+  mutable T **rows_view_;
+  // разложение для Solve, общее у копий с одинаковыми элементами. Solve
+  // читает и заменяет его через std::atomic_load/atomic_store, поэтому
+  // одновременные Solve над одной матрицей безопасны
+  mutable std::shared_ptr<const S21BasicLU<T>> lu_;
+  // разложение для SolveMixed, живет по тем же правилам, что и lu_
+  using Reduced = typename S21MatrixTraits<T>::Reduced;
+  mutable std::shared_ptr<const S21BasicLU<Reduced>> reduced_lu_;
+  // разложение Холецкого для Solve симметричной матрицы
+  mutable std::shared_ptr<const S21BasicCholesky<T>> cholesky_;
+  // Холецкий уже пробовали и матрица не положительно определена; живет и
+  // сбрасывается вместе с cholesky_
+  mutable std::atomic<bool> cholesky_failed_{false};
   void AllocateMemory(int inrows, int incols);
   void DeallocateMemory();
   void FreeMemory();
   void AllocateMatrix();
-  S21Matrix Minor(int rows_in, int cols_in) const;
+  void Resize(int new_rows, int new_cols);
+  void MakeWritable();
+  void DropCache() const;
+  template <typename E, typename Store>
+  void Apply(const E &expr, Store store);
+  // выражение читает буфер матрицы не по индексу записи (через вид)
+  template <typename E>
+  bool ExprMayAlias(const E &expr) const;
+  static void ForEachBlock(
+      std::size_t count,
+      const std::function<void(std::size_t, std::size_t)> &body);
+  S21BasicMatrix Minor(int rows_in, int cols_in) const;
+  bool InvertInPlace(T *det);
+  bool IsSymmetric() const;
+  std::shared_ptr<const S21BasicCholesky<T>> TryCholesky() const;
+  S21BasicMatrix Multiply(
+      const S21BasicMatrix &other,
+      S21MulAlgorithm algorithm = S21MulAlgorithm::kAuto) const;
+  static S21BasicMatrix Multiply(int m, int n, int k, const T *a, int lda,
+                                 const T *b, int ldb,
+                                 S21MulAlgorithm algorithm);
+  // произведение видов без пропусков с любыми шагами
+  static S21BasicMatrix MultiplyStrided(const S21BasicMatrixView<const T> &lhs,
+                                        const S21BasicMatrixView<const T> &rhs,
+                                        S21MulAlgorithm algorithm);
+  friend S21BasicMatrix S21MulViews<T>(const S21BasicMatrixView<const T> &lhs,
+                                       const S21BasicMatrixView<const T> &rhs,
+                                       S21MulAlgorithm algorithm);
+};
+
+#define S21_DECLARE_MATRIX(T) extern template class S21BasicMatrix<T>;
+S21_FOR_EACH_SCALAR(S21_DECLARE_MATRIX)
+#undef S21_DECLARE_MATRIX
+
+template <typename T>
+template <typename U, typename>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix<U> &other)
+    : S21BasicMatrix(other.GetRows(), other.GetCols()) {
+  std::size_t count = static_cast<std::size_t>(rows_) * cols_;
+  for (std::size_t k = 0; k < count; k++) {
+    data_[k] = static_cast<T>(other.data_[k]);
+  }
+}
+
+// LU-разложение с частичным выбором ведущего элемента: P * A = L * U.
+// L (с единичной диагональю) и U хранятся вместе в одной матрице factors_,
+// pivots_[k] - номер строки, переставленной с k-й на шаге k. Для целых
+// матриц не определено (std::logic_error).
+template <typename T>
+class S21BasicLU {
+ public:
+  explicit S21BasicLU(const S21BasicMatrix<T> &matrix);
+
+  bool IsSingular() const;
+  T Determinant() const;
+  const S21BasicMatrix<T> &Factors() const;
+  const std::vector<int> &Pivots() const;
+  // X из A * X = rhs за O(n^2) на столбец; вырожденная A - std::logic_error
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T> &rhs) const;
+
+  // порог IsSingular: ведущий элемент не больше него неотличим от нуля
+  static T SingularThreshold(const S21BasicMatrix<T> &matrix);
+
+ private:
+  S21BasicMatrix<T> factors_;
+  std::vector<int> pivots_;
+  int sign_;
+  bool singular_;
+};
+
+#define S21_DECLARE_LU(T) extern template class S21BasicLU<T>;
+S21_FOR_EACH_SCALAR(S21_DECLARE_LU)
+#undef S21_DECLARE_LU
+
+// Блочное разложение Холецкого A = L * L^T для симметричной положительно
+// определенной A; читается только нижний треугольник A. factors_ хранит L
+// (над диагональю нули). Если на каком-то шаге диагональ не положительна,
+// разложение останавливается и IsPositiveDefinite() возвращает false.
+template <typename T>
+class S21BasicCholesky {
+ public:
+  explicit S21BasicCholesky(const S21BasicMatrix<T> &matrix);
+
+  bool IsPositiveDefinite() const;
+  // квадрат произведения диагонали L
+  T Determinant() const;
+  const S21BasicMatrix<T> &Factor() const;
+  // X из A * X = rhs; не положительно определенная A - std::logic_error
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T> &rhs) const;
+  // A^-1 = L^-T * L^-1
+  S21BasicMatrix<T> Inverse() const;
+
+ private:
+  S21BasicMatrix<T> factors_;
+  bool positive_definite_;
+};
+
+#define S21_DECLARE_CHOLESKY(T) extern template class S21BasicCholesky<T>;
+S21_FOR_EACH_SCALAR(S21_DECLARE_CHOLESKY)
+#undef S21_DECLARE_CHOLESKY
+
+// QR-разложение отражениями Хаусхолдера для A размера m x n, m >= n:
+// A = Q * R. Как в LAPACK, R лежит на диагонали и над ней в factors_,
+// векторы отражений (с единицей в начале, которая не хранится) - под
+// диагональю, tau_ - их коэффициенты. Панели по kQrBlock столбцов
+// применяются к остатку матрицы блочным отражением (compact WY) через
+// S21Gemm.
+template <typename T>
+class S21BasicQR {
+ public:
+  explicit S21BasicQR(const S21BasicMatrix<T> &matrix);
+
+  // все диагональные элементы R больше порога вырожденности
+  bool IsFullRank() const;
+  // только для квадратной A: произведение диагонали R со знаком Q
+  T Determinant() const;
+  const S21BasicMatrix<T> &Factors() const;
+  const std::vector<T> &Tau() const;
+  // Q с n ортонормированными столбцами (m x n) и R (n x n)
+  S21BasicMatrix<T> Q() const;
+  S21BasicMatrix<T> R() const;
+  // решение задачи наименьших квадратов min ||A * X - rhs||, n x k;
+  // A неполного ранга - std::logic_error
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T> &rhs) const;
+
+ private:
+  S21BasicMatrix<T> factors_;
+  std::vector<T> tau_;
+  bool full_rank_;
+
+  // rhs = Q^T * rhs
+  void ApplyQt(S21BasicMatrix<T> *rhs) const;
 };
 
+#define S21_DECLARE_QR(T) extern template class S21BasicQR<T>;
+S21_FOR_EACH_SCALAR(S21_DECLARE_QR)
+#undef S21_DECLARE_QR
+
+#include "s21_fixed_matrix.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_expr.h"
+#include "s21_matrix_view.h"
+#include "s21_sparse_matrix.h"
+
 #endif
\ No newline at end of file
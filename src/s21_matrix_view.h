@@ -0,0 +1,299 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_VIEW_H_
+#define CPP1_S21_MATRIXPLUS_S21_MATRIX_VIEW_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "s21_matrix_expr.h"
+#include "s21_matrix_oop.h"
+
+// Виды на данные чужой матрицы без копирования. Вид задается указателем на
+// элемент (0, 0), размерами, шагами по строкам и столбцам и, возможно,
+// одной пропущенной строкой и одним пропущенным столбцом (так минор - это
+// вид с двумя пропусками). Блоки, диапазоны строк и столбцов и
+// транспонирование строят новый вид над теми же данными.
+//
+// Вид - лист ленивых выражений, поэтому участвует в +, -, умножении на
+// число и сравнении наравне с матрицами. Вид не владеет данными и не
+// должен переживать матрицу, из которой получен.
+template <typename Element>
+class S21BasicMatrixView
+    : public S21MatrixExpr<S21BasicMatrixView<Element>>,
+      public S21MatrixViewTag {
+ public:
+  using Scalar = std::remove_const_t<Element>;
+
+  S21BasicMatrixView(Element *data, int rows, int cols, int row_stride,
+                     int col_stride = 1)
+      : data_(data),
+        rows_(rows),
+        cols_(cols),
+        row_stride_(row_stride),
+        col_stride_(col_stride),
+        skip_row_(-1),
+        skip_col_(-1) {
+    if (rows < 0 || cols < 0) {
+      throw std::invalid_argument("Invalid rows or/and columns!");
+    }
+  }
+  S21BasicMatrixView(const S21BasicMatrixView &other) = default;
+  // изменяемый вид неявно приводится к константному
+  template <typename Other,
+            typename = std::enable_if_t<
+                std::is_same_v<const Other, Element> &&
+                !std::is_same_v<Other, Element>>>
+  S21BasicMatrixView(const S21BasicMatrixView<Other> &other)
+      : data_(other.data_),
+        rows_(other.rows_),
+        cols_(other.cols_),
+        row_stride_(other.row_stride_),
+        col_stride_(other.col_stride_),
+        skip_row_(other.skip_row_),
+        skip_col_(other.skip_col_) {}
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  int RowStride() const { return row_stride_; }
+  int ColStride() const { return col_stride_; }
+  Element *Data() const { return data_; }
+  // строки лежат подряд с единичным шагом и без пропусков, то есть вид
+  // можно передать в ядра как обычный буфер (Data(), RowStride())
+  bool IsDense() const {
+    return col_stride_ == 1 && skip_row_ < 0 && skip_col_ < 0;
+  }
+  // без пропусков: элемент (i, j) - Data()[i * RowStride() + j * ColStride()]
+  bool IsStrided() const { return skip_row_ < 0 && skip_col_ < 0; }
+
+  Element &operator()(int row, int col) const {
+    if (row < 0 || col < 0 || col >= cols_ || row >= rows_) {
+      throw std::out_of_range("Invalid rows or/and columns!");
+    }
+    return Ref(row, col);
+  }
+  // элемент с линейным индексом k по строкам, для вычисления выражений
+  Scalar At(std::size_t k) const {
+    return Ref(static_cast<int>(k / cols_), static_cast<int>(k % cols_));
+  }
+  // пересекаются ли элементы вида (от первого до последнего) с [first, last)
+  bool MayAlias(const void *first, const void *last) const {
+    if (rows_ == 0 || cols_ == 0) {
+      return false;
+    }
+    std::ptrdiff_t corners[] = {Offset(0, 0), Offset(0, cols_ - 1),
+                                Offset(rows_ - 1, 0),
+                                Offset(rows_ - 1, cols_ - 1)};
+    const Element *low = data_ + *std::min_element(corners, corners + 4);
+    const Element *high = data_ + *std::max_element(corners, corners + 4);
+    // std::less упорядочивает и указатели из разных массивов
+    std::less<const void *> before;
+    return before(low, last) && !before(high, first);
+  }
+
+  S21BasicMatrixView Block(int row, int col, int rows, int cols) const {
+    if (row < 0 || col < 0 || rows < 0 || cols < 0 || row + rows > rows_ ||
+        col + cols > cols_) {
+      throw std::out_of_range("Invalid rows or/and columns!");
+    }
+    S21BasicMatrixView result = *this;
+    result.data_ = data_ + Offset(row, col);
+    result.rows_ = rows;
+    result.cols_ = cols;
+    result.skip_row_ = ShiftSkip(skip_row_, row, rows);
+    result.skip_col_ = ShiftSkip(skip_col_, col, cols);
+    return result;
+  }
+  S21BasicMatrixView RowRange(int first, int count) const {
+    return Block(first, 0, count, cols_);
+  }
+  S21BasicMatrixView ColRange(int first, int count) const {
+    return Block(0, first, rows_, count);
+  }
+  S21BasicMatrixView Row(int row) const { return RowRange(row, 1); }
+  S21BasicMatrixView Col(int col) const { return ColRange(col, 1); }
+
+  S21BasicMatrixView Transposed() const {
+    S21BasicMatrixView result = *this;
+    result.rows_ = cols_;
+    result.cols_ = rows_;
+    result.row_stride_ = col_stride_;
+    result.col_stride_ = row_stride_;
+    result.skip_row_ = skip_col_;
+    result.skip_col_ = skip_row_;
+    return result;
+  }
+
+  // вид без строки row; у вида может быть только один пропуск по строкам
+  S21BasicMatrixView SkipRow(int row) const {
+    if (row < 0 || row >= rows_) {
+      throw std::out_of_range("Invalid rows or/and columns!");
+    }
+    if (skip_row_ >= 0) {
+      throw std::logic_error("View already skips a row");
+    }
+    S21BasicMatrixView result = *this;
+    result.rows_--;
+    result.skip_row_ = row;
+    return result;
+  }
+  S21BasicMatrixView SkipCol(int col) const {
+    return Transposed().SkipRow(col).Transposed();
+  }
+  S21BasicMatrixView Minor(int row, int col) const {
+    return SkipRow(row).SkipCol(col);
+  }
+
+  // Запись в вид поэлементная (вид не перенаправляется на другие данные).
+  // Правая часть не должна перекрываться с видом иначе как поэлементно
+  // совпадая с ним.
+  S21BasicMatrixView &operator=(const S21BasicMatrixView &other) {
+    Store(other, [](Element &dst, Scalar value) { dst = value; });
+    return *this;
+  }
+  template <typename E>
+  S21BasicMatrixView &operator=(const S21MatrixExpr<E> &expr) {
+    Store(expr.Self(), [](Element &dst, Scalar value) { dst = value; });
+    return *this;
+  }
+  S21BasicMatrixView &operator=(const S21BasicMatrix<Scalar> &other) {
+    return *this = S21MatrixRef<Scalar>(other);
+  }
+  template <typename E>
+  S21BasicMatrixView &operator+=(const S21MatrixExpr<E> &expr) {
+    Store(expr.Self(), [](Element &dst, Scalar value) { dst += value; });
+    return *this;
+  }
+  S21BasicMatrixView &operator+=(const S21BasicMatrix<Scalar> &other) {
+    return *this += S21MatrixRef<Scalar>(other);
+  }
+  template <typename E>
+  S21BasicMatrixView &operator-=(const S21MatrixExpr<E> &expr) {
+    Store(expr.Self(), [](Element &dst, Scalar value) { dst -= value; });
+    return *this;
+  }
+  S21BasicMatrixView &operator-=(const S21BasicMatrix<Scalar> &other) {
+    return *this -= S21MatrixRef<Scalar>(other);
+  }
+  S21BasicMatrixView &operator*=(Scalar num) {
+    Store(*this, [num](Element &dst, Scalar) { dst *= num; });
+    return *this;
+  }
+
+ private:
+  template <typename>
+  friend class S21BasicMatrixView;
+
+  Element *data_;
+  int rows_, cols_;
+  int row_stride_, col_stride_;
+  // индекс пропущенной строки (столбца) в координатах вида или -1
+  int skip_row_, skip_col_;
+
+  std::ptrdiff_t Offset(int row, int col) const {
+    row += skip_row_ >= 0 && row >= skip_row_;
+    col += skip_col_ >= 0 && col >= skip_col_;
+    return static_cast<std::ptrdiff_t>(row) * row_stride_ +
+           static_cast<std::ptrdiff_t>(col) * col_stride_;
+  }
+  Element &Ref(int row, int col) const { return data_[Offset(row, col)]; }
+
+  // пропуск после сдвига начала на first; пропуск не позже начала блока
+  // уже учтен в указателе на начало, пропуск за концом блока не нужен
+  static int ShiftSkip(int skip, int first, int count) {
+    return skip > first && skip - first < count ? skip - first : -1;
+  }
+
+  template <typename E, typename Op>
+  void Store(const E &expr, Op op) {
+    static_assert(!std::is_const_v<Element>, "View is read-only");
+    if (rows_ != expr.GetRows() || cols_ != expr.GetCols()) {
+      throw std::invalid_argument("Different matrix size");
+    }
+    int cols = cols_;
+    double work = static_cast<double>(rows_) * cols_;
+    S21ParallelFor(0, rows_, work, [this, &expr, op, cols](int first,
+                                                         int last) {
+      for (int i = first; i < last; i++) {
+        std::size_t base = static_cast<std::size_t>(i) * cols;
+        for (int j = 0; j < cols; j++) {
+          op(Ref(i, j), expr.At(base + j));
+        }
+      }
+    });
+  }
+};
+
+template <typename T>
+S21BasicMatrixView<T> S21BasicMatrix<T>::View() {
+  MakeWritable();
+  return S21BasicMatrixView<T>(data_, rows_, cols_, Stride());
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMatrix<T>::View() const {
+  return S21BasicMatrixView<const T>(data_, rows_, cols_, Stride());
+}
+
+// Произведение видов. Плотные виды (IsDense) передаются в GEMM как есть,
+// виды с шагом по столбцам (транспонированные) упаковываются в панели GEMM
+// прямо из своих данных. Копируются только виды с пропущенными строкой или
+// столбцом, а также операнды векторных форм и Штрассена, которым нужен
+// плотный буфер.
+template <typename T>
+S21BasicMatrix<T> S21MulViews(const S21BasicMatrixView<const T> &lhs,
+                              const S21BasicMatrixView<const T> &rhs,
+                              S21MulAlgorithm algorithm);
+
+template <typename T>
+S21BasicMatrixView<const T> S21AsView(const S21BasicMatrix<T> &matrix) {
+  return matrix.View();
+}
+
+template <typename Element>
+S21BasicMatrixView<const std::remove_const_t<Element>> S21AsView(
+    const S21BasicMatrixView<Element> &view) {
+  return view;
+}
+
+// enable_if в типе параметра, а не в значении по умолчанию: иначе
+// объявление совпало бы с шаблонами из s21_matrix_expr.h
+template <typename L, typename R,
+          std::enable_if_t<kS21IsViewOperands<L, R>, int> = 0>
+S21BasicMatrix<S21OperandScalar<L>> operator*(const L &lhs, const R &rhs) {
+  using Scalar = S21OperandScalar<L>;
+  // выражения, не являющиеся видами, вычисляются во временную матрицу
+  if constexpr (!kS21IsBasicMatrix<L> &&
+                !std::is_base_of_v<S21MatrixViewTag, L>) {
+    return S21BasicMatrix<Scalar>(lhs) * rhs;
+  } else if constexpr (!kS21IsBasicMatrix<R> &&
+                       !std::is_base_of_v<S21MatrixViewTag, R>) {
+    return lhs * S21BasicMatrix<Scalar>(rhs);
+  } else {
+    return S21MulViews<Scalar>(S21AsView(lhs), S21AsView(rhs),
+                               S21MulAlgorithm::kAuto);
+  }
+}
+
+// сравнение поэлементно прямо по данным операндов, без копирования
+template <typename L, typename R,
+          std::enable_if_t<kS21IsViewOperands<L, R>, int> = 0>
+bool operator==(const L &lhs, const R &rhs) {
+  const auto &left = S21AsExpr(lhs);
+  const auto &right = S21AsExpr(rhs);
+  if (left.GetRows() != right.GetRows() || left.GetCols() != right.GetCols()) {
+    return false;
+  }
+  const auto tolerance = S21MatrixTraits<S21OperandScalar<L>>::kTolerance;
+  std::size_t count = static_cast<std::size_t>(left.GetRows()) * left.GetCols();
+  for (std::size_t k = 0; k < count; k++) {
+    if (std::abs(left.At(k) - right.At(k)) > tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,374 @@
+#include "s21_out_of_core.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <system_error>
+
+#include "s21_kernels.h"
+#include "s21_matrix_io.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Seconds(Clock::time_point since) {
+  return std::chrono::duration<double>(Clock::now() - since).count();
+}
+
+// Исполнитель операций ввода-вывода. С prefetch каждая операция идет в
+// своем потоке и вызывающий ждет ее только перед тем, как тронуть ее
+// буфер; без prefetch операция выполняется сразу и целиком считается
+// простоем вычислений.
+class IoQueue {
+ public:
+  IoQueue(bool async, S21OutOfCoreReport *report)
+      : async_(async), report_(report) {}
+
+  std::future<double> Start(std::function<void()> job) {
+    auto timed = [job]() {
+      Clock::time_point start = Clock::now();
+      job();
+      return Seconds(start);
+    };
+    if (async_) {
+      return std::async(std::launch::async, timed);
+    }
+    double seconds = timed();
+    report_->wait_seconds += seconds;
+    std::promise<double> done;
+    done.set_value(seconds);
+    return done.get_future();
+  }
+
+  void Wait(std::future<double> *pending) {
+    if (!pending->valid()) {
+      return;
+    }
+    Clock::time_point start = Clock::now();
+    report_->io_seconds += pending->get();
+    if (async_) {
+      report_->wait_seconds += Seconds(start);
+    }
+  }
+
+ private:
+  bool async_;
+  S21OutOfCoreReport *report_;
+};
+
+std::uint64_t ElementOffset(std::uint64_t index) {
+  return sizeof(S21MatrixFileHeader) + index * sizeof(double);
+}
+
+S21MatrixFileHeader ReadOperand(const S21File &file) {
+  bool swapped = false;
+  S21MatrixFileHeader header = S21ReadMatrixHeader(file, &swapped);
+  if (swapped) {
+    throw std::runtime_error(file.Path() + ": byte order differs");
+  }
+  if (header.dtype != static_cast<std::uint32_t>(S21DType::kFloat64)) {
+    throw std::runtime_error(file.Path() + ": elements are not double");
+  }
+  ::posix_fadvise(file.Get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+  return header;
+}
+
+// Выходной файл открывается без усечения, чтобы сначала убедиться, что
+// это не один из операндов.
+void CheckDistinct(const S21File &result, const S21File &lhs,
+                   const S21File &rhs) {
+  struct stat out;
+  if (::fstat(result.Get(), &out) != 0) {
+    throw std::system_error(errno, std::generic_category(), result.Path());
+  }
+  for (const S21File *operand : {&lhs, &rhs}) {
+    struct stat in;
+    if (::fstat(operand->Get(), &in) == 0 && in.st_dev == out.st_dev &&
+        in.st_ino == out.st_ino) {
+      throw std::invalid_argument("The result file must differ from operands");
+    }
+  }
+  if (::ftruncate(result.Get(), 0) != 0) {
+    throw std::system_error(errno, std::generic_category(), result.Path());
+  }
+}
+
+// заголовок пишется последним: прерванный расчет оставляет файл, который
+// не пройдет проверку формата
+void FinishResult(const S21File &result, int rows, int cols,
+                  std::uint64_t checksum, S21OutOfCoreReport *report) {
+  S21MatrixFileHeader header = S21MakeMatrixHeader(rows, cols, checksum);
+  result.WriteAt(&header, sizeof(header), 0);
+  report->bytes_written += sizeof(header);
+}
+
+void Elementwise(const std::string &lhs, const std::string &rhs,
+                 const std::string &result,
+                 const S21OutOfCoreOptions &options, bool subtract,
+                 S21OutOfCoreReport *report) {
+  Clock::time_point total = Clock::now();
+  S21File a(lhs, O_RDONLY);
+  S21File b(rhs, O_RDONLY);
+  S21MatrixFileHeader ha = ReadOperand(a);
+  S21MatrixFileHeader hb = ReadOperand(b);
+  if (ha.rows != hb.rows || ha.cols != hb.cols) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  S21File out(result, O_WRONLY | O_CREAT);
+  CheckDistinct(out, a, b);
+  int rows = static_cast<int>(ha.rows);
+  int cols = static_cast<int>(ha.cols);
+  std::uint64_t checksum = kS21ChecksumSeed;
+  if (rows > 0) {
+    // два слота по полосе каждого операнда, результат пишется из полосы lhs
+    std::size_t budget = options.memory_budget / sizeof(double);
+    std::size_t fit = budget / (4 * static_cast<std::size_t>(cols));
+    if (fit < 1) {
+      throw std::invalid_argument("Memory budget is too small");
+    }
+    int strip = static_cast<int>(std::min<std::size_t>(rows, fit));
+    report->panel_rows = strip;
+    std::size_t strip_count = static_cast<std::size_t>(strip) * cols;
+    S21ScratchBuffer buffers[4] = {
+        S21ScratchBuffer(strip_count), S21ScratchBuffer(strip_count),
+        S21ScratchBuffer(strip_count), S21ScratchBuffer(strip_count)};
+    IoQueue io(options.prefetch, report);
+    std::future<double> pending[2];
+    int strips = (rows + strip - 1) / strip;
+
+    auto strip_bytes = [&](int s) {
+      return static_cast<std::size_t>(std::min(strip, rows - s * strip)) *
+             cols * sizeof(double);
+    };
+    // задание слота: дописать результат полосы done (если есть) и прочитать
+    // полосу next (если есть)
+    auto launch = [&](int slot, int done, int next) {
+      double *x = buffers[2 * slot].Get();
+      double *y = buffers[2 * slot + 1].Get();
+      std::uint64_t done_at =
+          ElementOffset(static_cast<std::uint64_t>(done) * strip * cols);
+      std::uint64_t next_at =
+          ElementOffset(static_cast<std::uint64_t>(next) * strip * cols);
+      std::size_t done_bytes = done >= 0 ? strip_bytes(done) : 0;
+      std::size_t next_bytes = next < strips ? strip_bytes(next) : 0;
+      report->bytes_written += done_bytes;
+      report->bytes_read += 2 * next_bytes;
+      pending[slot] = io.Start([&, x, y, done_at, next_at, done_bytes,
+                                next_bytes]() {
+        out.WriteAt(x, done_bytes, done_at);
+        a.ReadAt(x, next_bytes, next_at);
+        b.ReadAt(y, next_bytes, next_at);
+      });
+    };
+
+    launch(0, -1, 0);
+    launch(1, -1, 1);
+    for (int s = 0; s < strips; s++) {
+      int slot = s % 2;
+      io.Wait(&pending[slot]);
+      Clock::time_point compute = Clock::now();
+      double *x = buffers[2 * slot].Get();
+      const double *y = buffers[2 * slot + 1].Get();
+      std::size_t count = strip_bytes(s) / sizeof(double);
+      if (subtract) {
+        S21ActiveKernels().sub(count, x, y);
+      } else {
+        S21ActiveKernels().add(count, x, y);
+      }
+      checksum = S21MatrixChecksum(x, count, false, checksum);
+      report->compute_seconds += Seconds(compute);
+      launch(slot, s, s + 2);
+    }
+    io.Wait(&pending[0]);
+    io.Wait(&pending[1]);
+  }
+  FinishResult(out, rows, cols, checksum, report);
+  report->total_seconds = Seconds(total);
+}
+
+}  // namespace
+
+double S21OutOfCoreReport::Overlap() const {
+  if (io_seconds <= 0.0) {
+    return 1.0;
+  }
+  return std::clamp(1.0 - wait_seconds / io_seconds, 0.0, 1.0);
+}
+
+// Результат считается полосами по panel_rows строк. Для полосы i в памяти
+// держится полоса lhs (panel_rows x k) и вся полоса результата
+// (panel_rows x n), а rhs проходит панелями по panel_cols столбцов. Панели
+// обходятся змейкой (в нечетных полосах справа налево), так что панель на
+// стыке полос не перечитывается, а при двух панелях rhs читается один раз.
+// Готовая полоса результата непрерывна в файле и пишется одной операцией.
+S21OutOfCoreReport S21MulFiles(const std::string &lhs, const std::string &rhs,
+                               const std::string &result,
+                               const S21OutOfCoreOptions &options) {
+  S21OutOfCoreReport report;
+  Clock::time_point total = Clock::now();
+  S21File a(lhs, O_RDONLY);
+  S21File b(rhs, O_RDONLY);
+  S21MatrixFileHeader ha = ReadOperand(a);
+  S21MatrixFileHeader hb = ReadOperand(b);
+  if (ha.cols != hb.rows) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number "
+        "of rows of the second matrix");
+  }
+  S21File out(result, O_WRONLY | O_CREAT);
+  CheckDistinct(out, a, b);
+  int m = static_cast<int>(ha.rows);
+  int k = static_cast<int>(ha.cols);
+  int n = static_cast<int>(hb.cols);
+  std::uint64_t checksum = kS21ChecksumSeed;
+  if (m == 0) {
+    FinishResult(out, 0, 0, checksum, &report);
+    report.total_seconds = Seconds(total);
+    return report;
+  }
+
+  // половина бюджета - по две полосы lhs и результата, остальное - две
+  // панели rhs
+  std::size_t budget = options.memory_budget / sizeof(double);
+  std::size_t row_cost = 2 * (static_cast<std::size_t>(k) + n);
+  std::size_t mr = std::min<std::size_t>(m, budget / 2 / row_cost);
+  std::size_t nc =
+      mr < 1 ? 0 : std::min<std::size_t>(n, (budget - mr * row_cost) / (2 * k));
+  if (nc < 1) {
+    throw std::invalid_argument("Memory budget is too small");
+  }
+  int panel_rows = static_cast<int>(mr);
+  int panel_cols = static_cast<int>(nc);
+  report.panel_rows = panel_rows;
+  report.panel_cols = panel_cols;
+  int strips = (m + panel_rows - 1) / panel_rows;
+  int panels = (n + panel_cols - 1) / panel_cols;
+
+  S21ScratchBuffer a_buffers[2] = {S21ScratchBuffer(mr * k),
+                                   S21ScratchBuffer(mr * k)};
+  S21ScratchBuffer b_buffers[2] = {S21ScratchBuffer(nc * k),
+                                   S21ScratchBuffer(nc * k)};
+  S21ScratchBuffer c_buffers[2] = {S21ScratchBuffer(mr * n),
+                                   S21ScratchBuffer(mr * n)};
+  IoQueue io(options.prefetch, &report);
+  std::future<double> load;
+  std::future<double> writes[2];
+
+  auto strip_rows = [&](int i) {
+    return std::min(panel_rows, m - i * panel_rows);
+  };
+  auto panel_width = [&](int j) {
+    return std::min(panel_cols, n - j * panel_cols);
+  };
+  // номер панели rhs на шаге step полосы i (змейка)
+  auto panel_at = [&](int i, int step) {
+    return i % 2 == 0 ? step : panels - 1 - step;
+  };
+  // какая полоса lhs и панель rhs лежат в каждом буфере
+  int a_held[2] = {-1, -1};
+  int b_held[2] = {-1, -1};
+  int a_cur = 0;
+  int b_cur = 0;
+  // Выбирает буферы для шага (i, j): уже прочитанные данные берутся из
+  // любого буфера, новые читаются в тот, что не занят текущим шагом.
+  auto prepare = [&](int i, int j) {
+    int a_slot = a_held[a_cur] == i ? a_cur : 1 - a_cur;
+    int b_slot = b_held[b_cur] == j ? b_cur : 1 - b_cur;
+    bool read_a = a_held[a_slot] != i;
+    bool read_b = b_held[b_slot] != j;
+    a_held[a_slot] = i;
+    b_held[b_slot] = j;
+    a_cur = a_slot;
+    b_cur = b_slot;
+    if (!read_a && !read_b) {
+      return;
+    }
+    double *a_dst = a_buffers[a_slot].Get();
+    double *b_dst = b_buffers[b_slot].Get();
+    std::size_t a_count = static_cast<std::size_t>(strip_rows(i)) * k;
+    int width = panel_width(j);
+    report.bytes_read += (read_a ? a_count * sizeof(double) : 0) +
+                         (read_b ? static_cast<std::size_t>(width) * k *
+                                       sizeof(double)
+                                 : 0);
+    load = io.Start([&, i, j, width, read_a, read_b, a_dst, b_dst,
+                     a_count]() {
+      if (read_a) {
+        a.ReadAt(a_dst, a_count * sizeof(double),
+                 ElementOffset(static_cast<std::uint64_t>(i) * panel_rows * k));
+      }
+      if (read_b && width == n) {
+        b.ReadAt(b_dst, static_cast<std::size_t>(k) * n * sizeof(double),
+                 ElementOffset(0));
+      } else if (read_b) {
+        for (int p = 0; p < k; p++) {
+          b.ReadAt(b_dst + static_cast<std::size_t>(p) * width,
+                   width * sizeof(double),
+                   ElementOffset(static_cast<std::uint64_t>(p) * n +
+                                 static_cast<std::uint64_t>(j) * panel_cols));
+        }
+      }
+    });
+  };
+
+  prepare(0, panel_at(0, 0));
+  for (int i = 0; i < strips; i++) {
+    double *c = c_buffers[i % 2].Get();
+    io.Wait(&writes[i % 2]);
+    for (int step = 0; step < panels; step++) {
+      int j = panel_at(i, step);
+      io.Wait(&load);
+      const double *a_data = a_buffers[a_cur].Get();
+      const double *b_data = b_buffers[b_cur].Get();
+      if (step + 1 < panels) {
+        prepare(i, panel_at(i, step + 1));
+      } else if (i + 1 < strips) {
+        prepare(i + 1, panel_at(i + 1, 0));
+      }
+      Clock::time_point compute = Clock::now();
+      S21Gemm(strip_rows(i), panel_width(j), k, a_data, k, b_data,
+              panel_width(j), c + static_cast<std::size_t>(j) * panel_cols,
+              n);
+      report.compute_seconds += Seconds(compute);
+    }
+    Clock::time_point compute = Clock::now();
+    std::size_t count = static_cast<std::size_t>(strip_rows(i)) * n;
+    checksum = S21MatrixChecksum(c, count, false, checksum);
+    report.compute_seconds += Seconds(compute);
+    std::uint64_t at =
+        ElementOffset(static_cast<std::uint64_t>(i) * panel_rows * n);
+    report.bytes_written += count * sizeof(double);
+    writes[i % 2] = io.Start(
+        [&out, c, count, at]() { out.WriteAt(c, count * sizeof(double), at); });
+  }
+  io.Wait(&writes[0]);
+  io.Wait(&writes[1]);
+  FinishResult(out, m, n, checksum, &report);
+  report.total_seconds = Seconds(total);
+  return report;
+}
+
+S21OutOfCoreReport S21SumFiles(const std::string &lhs, const std::string &rhs,
+                               const std::string &result,
+                               const S21OutOfCoreOptions &options) {
+  S21OutOfCoreReport report;
+  Elementwise(lhs, rhs, result, options, false, &report);
+  return report;
+}
+
+S21OutOfCoreReport S21SubFiles(const std::string &lhs, const std::string &rhs,
+                               const std::string &result,
+                               const S21OutOfCoreOptions &options) {
+  S21OutOfCoreReport report;
+  Elementwise(lhs, rhs, result, options, true, &report);
+  return report;
+}
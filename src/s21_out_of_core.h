@@ -0,0 +1,54 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_OUT_OF_CORE_H_
+#define CPP1_S21_MATRIXPLUS_S21_OUT_OF_CORE_H_
+
+// Операции над матрицами в файлах формата s21_matrix_io.h, которые не
+// помещаются в память целиком. Операнды читаются панелями через pread,
+// результат пишется в выходной файл полосами строк по мере готовности, так
+// что в памяти одновременно живут только буферы панелей в пределах
+// memory_budget. Пока считается одна панель, отдельный поток читает
+// следующую и дописывает готовые полосы (двойная буферизация).
+//
+// Контрольные суммы операндов не проверяются (для этого пришлось бы
+// прочитать их лишний раз), выходной файл получает правильную. Принимаются
+// только файлы матриц double в порядке байт машины.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct S21OutOfCoreOptions {
+  // сколько байт могут занимать буферы панелей
+  std::size_t memory_budget = std::size_t(256) << 20;
+  // false - чтение и запись в вызывающем потоке, без перекрытия
+  bool prefetch = true;
+};
+
+struct S21OutOfCoreReport {
+  std::uint64_t bytes_read = 0;
+  std::uint64_t bytes_written = 0;
+  double io_seconds = 0.0;       // суммарное время чтения и записи
+  double compute_seconds = 0.0;  // время вычислений
+  double wait_seconds = 0.0;     // вычисления стояли в ожидании данных
+  double total_seconds = 0.0;
+  // размеры панелей, выбранные под бюджет: строк результата в полосе и
+  // столбцов правого множителя в панели (для сложения - 0)
+  int panel_rows = 0;
+  int panel_cols = 0;
+
+  // доля ввода-вывода, скрытая за вычислениями: 1 - wait / io
+  double Overlap() const;
+};
+
+// result = lhs * rhs; ни один операнд не загружается целиком
+S21OutOfCoreReport S21MulFiles(
+    const std::string &lhs, const std::string &rhs, const std::string &result,
+    const S21OutOfCoreOptions &options = S21OutOfCoreOptions());
+// result = lhs + rhs и result = lhs - rhs
+S21OutOfCoreReport S21SumFiles(
+    const std::string &lhs, const std::string &rhs, const std::string &result,
+    const S21OutOfCoreOptions &options = S21OutOfCoreOptions());
+S21OutOfCoreReport S21SubFiles(
+    const std::string &lhs, const std::string &rhs, const std::string &result,
+    const S21OutOfCoreOptions &options = S21OutOfCoreOptions());
+
+#endif
@@ -0,0 +1,204 @@
+#include "s21_profiler.h"
+
+#include <atomic>
+#include <sstream>
+
+#include "s21_allocator.h"
+
+namespace {
+
+constexpr int kOperations = static_cast<int>(S21Operation::kCount);
+
+// Счетчики одной операции. Обновляются атомарно без блокировок, так что
+// снимок, снятый во время работы, может разойтись между полями на
+// несколько вызовов.
+struct OperationCounters {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> total_ns{0};
+  std::atomic<std::uint64_t> max_ns{0};
+  std::atomic<std::uint64_t> flops{0};
+  std::atomic<std::uint64_t> bytes{0};
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> size_sum{0};
+  std::atomic<std::uint64_t> size_histogram[kS21SizeBuckets]{};
+};
+
+OperationCounters counters[kOperations];
+std::atomic<S21TraceBegin> trace_begin{nullptr};
+std::atomic<S21TraceEnd> trace_end{nullptr};
+
+const char *const kNames[kOperations] = {
+    "sum",       "sub",         "mul_number", "mul_matrix",  "equal",
+    "transpose", "determinant", "inverse",    "complements", "expression"};
+
+// верхние границы корзин гистограммы для Prometheus (le)
+std::uint64_t BucketBound(int bucket) { return std::uint64_t(1) << bucket; }
+
+}  // namespace
+
+const char *S21OperationName(S21Operation op) {
+  int index = static_cast<int>(op);
+  return index >= 0 && index < kOperations ? kNames[index] : "unknown";
+}
+
+S21ProfileSnapshot S21GetProfile() {
+  S21ProfileSnapshot snapshot;
+  for (int i = 0; i < kOperations; i++) {
+    const OperationCounters &from = counters[i];
+    S21OperationStats &to = snapshot.operations[i];
+    to.calls = from.calls.load(std::memory_order_relaxed);
+    to.total_ns = from.total_ns.load(std::memory_order_relaxed);
+    to.max_ns = from.max_ns.load(std::memory_order_relaxed);
+    to.flops = from.flops.load(std::memory_order_relaxed);
+    to.bytes = from.bytes.load(std::memory_order_relaxed);
+    to.allocations = from.allocations.load(std::memory_order_relaxed);
+    to.size_sum = from.size_sum.load(std::memory_order_relaxed);
+    for (int b = 0; b < kS21SizeBuckets; b++) {
+      to.size_histogram[b] =
+          from.size_histogram[b].load(std::memory_order_relaxed);
+    }
+  }
+  return snapshot;
+}
+
+void S21ResetProfile() {
+  for (OperationCounters &op : counters) {
+    op.calls = 0;
+    op.total_ns = 0;
+    op.max_ns = 0;
+    op.flops = 0;
+    op.bytes = 0;
+    op.allocations = 0;
+    op.size_sum = 0;
+    for (std::atomic<std::uint64_t> &bucket : op.size_histogram) {
+      bucket = 0;
+    }
+  }
+}
+
+// Счетчики - counter с меткой op, размеры - histogram с накопленными
+// корзинами le, _sum и _count, как того требует формат.
+std::string S21ProfilePrometheus() {
+  S21ProfileSnapshot snapshot = S21GetProfile();
+  std::ostringstream out;
+  struct Metric {
+    const char *name;
+    const char *help;
+    std::uint64_t S21OperationStats::*field;
+    double scale;
+  };
+  const Metric metrics[] = {
+      {"s21_matrix_calls_total", "Number of calls.", &S21OperationStats::calls,
+       1.0},
+      {"s21_matrix_seconds_total", "Total time spent in the operation.",
+       &S21OperationStats::total_ns, 1e-9},
+      {"s21_matrix_max_seconds", "Longest single call.",
+       &S21OperationStats::max_ns, 1e-9},
+      {"s21_matrix_flops_total", "Floating-point operations performed.",
+       &S21OperationStats::flops, 1.0},
+      {"s21_matrix_bytes_total", "Bytes read and written.",
+       &S21OperationStats::bytes, 1.0},
+      {"s21_matrix_allocations_total",
+       "Memory requests made by the calling thread.",
+       &S21OperationStats::allocations, 1.0}};
+  for (const Metric &metric : metrics) {
+    bool gauge = metric.field == &S21OperationStats::max_ns;
+    out << "# HELP " << metric.name << ' ' << metric.help << '\n';
+    out << "# TYPE " << metric.name << (gauge ? " gauge\n" : " counter\n");
+    for (int i = 0; i < kOperations; i++) {
+      std::uint64_t value = snapshot.operations[i].*metric.field;
+      out << metric.name << "{op=\"" << kNames[i] << "\"} ";
+      if (metric.scale == 1.0) {
+        out << value << '\n';
+      } else {
+        out << value * metric.scale << '\n';
+      }
+    }
+  }
+  const char *size = "s21_matrix_size";
+  out << "# HELP " << size << " Largest dimension of the operands.\n";
+  out << "# TYPE " << size << " histogram\n";
+  for (int i = 0; i < kOperations; i++) {
+    const S21OperationStats &stats = snapshot.operations[i];
+    std::uint64_t cumulative = 0;
+    for (int b = 0; b < kS21SizeBuckets - 1; b++) {
+      cumulative += stats.size_histogram[b];
+      out << size << "_bucket{op=\"" << kNames[i] << "\",le=\""
+          << BucketBound(b) << "\"} " << cumulative << '\n';
+    }
+    out << size << "_bucket{op=\"" << kNames[i] << "\",le=\"+Inf\"} "
+        << stats.calls << '\n';
+    out << size << "_sum{op=\"" << kNames[i] << "\"} " << stats.size_sum
+        << '\n';
+    out << size << "_count{op=\"" << kNames[i] << "\"} " << stats.calls
+        << '\n';
+  }
+  return out.str();
+}
+
+void S21SetTraceHooks(S21TraceBegin begin, S21TraceEnd end) {
+  trace_begin = begin;
+  trace_end = end;
+}
+
+#ifdef S21_PROFILING
+
+namespace {
+
+// число открытых замеров в потоке
+thread_local int scope_depth = 0;
+
+}  // namespace
+
+S21ProfileScope::S21ProfileScope(S21Operation op, int rows, int cols,
+                                 double flops, double bytes)
+    : op_(op),
+      size_(rows > cols ? rows : cols),
+      flops_(static_cast<std::uint64_t>(flops)),
+      bytes_(static_cast<std::uint64_t>(bytes)),
+      allocations_(S21ThreadAllocations()),
+      outer_(scope_depth++ == 0),
+      start_() {
+  if (!outer_) {
+    return;
+  }
+  S21TraceBegin begin = trace_begin.load(std::memory_order_relaxed);
+  if (begin != nullptr) {
+    begin(op, rows, cols);
+  }
+  start_ = std::chrono::steady_clock::now();
+}
+
+S21ProfileScope::~S21ProfileScope() {
+  scope_depth--;
+  if (!outer_) {
+    return;
+  }
+  std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+  OperationCounters &op = counters[static_cast<int>(op_)];
+  op.calls.fetch_add(1, std::memory_order_relaxed);
+  op.total_ns.fetch_add(ns, std::memory_order_relaxed);
+  std::uint64_t max = op.max_ns.load(std::memory_order_relaxed);
+  while (ns > max && !op.max_ns.compare_exchange_weak(
+                         max, ns, std::memory_order_relaxed)) {
+  }
+  op.flops.fetch_add(flops_, std::memory_order_relaxed);
+  op.bytes.fetch_add(bytes_, std::memory_order_relaxed);
+  op.allocations.fetch_add(S21ThreadAllocations() - allocations_,
+                           std::memory_order_relaxed);
+  int bucket = 0;
+  while (bucket < kS21SizeBuckets - 1 &&
+         BucketBound(bucket) < static_cast<std::uint64_t>(size_)) {
+    bucket++;
+  }
+  op.size_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+  op.size_sum.fetch_add(size_, std::memory_order_relaxed);
+  S21TraceEnd end = trace_end.load(std::memory_order_relaxed);
+  if (end != nullptr) {
+    end(op_, ns);
+  }
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_PROFILER_H_
+#define CPP1_S21_MATRIXPLUS_S21_PROFILER_H_
+
+// Счетчики операций S21Matrix. Включаются сборкой библиотеки (и кода,
+// который ее подключает) с -DS21_PROFILING; без этого макрос S21_PROFILE
+// раскрывается в пустую инструкцию и накладных расходов нет, а
+// S21GetProfile() возвращает нули.
+//
+// Для каждой операции накапливаются число вызовов, суммарное и
+// максимальное время, число арифметических операций, объем прочитанных и
+// записанных данных, число выделений памяти в вызывающем потоке и
+// гистограмма размеров (по наибольшей из размерностей).
+//
+// Учитываются только внешние вызовы: операция, выполненная внутри другой
+// (Transpose и MulNumber внутри CalcComplements, Determinant миноров и
+// т. п.), отдельно не считается и трассировщику не сообщается, ее время,
+// операции и выделения памяти входят в счетчики внешней.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class S21Operation {
+  kSum,
+  kSub,
+  kMulNumber,
+  kMulMatrix,
+  kEqual,
+  kTranspose,
+  kDeterminant,
+  kInverse,
+  kComplements,
+  kExpression,
+  kCount
+};
+
+// имя операции для отчетов ("mul_matrix", "determinant", ...)
+const char *S21OperationName(S21Operation op);
+
+// корзина i содержит размеры до 2^i включительно, последняя - все большие
+constexpr int kS21SizeBuckets = 14;
+
+struct S21OperationStats {
+  std::uint64_t calls = 0;
+  std::uint64_t total_ns = 0;
+  std::uint64_t max_ns = 0;
+  std::uint64_t flops = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t allocations = 0;
+  // сумма размеров всех вызовов (для _sum гистограммы Prometheus)
+  std::uint64_t size_sum = 0;
+  std::array<std::uint64_t, kS21SizeBuckets> size_histogram{};
+};
+
+struct S21ProfileSnapshot {
+  std::array<S21OperationStats, static_cast<int>(S21Operation::kCount)>
+      operations{};
+  const S21OperationStats &operator[](S21Operation op) const {
+    return operations[static_cast<int>(op)];
+  }
+};
+
+constexpr bool S21ProfilingEnabled() {
+#ifdef S21_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+S21ProfileSnapshot S21GetProfile();
+void S21ResetProfile();
+// снимок в текстовом формате Prometheus (метрики s21_matrix_*)
+std::string S21ProfilePrometheus();
+
+// Обратные вызовы трассировщика: begin - перед операцией, end - после нее
+// с длительностью в наносекундах. Вызываются из потока операции; nullptr
+// отключает соответствующий вызов.
+using S21TraceBegin = void (*)(S21Operation op, int rows, int cols);
+using S21TraceEnd = void (*)(S21Operation op, std::uint64_t nanoseconds);
+void S21SetTraceHooks(S21TraceBegin begin, S21TraceEnd end);
+
+#ifdef S21_PROFILING
+
+// замер одной операции: от создания до разрушения объекта
+class S21ProfileScope {
+ public:
+  S21ProfileScope(S21Operation op, int rows, int cols, double flops,
+                  double bytes);
+  ~S21ProfileScope();
+  S21ProfileScope(const S21ProfileScope &) = delete;
+  S21ProfileScope &operator=(const S21ProfileScope &) = delete;
+
+ private:
+  S21Operation op_;
+  int size_;
+  std::uint64_t flops_;
+  std::uint64_t bytes_;
+  std::uint64_t allocations_;
+  // false для вызова внутри другой операции
+  bool outer_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+#define S21_PROFILE_CONCAT_(a, b) a##b
+#define S21_PROFILE_NAME_(line) S21_PROFILE_CONCAT_(s21_profile_, line)
+#define S21_PROFILE(op, rows, cols, flops, bytes) \
+  S21ProfileScope S21_PROFILE_NAME_(__LINE__)(op, rows, cols, flops, bytes)
+
+#else
+
+#define S21_PROFILE(op, rows, cols, flops, bytes) \
+  do {                                            \
+  } while (false)
+
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// ширина панели: столько отражений собирается в одно блочное
+constexpr int kQrBlock = 32;
+// строки, по которым делится обновление остатка C -= V * W
+constexpr int kQrStrip = 256;
+
+// Отражение H = I - tau * v * v^T, переводящее x (len элементов с шагом
+// stride) в (beta, 0, ..., 0). На месте x остаются beta и v[1..] (v[0] = 1
+// не хранится). Для уже нулевого хвоста tau = 0, то есть H = I.
+template <typename T>
+T MakeReflector(int len, T *x, std::ptrdiff_t stride) {
+  T tail = 0;
+  for (int i = 1; i < len; i++) {
+    tail += x[i * stride] * x[i * stride];
+  }
+  if (tail == T(0)) {
+    return 0;
+  }
+  T alpha = x[0];
+  T norm = std::sqrt(alpha * alpha + tail);
+  T beta = alpha >= T(0) ? -norm : norm;
+  T scale = T(1) / (alpha - beta);
+  for (int i = 1; i < len; i++) {
+    x[i * stride] *= scale;
+  }
+  x[0] = beta;
+  return (beta - alpha) / beta;
+}
+
+// X = H * X для строк [0, rows) матрицы X и столбцов [first, last);
+// v[0] = 1, остальные элементы v лежат с шагом v_stride
+template <typename T>
+void ApplyReflector(int rows, const T *v, std::ptrdiff_t v_stride, T tau, T *x,
+                    std::ptrdiff_t x_stride, int first, int last, T *w) {
+  if (tau == T(0)) {
+    return;
+  }
+  for (int c = first; c < last; c++) {
+    w[c] = x[c];
+  }
+  for (int i = 1; i < rows; i++) {
+    T v_i = v[i * v_stride];
+    const T *row = x + i * x_stride;
+    for (int c = first; c < last; c++) {
+      w[c] += v_i * row[c];
+    }
+  }
+  for (int c = first; c < last; c++) {
+    w[c] *= tau;
+    x[c] -= w[c];
+  }
+  for (int i = 1; i < rows; i++) {
+    T v_i = v[i * v_stride];
+    T *row = x + i * x_stride;
+    for (int c = first; c < last; c++) {
+      row[c] -= v_i * w[c];
+    }
+  }
+}
+
+}  // namespace
+
+// На шаге k панель из kQrBlock столбцов раскладывается по одному
+// отражению, затем ее отражения собираются в H = I - V * T * V^T
+// (V - m_k x nb с единичной диагональю, T - верхнетреугольная nb x nb) и
+// применяются к остатку: W = V^T * C, W = T^T * W, C -= V * W. Оба
+// умножения идут через S21Gemm, так что почти вся работа - GEMM.
+template <typename T>
+S21BasicQR<T>::S21BasicQR(const S21BasicMatrix<T> &matrix)
+    : factors_(matrix), tau_(), full_rank_(true) {
+  if (matrix.GetRows() < matrix.GetCols()) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (std::is_integral<T>::value) {
+    throw std::logic_error("QR is not defined for integer matrices");
+  }
+  int m = factors_.GetRows();
+  int n = factors_.GetCols();
+  std::ptrdiff_t stride = factors_.Stride();
+  T *a = factors_.Data();
+  tau_.assign(n, T(0));
+  T threshold = S21BasicLU<T>::SingularThreshold(factors_);
+  std::vector<T> w(n);
+
+  for (int k = 0; k < n; k += kQrBlock) {
+    int nb = std::min(kQrBlock, n - k);
+    int mk = m - k;
+    T *panel = a + k * stride + k;
+    for (int j = 0; j < nb; j++) {
+      T *column = panel + j * stride + j;
+      tau_[k + j] = MakeReflector(mk - j, column, stride);
+      ApplyReflector(mk - j, column, stride, tau_[k + j], column, stride, 1,
+                     nb - j, w.data());
+    }
+    int first = k + nb;
+    int nc = n - first;
+    if (nc == 0) {
+      continue;
+    }
+
+    // V и V^T явно, с единицами на диагонали и нулями над ней
+    S21BasicScratchBuffer<T> v(static_cast<std::size_t>(mk) * nb);
+    S21BasicScratchBuffer<T> v_t(static_cast<std::size_t>(nb) * mk);
+    for (int r = 0; r < mk; r++) {
+      for (int l = 0; l < nb; l++) {
+        T value = r > l ? panel[r * stride + l] : T(r == l);
+        v.Get()[r * nb + l] = value;
+        v_t.Get()[l * mk + r] = value;
+      }
+    }
+    // T(0:j, j) = -tau_j * T(0:j, 0:j) * V(:, 0:j)^T * v_j
+    std::vector<T> t(static_cast<std::size_t>(nb) * nb, T(0));
+    std::vector<T> z(nb);
+    for (int j = 0; j < nb; j++) {
+      T tau = tau_[k + j];
+      t[j * nb + j] = tau;
+      for (int l = 0; l < j; l++) {
+        T sum = 0;
+        for (int r = j; r < mk; r++) {
+          sum += v.Get()[r * nb + l] * v.Get()[r * nb + j];
+        }
+        z[l] = sum;
+      }
+      for (int i = 0; i < j; i++) {
+        T sum = 0;
+        for (int l = i; l < j; l++) {
+          sum += t[i * nb + l] * z[l];
+        }
+        t[i * nb + j] = -tau * sum;
+      }
+    }
+
+    T *c = a + k * stride + first;
+    S21BasicScratchBuffer<T> wide(static_cast<std::size_t>(nb) * nc);
+    T *wm = wide.Get();
+    S21Gemm(nb, nc, mk, v_t.Get(), mk, c, stride, wm, nc);
+    // W = T^T * W снизу вверх, чтобы строки p < l были еще исходными
+    for (int l = nb - 1; l >= 0; l--) {
+      T *row_l = wm + l * nc;
+      T diagonal = t[l * nb + l];
+      for (int q = 0; q < nc; q++) {
+        row_l[q] *= diagonal;
+      }
+      for (int p = 0; p < l; p++) {
+        T factor = t[p * nb + l];
+        const T *row_p = wm + p * nc;
+        for (int q = 0; q < nc; q++) {
+          row_l[q] += factor * row_p[q];
+        }
+      }
+    }
+    int strips = (mk + kQrStrip - 1) / kQrStrip;
+    double work = 2.0 * mk * nc * nb;
+    S21ParallelFor(0, strips, work, [&](int from, int to) {
+      for (int strip = from; strip < to; strip++) {
+        int row0 = strip * kQrStrip;
+        int rows = std::min(kQrStrip, mk - row0);
+        S21BasicScratchBuffer<T> product(static_cast<std::size_t>(rows) * nc);
+        S21Gemm(rows, nc, nb, v.Get() + row0 * nb, nb, wm, nc, product.Get(),
+                nc);
+        for (int r = 0; r < rows; r++) {
+          T *row = c + (row0 + r) * stride;
+          const T *update = product.Get() + r * nc;
+          for (int q = 0; q < nc; q++) {
+            row[q] -= update[q];
+          }
+        }
+      }
+    });
+  }
+
+  for (int j = 0; j < n; j++) {
+    if (!(std::abs(a[j * stride + j]) > threshold)) {
+      full_rank_ = false;
+    }
+  }
+}
+
+template <typename T>
+bool S21BasicQR<T>::IsFullRank() const {
+  return full_rank_;
+}
+
+// каждое нетривиальное отражение меняет знак определителя
+template <typename T>
+T S21BasicQR<T>::Determinant() const {
+  if (factors_.GetRows() != factors_.GetCols()) {
+    throw std::length_error("Error: matrix size is wrong");
+  }
+  if (!full_rank_) {
+    return 0;
+  }
+  int n = factors_.GetCols();
+  T result = 1;
+  for (int k = 0; k < n; k++) {
+    result *= factors_.Data()[k * factors_.Stride() + k];
+    if (tau_[k] != T(0)) {
+      result = -result;
+    }
+  }
+  return result;
+}
+
+template <typename T>
+const S21BasicMatrix<T> &S21BasicQR<T>::Factors() const {
+  return factors_;
+}
+
+template <typename T>
+const std::vector<T> &S21BasicQR<T>::Tau() const {
+  return tau_;
+}
+
+// Q * E, где E - первые n столбцов единичной матрицы: отражения
+// применяются в обратном порядке
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::Q() const {
+  int m = factors_.GetRows();
+  int n = factors_.GetCols();
+  std::ptrdiff_t stride = factors_.Stride();
+  const T *a = factors_.Data();
+  S21BasicMatrix<T> result(m, n);
+  T *q = result.Data();
+  for (int k = 0; k < n; k++) {
+    q[k * result.Stride() + k] = 1;
+  }
+  double work = 2.0 * m * n * n;
+  S21ParallelFor(0, n, work, [&](int first, int last) {
+    std::vector<T> w(n);
+    for (int k = n - 1; k >= 0; k--) {
+      ApplyReflector(m - k, a + k * stride + k, stride, tau_[k],
+                     q + k * result.Stride(), result.Stride(), first, last,
+                     w.data());
+    }
+  });
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::R() const {
+  int n = factors_.GetCols();
+  S21BasicMatrix<T> result(n, n);
+  for (int i = 0; i < n; i++) {
+    const T *row = factors_.Data() + i * factors_.Stride();
+    std::copy(row + i, row + n, result.Data() + i * result.Stride() + i);
+  }
+  return result;
+}
+
+template <typename T>
+void S21BasicQR<T>::ApplyQt(S21BasicMatrix<T> *rhs) const {
+  int m = factors_.GetRows();
+  int n = factors_.GetCols();
+  std::ptrdiff_t stride = factors_.Stride();
+  const T *a = factors_.Data();
+  T *x = rhs->Data();
+  std::ptrdiff_t x_stride = rhs->Stride();
+  int cols = rhs->GetCols();
+  double work = 4.0 * m * n * cols;
+  S21ParallelFor(0, cols, work, [&](int first, int last) {
+    std::vector<T> w(cols);
+    for (int k = 0; k < n; k++) {
+      ApplyReflector(m - k, a + k * stride + k, stride, tau_[k],
+                     x + k * x_stride, x_stride, first, last, w.data());
+    }
+  });
+}
+
+// Q^T * rhs, затем обратный ход по R для первых n строк
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::Solve(const S21BasicMatrix<T> &rhs) const {
+  int m = factors_.GetRows();
+  int n = factors_.GetCols();
+  if (rhs.GetRows() != m) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  if (!full_rank_ || n == 0) {
+    throw std::logic_error("Мatrix is not invertible.");
+  }
+  S21BasicMatrix<T> projected = rhs;
+  ApplyQt(&projected);
+  int cols = rhs.GetCols();
+  S21BasicMatrix<T> result(n, cols);
+  T *x = result.Data();
+  std::ptrdiff_t stride = result.Stride();
+  for (int i = 0; i < n; i++) {
+    std::copy_n(projected.Data() + i * projected.Stride(), cols,
+                x + i * stride);
+  }
+  const T *r = factors_.Data();
+  std::ptrdiff_t r_stride = factors_.Stride();
+  double work = static_cast<double>(n) * n * cols;
+  S21ParallelFor(0, cols, work, [&](int first, int last) {
+    for (int i = n - 1; i >= 0; i--) {
+      T *row_i = x + i * stride;
+      for (int k = i + 1; k < n; k++) {
+        T factor = r[i * r_stride + k];
+        const T *row_k = x + k * stride;
+        for (int j = first; j < last; j++) {
+          row_i[j] -= factor * row_k[j];
+        }
+      }
+      T diagonal = r[i * r_stride + i];
+      for (int j = first; j < last; j++) {
+        row_i[j] /= diagonal;
+      }
+    }
+  });
+  return result;
+}
+
+#define S21_INSTANTIATE_QR(T) template class S21BasicQR<T>;
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_QR)
+#undef S21_INSTANTIATE_QR
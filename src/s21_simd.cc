@@ -0,0 +1,887 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+
+#include "s21_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_MATRIX_X86 1
+#include <immintrin.h>
+#endif
+
+// Поэлементные ядра: переносимая скалярная версия и векторные версии для
+// SSE2, AVX2 и AVX-512. Векторные функции собираются с атрибутом target,
+// поэтому библиотеку не нужно компилировать с -mavx*; подходящий набор
+// выбирается один раз при первом обращении по результатам CPUID.
+namespace {
+
+template <typename T>
+void AddScalar(std::size_t n, T *a, const T *b) {
+  for (std::size_t k = 0; k < n; k++) a[k] += b[k];
+}
+
+template <typename T>
+void SubScalar(std::size_t n, T *a, const T *b) {
+  for (std::size_t k = 0; k < n; k++) a[k] -= b[k];
+}
+
+template <typename T>
+void ScaleScalar(std::size_t n, T *a, T num) {
+  for (std::size_t k = 0; k < n; k++) a[k] *= num;
+}
+
+// сравнение как в EqMatrix: элементы различаются, если |a - b| > tolerance
+template <typename T>
+bool EqualScalar(std::size_t n, const T *a, const T *b, T tolerance) {
+  for (std::size_t k = 0; k < n; k++) {
+    if (std::abs(a[k] - b[k]) > tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void TransposeScalar(int rows, int cols, const T *src, std::ptrdiff_t lds,
+                     T *dst, std::ptrdiff_t ldd) {
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      dst[j * ldd + i] = src[i * lds + j];
+    }
+  }
+}
+
+template <typename T>
+T DotScalar(std::size_t n, const T *a, const T *b) {
+  T sum = 0;
+  for (std::size_t k = 0; k < n; k++) sum += a[k] * b[k];
+  return sum;
+}
+
+template <typename T>
+void AxpyScalar(std::size_t n, T *a, const T *b, T num) {
+  for (std::size_t k = 0; k < n; k++) a[k] += num * b[k];
+}
+
+// дописывает края блока, не покрытые векторной частью (последние строки и
+// столбцы, не кратные ширине)
+template <typename T>
+void TransposeEdges(int rows, int cols, int done_rows, int done_cols,
+                    const T *src, std::ptrdiff_t lds, T *dst,
+                    std::ptrdiff_t ldd) {
+  TransposeScalar(rows - done_rows, cols, src + done_rows * lds, lds,
+                  dst + done_rows, ldd);
+  TransposeScalar(done_rows, cols - done_cols, src + done_cols, lds,
+                  dst + done_cols * ldd, ldd);
+}
+
+#ifdef S21_MATRIX_X86
+
+// Транспонирование только переставляет 64-битные слова, поэтому одни и те
+// же ядра служат для double и int64_t; загрузки и записи через intrinsics
+// не нарушают правил алиасинга.
+template <typename T>
+const double *Words(const T *p) {
+  static_assert(sizeof(T) == sizeof(double), "64-bit elements only");
+  return reinterpret_cast<const double *>(p);
+}
+
+template <typename T>
+double *Words(T *p) {
+  static_assert(sizeof(T) == sizeof(double), "64-bit elements only");
+  return reinterpret_cast<double *>(p);
+}
+
+template <typename T>
+__attribute__((target("sse2"))) void TransposeSse2(int rows, int cols,
+                                                   const T *src,
+                                                   std::ptrdiff_t lds, T *dst,
+                                                   std::ptrdiff_t ldd) {
+  int rows2 = rows / 2 * 2;
+  int cols2 = cols / 2 * 2;
+  for (int i = 0; i < rows2; i += 2) {
+    for (int j = 0; j < cols2; j += 2) {
+      __m128d r0 = _mm_loadu_pd(Words(src + i * lds + j));
+      __m128d r1 = _mm_loadu_pd(Words(src + (i + 1) * lds + j));
+      _mm_storeu_pd(Words(dst + j * ldd + i), _mm_unpacklo_pd(r0, r1));
+      _mm_storeu_pd(Words(dst + (j + 1) * ldd + i), _mm_unpackhi_pd(r0, r1));
+    }
+  }
+  TransposeEdges(rows, cols, rows2, cols2, src, lds, dst, ldd);
+}
+
+__attribute__((target("sse2"))) void AddSse2(std::size_t n, double *a,
+                                             const double *b) {
+  std::size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    _mm_storeu_pd(a + k, _mm_add_pd(_mm_loadu_pd(a + k), _mm_loadu_pd(b + k)));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("sse2"))) void SubSse2(std::size_t n, double *a,
+                                             const double *b) {
+  std::size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    _mm_storeu_pd(a + k, _mm_sub_pd(_mm_loadu_pd(a + k), _mm_loadu_pd(b + k)));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("sse2"))) void ScaleSse2(std::size_t n, double *a,
+                                               double num) {
+  __m128d factor = _mm_set1_pd(num);
+  std::size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    _mm_storeu_pd(a + k, _mm_mul_pd(_mm_loadu_pd(a + k), factor));
+  }
+  ScaleScalar(n - k, a + k, num);
+}
+
+__attribute__((target("sse2"))) bool EqualSse2(std::size_t n, const double *a,
+                                               const double *b,
+                                               double tolerance) {
+  __m128d limit = _mm_set1_pd(tolerance);
+  __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+  std::size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    __m128d diff = _mm_sub_pd(_mm_loadu_pd(a + k), _mm_loadu_pd(b + k));
+    if (_mm_movemask_pd(_mm_cmpgt_pd(_mm_and_pd(diff, abs_mask), limit))) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+// транспонирование блоками 4 x 4 в регистрах
+template <typename T>
+__attribute__((target("avx2"))) void TransposeAvx2(int rows, int cols,
+                                                   const T *src,
+                                                   std::ptrdiff_t lds, T *dst,
+                                                   std::ptrdiff_t ldd) {
+  int rows4 = rows / 4 * 4;
+  int cols4 = cols / 4 * 4;
+  for (int i = 0; i < rows4; i += 4) {
+    for (int j = 0; j < cols4; j += 4) {
+      const double *s = Words(src + i * lds + j);
+      __m256d r0 = _mm256_loadu_pd(s);
+      __m256d r1 = _mm256_loadu_pd(s + lds);
+      __m256d r2 = _mm256_loadu_pd(s + 2 * lds);
+      __m256d r3 = _mm256_loadu_pd(s + 3 * lds);
+      __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+      __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+      __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+      __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+      double *d = Words(dst + j * ldd + i);
+      _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+      _mm256_storeu_pd(d + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+      _mm256_storeu_pd(d + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+      _mm256_storeu_pd(d + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+    }
+  }
+  TransposeEdges(rows, cols, rows4, cols4, src, lds, dst, ldd);
+}
+
+__attribute__((target("avx2"))) void AddAvx2(std::size_t n, double *a,
+                                             const double *b) {
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm256_storeu_pd(
+        a + k, _mm256_add_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(b + k)));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) void SubAvx2(std::size_t n, double *a,
+                                             const double *b) {
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm256_storeu_pd(
+        a + k, _mm256_sub_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(b + k)));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) void ScaleAvx2(std::size_t n, double *a,
+                                               double num) {
+  __m256d factor = _mm256_set1_pd(num);
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm256_storeu_pd(a + k, _mm256_mul_pd(_mm256_loadu_pd(a + k), factor));
+  }
+  ScaleScalar(n - k, a + k, num);
+}
+
+__attribute__((target("avx2"))) bool EqualAvx2(std::size_t n, const double *a,
+                                               const double *b,
+                                               double tolerance) {
+  __m256d limit = _mm256_set1_pd(tolerance);
+  __m256d abs_mask =
+      _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    __m256d diff =
+        _mm256_sub_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(b + k));
+    __m256d greater =
+        _mm256_cmp_pd(_mm256_and_pd(diff, abs_mask), limit, _CMP_GT_OQ);
+    if (_mm256_movemask_pd(greater)) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+__attribute__((target("avx512f"))) void AddAvx512(std::size_t n, double *a,
+                                                  const double *b) {
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm512_storeu_pd(
+        a + k, _mm512_add_pd(_mm512_loadu_pd(a + k), _mm512_loadu_pd(b + k)));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(std::size_t n, double *a,
+                                                  const double *b) {
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm512_storeu_pd(
+        a + k, _mm512_sub_pd(_mm512_loadu_pd(a + k), _mm512_loadu_pd(b + k)));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(std::size_t n, double *a,
+                                                    double num) {
+  __m512d factor = _mm512_set1_pd(num);
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm512_storeu_pd(a + k, _mm512_mul_pd(_mm512_loadu_pd(a + k), factor));
+  }
+  ScaleScalar(n - k, a + k, num);
+}
+
+__attribute__((target("avx512f"))) bool EqualAvx512(std::size_t n,
+                                                    const double *a,
+                                                    const double *b,
+                                                    double tolerance) {
+  __m512d limit = _mm512_set1_pd(tolerance);
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m512d diff = _mm512_abs_pd(
+        _mm512_sub_pd(_mm512_loadu_pd(a + k), _mm512_loadu_pd(b + k)));
+    if (_mm512_cmp_pd_mask(diff, limit, _CMP_GT_OQ)) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+// Скалярное произведение копит суммы в нескольких регистрах, чтобы
+// сложения не ждали друг друга. FMA входит только в AVX-512F, поэтому в
+// SSE2 и AVX2 умножение и сложение раздельные.
+__attribute__((target("sse2"))) double DotSse2(std::size_t n, const double *a,
+                                               const double *b) {
+  __m128d sum0 = _mm_setzero_pd();
+  __m128d sum1 = _mm_setzero_pd();
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a + k),
+                                       _mm_loadu_pd(b + k)));
+    sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a + k + 2),
+                                       _mm_loadu_pd(b + k + 2)));
+  }
+  __m128d sum = _mm_add_pd(sum0, sum1);
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+  return _mm_cvtsd_f64(sum) + DotScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("sse2"))) void AxpySse2(std::size_t n, double *a,
+                                              const double *b, double num) {
+  __m128d factor = _mm_set1_pd(num);
+  std::size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    _mm_storeu_pd(a + k, _mm_add_pd(_mm_loadu_pd(a + k),
+                                    _mm_mul_pd(_mm_loadu_pd(b + k), factor)));
+  }
+  AxpyScalar(n - k, a + k, b + k, num);
+}
+
+__attribute__((target("avx2"))) double DotAvx2(std::size_t n, const double *a,
+                                               const double *b) {
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(a + k),
+                                             _mm256_loadu_pd(b + k)));
+    sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(a + k + 4),
+                                             _mm256_loadu_pd(b + k + 4)));
+  }
+  __m256d wide = _mm256_add_pd(sum0, sum1);
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(wide),
+                           _mm256_extractf128_pd(wide, 1));
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+  return _mm_cvtsd_f64(sum) + DotScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) void AxpyAvx2(std::size_t n, double *a,
+                                              const double *b, double num) {
+  __m256d factor = _mm256_set1_pd(num);
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm256_storeu_pd(
+        a + k, _mm256_add_pd(_mm256_loadu_pd(a + k),
+                             _mm256_mul_pd(_mm256_loadu_pd(b + k), factor)));
+  }
+  AxpyScalar(n - k, a + k, b + k, num);
+}
+
+__attribute__((target("avx512f"))) double DotAvx512(std::size_t n,
+                                                    const double *a,
+                                                    const double *b) {
+  __m512d sum0 = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  std::size_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + k), _mm512_loadu_pd(b + k),
+                           sum0);
+    sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + k + 8),
+                           _mm512_loadu_pd(b + k + 8), sum1);
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1)) +
+         DotScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void AxpyAvx512(std::size_t n, double *a,
+                                                   const double *b,
+                                                   double num) {
+  __m512d factor = _mm512_set1_pd(num);
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm512_storeu_pd(a + k, _mm512_fmadd_pd(_mm512_loadu_pd(b + k), factor,
+                                            _mm512_loadu_pd(a + k)));
+  }
+  AxpyScalar(n - k, a + k, b + k, num);
+}
+
+// float: те же операции на вдвое большем числе элементов в регистре
+
+__attribute__((target("sse2"))) void AddSse2(std::size_t n, float *a,
+                                             const float *b) {
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm_storeu_ps(a + k, _mm_add_ps(_mm_loadu_ps(a + k), _mm_loadu_ps(b + k)));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("sse2"))) void SubSse2(std::size_t n, float *a,
+                                             const float *b) {
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm_storeu_ps(a + k, _mm_sub_ps(_mm_loadu_ps(a + k), _mm_loadu_ps(b + k)));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("sse2"))) void ScaleSse2(std::size_t n, float *a,
+                                               float num) {
+  __m128 factor = _mm_set1_ps(num);
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm_storeu_ps(a + k, _mm_mul_ps(_mm_loadu_ps(a + k), factor));
+  }
+  ScaleScalar(n - k, a + k, num);
+}
+
+__attribute__((target("sse2"))) bool EqualSse2(std::size_t n, const float *a,
+                                               const float *b,
+                                               float tolerance) {
+  __m128 limit = _mm_set1_ps(tolerance);
+  __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    __m128 diff = _mm_sub_ps(_mm_loadu_ps(a + k), _mm_loadu_ps(b + k));
+    if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_and_ps(diff, abs_mask), limit))) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+// транспонирование блоками 4 x 4 в регистрах SSE
+__attribute__((target("sse2"))) void TransposeSse2(int rows, int cols,
+                                                   const float *src,
+                                                   std::ptrdiff_t lds,
+                                                   float *dst,
+                                                   std::ptrdiff_t ldd) {
+  int rows4 = rows / 4 * 4;
+  int cols4 = cols / 4 * 4;
+  for (int i = 0; i < rows4; i += 4) {
+    for (int j = 0; j < cols4; j += 4) {
+      const float *s = src + i * lds + j;
+      __m128 r0 = _mm_loadu_ps(s);
+      __m128 r1 = _mm_loadu_ps(s + lds);
+      __m128 r2 = _mm_loadu_ps(s + 2 * lds);
+      __m128 r3 = _mm_loadu_ps(s + 3 * lds);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      float *d = dst + j * ldd + i;
+      _mm_storeu_ps(d, r0);
+      _mm_storeu_ps(d + ldd, r1);
+      _mm_storeu_ps(d + 2 * ldd, r2);
+      _mm_storeu_ps(d + 3 * ldd, r3);
+    }
+  }
+  TransposeEdges(rows, cols, rows4, cols4, src, lds, dst, ldd);
+}
+
+__attribute__((target("avx2"))) void AddAvx2(std::size_t n, float *a,
+                                             const float *b) {
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm256_storeu_ps(
+        a + k, _mm256_add_ps(_mm256_loadu_ps(a + k), _mm256_loadu_ps(b + k)));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) void SubAvx2(std::size_t n, float *a,
+                                             const float *b) {
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm256_storeu_ps(
+        a + k, _mm256_sub_ps(_mm256_loadu_ps(a + k), _mm256_loadu_ps(b + k)));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) void ScaleAvx2(std::size_t n, float *a,
+                                               float num) {
+  __m256 factor = _mm256_set1_ps(num);
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm256_storeu_ps(a + k, _mm256_mul_ps(_mm256_loadu_ps(a + k), factor));
+  }
+  ScaleScalar(n - k, a + k, num);
+}
+
+__attribute__((target("avx2"))) bool EqualAvx2(std::size_t n, const float *a,
+                                               const float *b,
+                                               float tolerance) {
+  __m256 limit = _mm256_set1_ps(tolerance);
+  __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + k), _mm256_loadu_ps(b + k));
+    __m256 greater =
+        _mm256_cmp_ps(_mm256_and_ps(diff, abs_mask), limit, _CMP_GT_OQ);
+    if (_mm256_movemask_ps(greater)) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+__attribute__((target("avx512f"))) void AddAvx512(std::size_t n, float *a,
+                                                  const float *b) {
+  std::size_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    _mm512_storeu_ps(
+        a + k, _mm512_add_ps(_mm512_loadu_ps(a + k), _mm512_loadu_ps(b + k)));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(std::size_t n, float *a,
+                                                  const float *b) {
+  std::size_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    _mm512_storeu_ps(
+        a + k, _mm512_sub_ps(_mm512_loadu_ps(a + k), _mm512_loadu_ps(b + k)));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(std::size_t n, float *a,
+                                                    float num) {
+  __m512 factor = _mm512_set1_ps(num);
+  std::size_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    _mm512_storeu_ps(a + k, _mm512_mul_ps(_mm512_loadu_ps(a + k), factor));
+  }
+  ScaleScalar(n - k, a + k, num);
+}
+
+__attribute__((target("avx512f"))) bool EqualAvx512(std::size_t n,
+                                                    const float *a,
+                                                    const float *b,
+                                                    float tolerance) {
+  __m512 limit = _mm512_set1_ps(tolerance);
+  std::size_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    __m512 diff = _mm512_abs_ps(
+        _mm512_sub_ps(_mm512_loadu_ps(a + k), _mm512_loadu_ps(b + k)));
+    if (_mm512_cmp_ps_mask(diff, limit, _CMP_GT_OQ)) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+__attribute__((target("sse2"))) float DotSse2(std::size_t n, const float *a,
+                                              const float *b) {
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + k),
+                                       _mm_loadu_ps(b + k)));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + k + 4),
+                                       _mm_loadu_ps(b + k + 4)));
+  }
+  __m128 sum = _mm_add_ps(sum0, sum1);
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum) + DotScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("sse2"))) void AxpySse2(std::size_t n, float *a,
+                                              const float *b, float num) {
+  __m128 factor = _mm_set1_ps(num);
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    _mm_storeu_ps(a + k, _mm_add_ps(_mm_loadu_ps(a + k),
+                                    _mm_mul_ps(_mm_loadu_ps(b + k), factor)));
+  }
+  AxpyScalar(n - k, a + k, b + k, num);
+}
+
+__attribute__((target("avx2"))) float DotAvx2(std::size_t n, const float *a,
+                                              const float *b) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  std::size_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + k),
+                                             _mm256_loadu_ps(b + k)));
+    sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(a + k + 8),
+                                             _mm256_loadu_ps(b + k + 8)));
+  }
+  __m256 wide = _mm256_add_ps(sum0, sum1);
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(wide),
+                          _mm256_extractf128_ps(wide, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum) + DotScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) void AxpyAvx2(std::size_t n, float *a,
+                                              const float *b, float num) {
+  __m256 factor = _mm256_set1_ps(num);
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm256_storeu_ps(
+        a + k, _mm256_add_ps(_mm256_loadu_ps(a + k),
+                             _mm256_mul_ps(_mm256_loadu_ps(b + k), factor)));
+  }
+  AxpyScalar(n - k, a + k, b + k, num);
+}
+
+__attribute__((target("avx512f"))) float DotAvx512(std::size_t n,
+                                                   const float *a,
+                                                   const float *b) {
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  std::size_t k = 0;
+  for (; k + 32 <= n; k += 32) {
+    sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + k), _mm512_loadu_ps(b + k),
+                           sum0);
+    sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + k + 16),
+                           _mm512_loadu_ps(b + k + 16), sum1);
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1)) +
+         DotScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void AxpyAvx512(std::size_t n, float *a,
+                                                   const float *b,
+                                                   float num) {
+  __m512 factor = _mm512_set1_ps(num);
+  std::size_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    _mm512_storeu_ps(a + k, _mm512_fmadd_ps(_mm512_loadu_ps(b + k), factor,
+                                            _mm512_loadu_ps(a + k)));
+  }
+  AxpyScalar(n - k, a + k, b + k, num);
+}
+
+// int64_t: сложение и вычитание есть во всех наборах, умножение 64-битных
+// целых - только в AVX-512 (в SSE2 и AVX2 остается скалярным). Целые
+// сравниваются векторно только при нулевом допуске, как в
+// S21MatrixTraits<std::int64_t>.
+
+__attribute__((target("sse2"))) void AddSse2(std::size_t n, std::int64_t *a,
+                                             const std::int64_t *b) {
+  std::size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    __m128i *to = reinterpret_cast<__m128i *>(a + k);
+    __m128i from = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + k));
+    _mm_storeu_si128(to, _mm_add_epi64(_mm_loadu_si128(to), from));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("sse2"))) void SubSse2(std::size_t n, std::int64_t *a,
+                                             const std::int64_t *b) {
+  std::size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    __m128i *to = reinterpret_cast<__m128i *>(a + k);
+    __m128i from = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + k));
+    _mm_storeu_si128(to, _mm_sub_epi64(_mm_loadu_si128(to), from));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+// 64-битные слова равны, когда равны обе 32-битные половины
+__attribute__((target("sse2"))) bool EqualSse2(std::size_t n,
+                                               const std::int64_t *a,
+                                               const std::int64_t *b,
+                                               std::int64_t tolerance) {
+  std::size_t k = 0;
+  for (; tolerance == 0 && k + 2 <= n; k += 2) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + k));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + k));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(x, y)) != 0xffff) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+__attribute__((target("avx2"))) void AddAvx2(std::size_t n, std::int64_t *a,
+                                             const std::int64_t *b) {
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    __m256i *to = reinterpret_cast<__m256i *>(a + k);
+    __m256i from =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+    _mm256_storeu_si256(to, _mm256_add_epi64(_mm256_loadu_si256(to), from));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) void SubAvx2(std::size_t n, std::int64_t *a,
+                                             const std::int64_t *b) {
+  std::size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    __m256i *to = reinterpret_cast<__m256i *>(a + k);
+    __m256i from =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+    _mm256_storeu_si256(to, _mm256_sub_epi64(_mm256_loadu_si256(to), from));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx2"))) bool EqualAvx2(std::size_t n,
+                                               const std::int64_t *a,
+                                               const std::int64_t *b,
+                                               std::int64_t tolerance) {
+  std::size_t k = 0;
+  for (; tolerance == 0 && k + 4 <= n; k += 4) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + k));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + k));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(x, y)) != -1) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+__attribute__((target("avx512f"))) void AddAvx512(std::size_t n,
+                                                  std::int64_t *a,
+                                                  const std::int64_t *b) {
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm512_storeu_si512(a + k, _mm512_add_epi64(_mm512_loadu_si512(a + k),
+                                                _mm512_loadu_si512(b + k)));
+  }
+  AddScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(std::size_t n,
+                                                  std::int64_t *a,
+                                                  const std::int64_t *b) {
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm512_storeu_si512(a + k, _mm512_sub_epi64(_mm512_loadu_si512(a + k),
+                                                _mm512_loadu_si512(b + k)));
+  }
+  SubScalar(n - k, a + k, b + k);
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(std::size_t n,
+                                                    std::int64_t *a,
+                                                    std::int64_t num) {
+  __m512i factor = _mm512_set1_epi64(num);
+  std::size_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    _mm512_storeu_si512(a + k,
+                        _mm512_mullox_epi64(_mm512_loadu_si512(a + k), factor));
+  }
+  ScaleScalar(n - k, a + k, num);
+}
+
+__attribute__((target("avx512f"))) bool EqualAvx512(std::size_t n,
+                                                    const std::int64_t *a,
+                                                    const std::int64_t *b,
+                                                    std::int64_t tolerance) {
+  std::size_t k = 0;
+  for (; tolerance == 0 && k + 8 <= n; k += 8) {
+    if (_mm512_cmpneq_epi64_mask(_mm512_loadu_si512(a + k),
+                                 _mm512_loadu_si512(b + k))) {
+      return false;
+    }
+  }
+  return EqualScalar(n - k, a + k, b + k, tolerance);
+}
+
+#endif
+
+// Таблицы ядер по типам. Векторные таблицы собираются из перегрузок выше;
+// чего нет в наборе для данного типа, берется из скалярной версии.
+template <typename T>
+struct KernelTables {
+  static const S21BasicElementwiseKernels<T> kScalar;
+};
+
+template <typename T>
+const S21BasicElementwiseKernels<T> KernelTables<T>::kScalar = {
+    S21Isa::kScalar, AddScalar<T>, SubScalar<T>, ScaleScalar<T>,
+    EqualScalar<T>, TransposeScalar<T>, DotScalar<T>, AxpyScalar<T>};
+
+#ifdef S21_MATRIX_X86
+template <typename T>
+struct VectorTables {
+  static const S21BasicElementwiseKernels<T> kSse2;
+  static const S21BasicElementwiseKernels<T> kAvx2;
+  static const S21BasicElementwiseKernels<T> kAvx512;
+};
+
+template <>
+const S21BasicElementwiseKernels<double> VectorTables<double>::kSse2 = {
+    S21Isa::kSse2, AddSse2, SubSse2, ScaleSse2, EqualSse2,
+    TransposeSse2<double>, DotSse2, AxpySse2};
+template <>
+const S21BasicElementwiseKernels<double> VectorTables<double>::kAvx2 = {
+    S21Isa::kAvx2, AddAvx2, SubAvx2, ScaleAvx2, EqualAvx2,
+    TransposeAvx2<double>, DotAvx2, AxpyAvx2};
+// для транспонирования 4 x 4 в регистрах AVX2 достаточно, а процессоры с
+// AVX-512 его поддерживают
+template <>
+const S21BasicElementwiseKernels<double> VectorTables<double>::kAvx512 = {
+    S21Isa::kAvx512, AddAvx512, SubAvx512, ScaleAvx512, EqualAvx512,
+    TransposeAvx2<double>, DotAvx512, AxpyAvx512};
+
+template <>
+const S21BasicElementwiseKernels<float> VectorTables<float>::kSse2 = {
+    S21Isa::kSse2, AddSse2, SubSse2, ScaleSse2, EqualSse2, TransposeSse2,
+    DotSse2, AxpySse2};
+template <>
+const S21BasicElementwiseKernels<float> VectorTables<float>::kAvx2 = {
+    S21Isa::kAvx2, AddAvx2, SubAvx2, ScaleAvx2, EqualAvx2, TransposeSse2,
+    DotAvx2, AxpyAvx2};
+template <>
+const S21BasicElementwiseKernels<float> VectorTables<float>::kAvx512 = {
+    S21Isa::kAvx512, AddAvx512, SubAvx512, ScaleAvx512, EqualAvx512,
+    TransposeSse2, DotAvx512, AxpyAvx512};
+
+// векторного умножения 64-битных целых со сложением нет, dot и axpy
+// скалярные
+template <>
+const S21BasicElementwiseKernels<std::int64_t>
+    VectorTables<std::int64_t>::kSse2 = {
+        S21Isa::kSse2, AddSse2, SubSse2, ScaleScalar<std::int64_t>,
+        EqualSse2, TransposeSse2<std::int64_t>, DotScalar<std::int64_t>,
+        AxpyScalar<std::int64_t>};
+template <>
+const S21BasicElementwiseKernels<std::int64_t>
+    VectorTables<std::int64_t>::kAvx2 = {
+        S21Isa::kAvx2, AddAvx2, SubAvx2, ScaleScalar<std::int64_t>,
+        EqualAvx2, TransposeAvx2<std::int64_t>, DotScalar<std::int64_t>,
+        AxpyScalar<std::int64_t>};
+template <>
+const S21BasicElementwiseKernels<std::int64_t>
+    VectorTables<std::int64_t>::kAvx512 = {
+        S21Isa::kAvx512, AddAvx512, SubAvx512, ScaleAvx512, EqualAvx512,
+        TransposeAvx2<std::int64_t>, DotScalar<std::int64_t>,
+        AxpyScalar<std::int64_t>};
+#endif
+
+bool IsaSupported(S21Isa isa) {
+  switch (isa) {
+    case S21Isa::kScalar:
+      return true;
+#ifdef S21_MATRIX_X86
+    case S21Isa::kSse2:
+      return __builtin_cpu_supports("sse2");
+    case S21Isa::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case S21Isa::kAvx512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+const S21BasicElementwiseKernels<T> &SelectKernels() {
+  const S21BasicElementwiseKernels<T> *best = &KernelTables<T>::kScalar;
+  for (S21Isa isa : {S21Isa::kAvx512, S21Isa::kAvx2, S21Isa::kSse2}) {
+    const S21BasicElementwiseKernels<T> *kernels = S21KernelsFor<T>(isa);
+    if (kernels != nullptr) {
+      best = kernels;
+      break;
+    }
+  }
+  return *best;
+}
+
+}  // namespace
+
+template <typename T>
+const S21BasicElementwiseKernels<T> *S21KernelsFor(S21Isa isa) {
+  if (!IsaSupported(isa)) {
+    return nullptr;
+  }
+#ifdef S21_MATRIX_X86
+  // long double обрабатывается x87 и векторных версий не имеет
+  if constexpr (!std::is_same<T, long double>::value) {
+    switch (isa) {
+      case S21Isa::kSse2:
+        return &VectorTables<T>::kSse2;
+      case S21Isa::kAvx2:
+        return &VectorTables<T>::kAvx2;
+      case S21Isa::kAvx512:
+        return &VectorTables<T>::kAvx512;
+      default:
+        break;
+    }
+  }
+#endif
+  return isa == S21Isa::kScalar ? &KernelTables<T>::kScalar : nullptr;
+}
+
+template <typename T>
+const S21BasicElementwiseKernels<T> &S21ActiveKernels() {
+  static const S21BasicElementwiseKernels<T> &kernels = SelectKernels<T>();
+  return kernels;
+}
+
+#define S21_INSTANTIATE_KERNELS(T)                                       \
+  template const S21BasicElementwiseKernels<T> *S21KernelsFor<T>(S21Isa); \
+  template const S21BasicElementwiseKernels<T> &S21ActiveKernels<T>();
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_KERNELS)
+#undef S21_INSTANTIATE_KERNELS
@@ -0,0 +1,367 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+S21SparseMatrix::S21SparseMatrix()
+    : rows_(0), cols_(0), row_offsets_(1, 0), col_indices_(), values_() {}
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols)
+    : rows_(rows),
+      cols_(cols),
+      row_offsets_(),
+      col_indices_(),
+      values_() {
+  if (rows < 0 || cols < 0) {
+    throw std::invalid_argument("Invalid rows or/and columns!");
+  }
+  row_offsets_.assign(rows + 1, 0);
+}
+
+S21SparseMatrix::S21SparseMatrix(const S21Matrix &dense,
+                                 double drop_tolerance)
+    : S21SparseMatrix(dense.GetRows(), dense.GetCols()) {
+  const double *data = dense.Data();
+  std::ptrdiff_t stride = dense.Stride();
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      double value = data[i * stride + j];
+      if (std::fabs(value) > drop_tolerance) {
+        col_indices_.push_back(j);
+        values_.push_back(value);
+      }
+    }
+    row_offsets_[i + 1] = static_cast<int>(values_.size());
+  }
+}
+
+// сортировка по (строка, столбец), затем слияние повторов за один проход
+S21SparseMatrix::S21SparseMatrix(int rows, int cols,
+                                 const std::vector<S21Triplet> &triplets)
+    : S21SparseMatrix(rows, cols) {
+  std::vector<S21Triplet> sorted = triplets;
+  for (const S21Triplet &t : sorted) {
+    if (t.row < 0 || t.col < 0 || t.row >= rows_ || t.col >= cols_) {
+      throw std::out_of_range("Invalid rows or/and columns!");
+    }
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const S21Triplet &a, const S21Triplet &b) {
+              return a.row != b.row ? a.row < b.row : a.col < b.col;
+            });
+  for (std::size_t p = 0; p < sorted.size();) {
+    S21Triplet t = sorted[p++];
+    while (p < sorted.size() && sorted[p].row == t.row &&
+           sorted[p].col == t.col) {
+      t.value += sorted[p++].value;
+    }
+    if (t.value != 0.0) {
+      col_indices_.push_back(t.col);
+      values_.push_back(t.value);
+      row_offsets_[t.row + 1]++;
+    }
+  }
+  for (int i = 0; i < rows_; i++) {
+    row_offsets_[i + 1] += row_offsets_[i];
+  }
+}
+
+// CSC матрицы A - это CSR матрицы A^T, поэтому преобразование в обе
+// стороны - одно и то же транспонирование подсчетом
+S21SparseMatrix::S21SparseMatrix(const S21CscMatrix &csc)
+    : S21SparseMatrix(csc.cols, csc.rows) {
+  row_offsets_ = csc.col_offsets;
+  col_indices_ = csc.row_indices;
+  values_ = csc.values;
+  *this = Transpose();
+}
+
+int S21SparseMatrix::GetRows() const { return rows_; }
+
+int S21SparseMatrix::GetCols() const { return cols_; }
+
+std::size_t S21SparseMatrix::NonZeros() const { return values_.size(); }
+
+double S21SparseMatrix::operator()(int row, int col) const {
+  if (row < 0 || col < 0 || col >= cols_ || row >= rows_) {
+    throw std::out_of_range("Invalid rows or/and columns!");
+  }
+  auto first = col_indices_.begin() + row_offsets_[row];
+  auto last = col_indices_.begin() + row_offsets_[row + 1];
+  auto it = std::lower_bound(first, last, col);
+  return it != last && *it == col ? values_[it - col_indices_.begin()] : 0.0;
+}
+
+const std::vector<int> &S21SparseMatrix::RowOffsets() const {
+  return row_offsets_;
+}
+
+const std::vector<int> &S21SparseMatrix::ColIndices() const {
+  return col_indices_;
+}
+
+const std::vector<double> &S21SparseMatrix::Values() const { return values_; }
+
+S21Matrix S21SparseMatrix::ToDense() const {
+  S21Matrix result(rows_, cols_);
+  return std::move(result) + *this;
+}
+
+S21CscMatrix S21SparseMatrix::ToCsc() const {
+  S21SparseMatrix transposed = Transpose();
+  S21CscMatrix result;
+  result.rows = rows_;
+  result.cols = cols_;
+  result.col_offsets = std::move(transposed.row_offsets_);
+  result.row_indices = std::move(transposed.col_indices_);
+  result.values = std::move(transposed.values_);
+  return result;
+}
+
+// подсчет элементов в каждом столбце, затем раскладка по строкам
+// результата; строки обходятся по порядку, так что столбцы внутри строк
+// результата сразу упорядочены
+S21SparseMatrix S21SparseMatrix::Transpose() const {
+  S21SparseMatrix result(cols_, rows_);
+  result.col_indices_.resize(values_.size());
+  result.values_.resize(values_.size());
+  for (int col : col_indices_) {
+    result.row_offsets_[col + 1]++;
+  }
+  for (int j = 0; j < cols_; j++) {
+    result.row_offsets_[j + 1] += result.row_offsets_[j];
+  }
+  std::vector<int> next(result.row_offsets_.begin(),
+                        result.row_offsets_.end() - 1);
+  for (int i = 0; i < rows_; i++) {
+    for (int p = row_offsets_[i]; p < row_offsets_[i + 1]; p++) {
+      int q = next[col_indices_[p]]++;
+      result.col_indices_[q] = i;
+      result.values_[q] = values_[p];
+    }
+  }
+  return result;
+}
+
+// сравнение с той же точностью, что у S21Matrix; элемент, которого нет в
+// одной из матриц, сравнивается с нулем
+bool S21SparseMatrix::EqMatrix(const S21SparseMatrix &other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    return false;
+  }
+  S21SparseMatrix diff = *this - other;
+  return std::all_of(diff.values_.begin(), diff.values_.end(),
+                     [](double value) { return std::fabs(value) <= epsilon; });
+}
+
+bool S21SparseMatrix::operator==(const S21SparseMatrix &other) const {
+  return EqMatrix(other);
+}
+
+void S21SparseMatrix::SumMatrix(const S21SparseMatrix &other) {
+  *this = Merge(other, 1.0);
+}
+
+void S21SparseMatrix::SubMatrix(const S21SparseMatrix &other) {
+  *this = Merge(other, -1.0);
+}
+
+void S21SparseMatrix::MulNumber(double num) {
+  if (num == 0.0) {
+    *this = S21SparseMatrix(rows_, cols_);
+    return;
+  }
+  for (double &value : values_) {
+    value *= num;
+  }
+}
+
+S21SparseMatrix S21SparseMatrix::operator+(const S21SparseMatrix &other) const {
+  return Merge(other, 1.0);
+}
+
+S21SparseMatrix S21SparseMatrix::operator-(const S21SparseMatrix &other) const {
+  return Merge(other, -1.0);
+}
+
+S21SparseMatrix S21SparseMatrix::operator*(double num) const {
+  S21SparseMatrix result = *this;
+  result.MulNumber(num);
+  return result;
+}
+
+// слияние упорядоченных строк за O(nnz(A) + nnz(B)); точные нули,
+// получившиеся при сокращении, не хранятся
+S21SparseMatrix S21SparseMatrix::Merge(const S21SparseMatrix &other,
+                                       double sign) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  S21SparseMatrix result(rows_, cols_);
+  result.col_indices_.reserve(values_.size() + other.values_.size());
+  result.values_.reserve(values_.size() + other.values_.size());
+  auto push = [&result](int col, double value) {
+    if (value != 0.0) {
+      result.col_indices_.push_back(col);
+      result.values_.push_back(value);
+    }
+  };
+  for (int i = 0; i < rows_; i++) {
+    int p = row_offsets_[i], p_end = row_offsets_[i + 1];
+    int q = other.row_offsets_[i], q_end = other.row_offsets_[i + 1];
+    while (p < p_end || q < q_end) {
+      int col_p = p < p_end ? col_indices_[p] : cols_;
+      int col_q = q < q_end ? other.col_indices_[q] : cols_;
+      if (col_p == col_q) {
+        push(col_p, values_[p++] + sign * other.values_[q++]);
+      } else if (col_p < col_q) {
+        push(col_p, values_[p++]);
+      } else {
+        push(col_q, sign * other.values_[q++]);
+      }
+    }
+    result.row_offsets_[i + 1] = static_cast<int>(result.values_.size());
+  }
+  return result;
+}
+
+void S21SparseMatrix::MulVector(const double *x, double *y) const {
+  S21ParallelFor(0, rows_, 2.0 * values_.size(), [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      double sum = 0.0;
+      for (int p = row_offsets_[i]; p < row_offsets_[i + 1]; p++) {
+        sum += values_[p] * x[col_indices_[p]];
+      }
+      y[i] = sum;
+    }
+  });
+}
+
+std::vector<double> S21SparseMatrix::MulVector(
+    const std::vector<double> &x) const {
+  if (static_cast<int>(x.size()) != cols_) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number "
+        "of rows of the second matrix");
+  }
+  std::vector<double> y(rows_);
+  MulVector(x.data(), y.data());
+  return y;
+}
+
+// строка C - сумма строк B с весами из строки A: каждое слагаемое -
+// непрерывный проход по строке B, который векторизуется
+S21Matrix operator*(const S21SparseMatrix &lhs, const S21Matrix &rhs) {
+  if (lhs.GetCols() != rhs.GetRows()) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number "
+        "of rows of the second matrix");
+  }
+  S21Matrix result(lhs.GetRows(), rhs.GetCols());
+  const std::vector<int> &offsets = lhs.RowOffsets();
+  const std::vector<int> &cols = lhs.ColIndices();
+  const std::vector<double> &values = lhs.Values();
+  const double *b = rhs.Data();
+  double *c = result.Data();
+  int n = rhs.GetCols();
+  int ldb = rhs.Stride(), ldc = result.Stride();
+  double work = 2.0 * lhs.NonZeros() * n;
+  S21ParallelFor(0, lhs.GetRows(), work, [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      double *c_row = c + static_cast<std::size_t>(i) * ldc;
+      for (int p = offsets[i]; p < offsets[i + 1]; p++) {
+        const double *b_row = b + static_cast<std::size_t>(cols[p]) * ldb;
+        double value = values[p];
+        for (int j = 0; j < n; j++) {
+          c_row[j] += value * b_row[j];
+        }
+      }
+    }
+  });
+  return result;
+}
+
+// строка C = сумма строк B (разреженных) с весами из строки A
+S21Matrix operator*(const S21Matrix &lhs, const S21SparseMatrix &rhs) {
+  if (lhs.GetCols() != rhs.GetRows()) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number "
+        "of rows of the second matrix");
+  }
+  S21Matrix result(lhs.GetRows(), rhs.GetCols());
+  const std::vector<int> &offsets = rhs.RowOffsets();
+  const std::vector<int> &cols = rhs.ColIndices();
+  const std::vector<double> &values = rhs.Values();
+  const double *a = lhs.Data();
+  double *c = result.Data();
+  int k = lhs.GetCols();
+  int lda = lhs.Stride(), ldc = result.Stride();
+  double work = 2.0 * lhs.GetRows() * rhs.NonZeros();
+  S21ParallelFor(0, lhs.GetRows(), work, [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      const double *a_row = a + static_cast<std::size_t>(i) * lda;
+      double *c_row = c + static_cast<std::size_t>(i) * ldc;
+      for (int kk = 0; kk < k; kk++) {
+        double weight = a_row[kk];
+        if (weight == 0.0) {
+          continue;
+        }
+        for (int p = offsets[kk]; p < offsets[kk + 1]; p++) {
+          c_row[cols[p]] += weight * values[p];
+        }
+      }
+    }
+  });
+  return result;
+}
+
+namespace {
+
+// dense += sign * sparse на месте, без копии CSR
+void ScatterAdd(S21Matrix &dense, const S21SparseMatrix &sparse,
+                double sign) {
+  if (dense.GetRows() != sparse.GetRows() ||
+      dense.GetCols() != sparse.GetCols()) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  const std::vector<int> &offsets = sparse.RowOffsets();
+  const std::vector<int> &cols = sparse.ColIndices();
+  const std::vector<double> &values = sparse.Values();
+  double *data = dense.Data();
+  std::ptrdiff_t stride = dense.Stride();
+  for (int i = 0; i < sparse.GetRows(); i++) {
+    double *row = data + static_cast<std::size_t>(i) * stride;
+    for (int p = offsets[i]; p < offsets[i + 1]; p++) {
+      row[cols[p]] += sign * values[p];
+    }
+  }
+}
+
+}  // namespace
+
+S21Matrix operator+(S21Matrix lhs, const S21SparseMatrix &rhs) {
+  ScatterAdd(lhs, rhs, 1.0);
+  return lhs;
+}
+
+S21Matrix operator+(const S21SparseMatrix &lhs, S21Matrix rhs) {
+  return std::move(rhs) + lhs;
+}
+
+S21Matrix operator-(S21Matrix lhs, const S21SparseMatrix &rhs) {
+  ScatterAdd(lhs, rhs, -1.0);
+  return lhs;
+}
+
+S21Matrix operator-(const S21SparseMatrix &lhs, S21Matrix rhs) {
+  if (rhs.GetRows() != lhs.GetRows() || rhs.GetCols() != lhs.GetCols()) {
+    throw std::invalid_argument("Different matrix size");
+  }
+  rhs.MulNumber(-1.0);
+  ScatterAdd(rhs, lhs, 1.0);
+  return rhs;
+}
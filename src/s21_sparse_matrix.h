@@ -0,0 +1,97 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_SPARSE_MATRIX_H_
+#define CPP1_S21_MATRIXPLUS_S21_SPARSE_MATRIX_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// элемент разреженной матрицы в формате координат (COO)
+struct S21Triplet {
+  int row;
+  int col;
+  double value;
+};
+
+// Та же матрица по столбцам (CSC): элементы столбца j лежат в
+// row_indices/values с позиции col_offsets[j] до col_offsets[j + 1].
+struct S21CscMatrix {
+  int rows = 0;
+  int cols = 0;
+  std::vector<int> col_offsets;
+  std::vector<int> row_indices;
+  std::vector<double> values;
+};
+
+// Разреженная матрица в формате CSR: элементы строки i лежат в
+// col_indices_/values_ с позиции row_offsets_[i] до row_offsets_[i + 1],
+// столбцы внутри строки упорядочены по возрастанию. Хранятся только
+// ненулевые элементы, поэтому память и время умножения пропорциональны
+// их числу, а не rows * cols.
+//
+// В смешанных операциях с S21Matrix разреженный операнд никогда не
+// переводится в плотный вид: произведение и сумма обходят только его
+// ненулевые элементы.
+class S21SparseMatrix {
+ public:
+  S21SparseMatrix();
+  S21SparseMatrix(int rows, int cols);
+  // элементы с |a(i, j)| <= drop_tolerance отбрасываются
+  explicit S21SparseMatrix(const S21Matrix &dense, double drop_tolerance = 0.0);
+  // повторяющиеся координаты суммируются, нулевые суммы отбрасываются
+  S21SparseMatrix(int rows, int cols, const std::vector<S21Triplet> &triplets);
+  explicit S21SparseMatrix(const S21CscMatrix &csc);
+
+  int GetRows() const;
+  int GetCols() const;
+  std::size_t NonZeros() const;
+  double operator()(int row, int col) const;
+  const std::vector<int> &RowOffsets() const;
+  const std::vector<int> &ColIndices() const;
+  const std::vector<double> &Values() const;
+
+  S21Matrix ToDense() const;
+  S21CscMatrix ToCsc() const;
+  S21SparseMatrix Transpose() const;
+
+  bool EqMatrix(const S21SparseMatrix &other) const;
+  bool operator==(const S21SparseMatrix &other) const;
+  void SumMatrix(const S21SparseMatrix &other);
+  void SubMatrix(const S21SparseMatrix &other);
+  void MulNumber(double num);
+  S21SparseMatrix operator+(const S21SparseMatrix &other) const;
+  S21SparseMatrix operator-(const S21SparseMatrix &other) const;
+  S21SparseMatrix operator*(double num) const;
+
+  // y = A * x; x - GetCols() элементов, y - GetRows() элементов
+  void MulVector(const double *x, double *y) const;
+  std::vector<double> MulVector(const std::vector<double> &x) const;
+
+ private:
+  int rows_, cols_;
+  std::vector<int> row_offsets_;
+  std::vector<int> col_indices_;
+  std::vector<double> values_;
+
+  S21SparseMatrix Merge(const S21SparseMatrix &other, double sign) const;
+};
+
+// разреженная на плотную и плотная на разреженную; строки результата
+// считаются параллельно по политике выполнения
+S21Matrix operator*(const S21SparseMatrix &lhs, const S21Matrix &rhs);
+S21Matrix operator*(const S21Matrix &lhs, const S21SparseMatrix &rhs);
+// ненулевые элементы добавляются (вычитаются) в копию плотного операнда (во
+// временный операнд - на месте); для разреженная - плотная плотный операнд
+// сначала меняет знак
+S21Matrix operator+(S21Matrix lhs, const S21SparseMatrix &rhs);
+S21Matrix operator+(const S21SparseMatrix &lhs, S21Matrix rhs);
+S21Matrix operator-(S21Matrix lhs, const S21SparseMatrix &rhs);
+S21Matrix operator-(const S21SparseMatrix &lhs, S21Matrix rhs);
+
+template <typename T>
+template <typename U, typename>
+void S21BasicMatrix<T>::MulMatrix(const S21SparseMatrix &other) {
+  *this = *this * other;
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+// Умножение Штрассена в варианте Винограда: 7 умножений и 15 сложений
+// блоков на уровень рекурсии. Порядок вычислений подобран так, что кроме
+// четвертей C нужны только три временных блока на уровень: X (m/2 x k/2),
+// Y (k/2 x n/2) и Z (m/2 x n/2). Все они берутся из одного рабочего буфера,
+// который выделяется заранее под всю глубину рекурсии.
+namespace {
+
+// блок матрицы внутри буфера с ведущей размерностью ld
+template <typename T>
+struct Block {
+  T *data;
+  std::ptrdiff_t ld;
+  T *At(int i, int j) const { return data + i * ld + j; }
+};
+
+template <typename T>
+struct ConstBlock {
+  const T *data;
+  std::ptrdiff_t ld;
+  ConstBlock(const T *d, std::ptrdiff_t l) : data(d), ld(l) {}
+  ConstBlock(const Block<T> &block) : data(block.data), ld(block.ld) {}
+  const T *At(int i, int j) const { return data + i * ld + j; }
+};
+
+// dst = lhs + sign * rhs для блока rows x cols; sign - 1 или -1, поэтому
+// для целых элементов результат точный
+template <typename T>
+void AddBlocks(int rows, int cols, ConstBlock<T> lhs, ConstBlock<T> rhs,
+               T sign, Block<T> dst) {
+  S21ParallelFor(0, rows, static_cast<double>(rows) * cols,
+                 [&](int first, int last) {
+                   for (int i = first; i < last; i++) {
+                     const T *l = lhs.At(i, 0);
+                     const T *r = rhs.At(i, 0);
+                     T *d = dst.At(i, 0);
+                     for (int j = 0; j < cols; j++) {
+                       d[j] = l[j] + sign * r[j];
+                     }
+                   }
+                 });
+}
+
+template <typename T>
+void Multiply(int m, int n, int k, ConstBlock<T> a, ConstBlock<T> b,
+              Block<T> c, int levels, T *workspace) {
+  if (levels == 0) {
+    S21Gemm(m, n, k, a.data, a.ld, b.data, b.ld, c.data, c.ld);
+    return;
+  }
+  int m2 = m / 2;
+  int n2 = n / 2;
+  int k2 = k / 2;
+  ConstBlock<T> a11(a.At(0, 0), a.ld), a12(a.At(0, k2), a.ld);
+  ConstBlock<T> a21(a.At(m2, 0), a.ld), a22(a.At(m2, k2), a.ld);
+  ConstBlock<T> b11(b.At(0, 0), b.ld), b12(b.At(0, n2), b.ld);
+  ConstBlock<T> b21(b.At(k2, 0), b.ld), b22(b.At(k2, n2), b.ld);
+  Block<T> c11{c.At(0, 0), c.ld}, c12{c.At(0, n2), c.ld};
+  Block<T> c21{c.At(m2, 0), c.ld}, c22{c.At(m2, n2), c.ld};
+  Block<T> x{workspace, k2};
+  Block<T> y{x.data + static_cast<std::size_t>(m2) * k2, n2};
+  Block<T> z{y.data + static_cast<std::size_t>(k2) * n2, n2};
+  T *next = z.data + static_cast<std::size_t>(m2) * n2;
+  int sub = levels - 1;
+  const T plus(1);
+  const T minus(-1);
+
+  AddBlocks<T>(m2, k2, a11, a21, minus, x);  // S3 = A11 - A21
+  AddBlocks<T>(k2, n2, b22, b12, minus, y);  // T3 = B22 - B12
+  Multiply<T>(m2, n2, k2, x, y, c21, sub, next);  // C21 = P7
+  AddBlocks<T>(m2, k2, a21, a22, plus, x);   // S1 = A21 + A22
+  AddBlocks<T>(k2, n2, b12, b11, minus, y);  // T1 = B12 - B11
+  Multiply<T>(m2, n2, k2, x, y, c22, sub, next);  // C22 = P5
+  AddBlocks<T>(m2, k2, x, a11, minus, x);    // S2 = S1 - A11
+  AddBlocks<T>(k2, n2, b22, y, minus, y);    // T2 = B22 - T1
+  Multiply<T>(m2, n2, k2, x, y, c12, sub, next);  // C12 = P6
+  AddBlocks<T>(m2, k2, a12, x, minus, x);    // S4 = A12 - S2
+  Multiply<T>(m2, n2, k2, x, b22, c11, sub, next);  // C11 = P3
+  Multiply<T>(m2, n2, k2, a11, b11, z, sub, next);  // Z = P1
+  AddBlocks<T>(m2, n2, c12, z, plus, c12);    // C12 = U2 = P1 + P6
+  AddBlocks<T>(m2, n2, c21, c12, plus, c21);  // C21 = U3 = U2 + P7
+  AddBlocks<T>(m2, n2, c12, c22, plus, c12);  // C12 = U4 = U2 + P5
+  AddBlocks<T>(m2, n2, c21, c22, plus, c22);  // C22 = U7 = U3 + P5
+  AddBlocks<T>(m2, n2, c12, c11, plus, c12);  // C12 = U5 = U4 + P3
+  AddBlocks<T>(k2, n2, y, b21, minus, y);     // T4 = T2 - B21
+  Multiply<T>(m2, n2, k2, a22, y, c11, sub, next);  // C11 = P4
+  AddBlocks<T>(m2, n2, c21, c11, minus, c21);  // C21 = U6 = U3 - P4
+  Multiply<T>(m2, n2, k2, a12, b21, c11, sub, next);  // C11 = P2
+  AddBlocks<T>(m2, n2, c11, z, plus, c11);    // C11 = U1 = P1 + P2
+}
+
+// копия блока rows x cols в буфер размера padded_rows x padded_cols,
+// дополненная нулями
+template <typename T>
+void CopyPadded(int rows, int cols, const T *src, std::ptrdiff_t ld, T *dst,
+                int padded_rows, int padded_cols) {
+  for (int i = 0; i < padded_rows; i++) {
+    T *row = dst + static_cast<std::size_t>(i) * padded_cols;
+    int copied = 0;
+    if (i < rows) {
+      std::copy_n(src + i * ld, cols, row);
+      copied = cols;
+    }
+    std::fill(row + copied, row + padded_cols, T(0));
+  }
+}
+
+int RoundUp(int value, int levels) {
+  int step = 1 << levels;
+  return (value + step - 1) / step * step;
+}
+
+}  // namespace
+
+template <typename T>
+void S21StrassenGemm(int m, int n, int k, const T *a, int lda, const T *b,
+                     int ldb, T *c, int ldc, int crossover) {
+  crossover = std::max(crossover, 1);
+  int levels = 0;
+  while (std::min({m, n, k}) / (2 << levels) >= crossover) {
+    levels++;
+  }
+  if (levels == 0) {
+    S21Gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    return;
+  }
+
+  // размеры дополняются нулями до кратных 2^levels
+  int pm = RoundUp(m, levels);
+  int pn = RoundUp(n, levels);
+  int pk = RoundUp(k, levels);
+  bool padded = pm != m || pn != n || pk != k;
+  std::size_t scratch = 0;
+  for (int level = 1; level <= levels; level++) {
+    std::size_t hm = pm >> level, hn = pn >> level, hk = pk >> level;
+    scratch += hm * hk + hk * hn + hm * hn;
+  }
+  std::size_t padding =
+      padded ? static_cast<std::size_t>(pm) * pk +
+                   static_cast<std::size_t>(pk) * pn +
+                   static_cast<std::size_t>(pm) * pn
+             : 0;
+  S21BasicScratchBuffer<T> buffer(scratch + padding);
+  T *workspace = buffer.Get();
+
+  if (padded) {
+    T *pa = workspace + scratch;
+    T *pb = pa + static_cast<std::size_t>(pm) * pk;
+    T *pc = pb + static_cast<std::size_t>(pk) * pn;
+    CopyPadded(m, k, a, lda, pa, pm, pk);
+    CopyPadded(k, n, b, ldb, pb, pk, pn);
+    Multiply(pm, pn, pk, ConstBlock<T>(pa, pk), ConstBlock<T>(pb, pn),
+             Block<T>{pc, pn}, levels, workspace);
+    for (int i = 0; i < m; i++) {
+      std::copy_n(pc + static_cast<std::size_t>(i) * pn, n,
+                  c + static_cast<std::size_t>(i) * ldc);
+    }
+  } else {
+    Multiply(m, n, k, ConstBlock<T>(a, lda), ConstBlock<T>(b, ldb),
+             Block<T>{c, ldc}, levels, workspace);
+  }
+}
+
+#define S21_INSTANTIATE_STRASSEN(T)                                       \
+  template void S21StrassenGemm<T>(int, int, int, const T *, int, const T *, \
+                                   int, T *, int, int);
+S21_FOR_EACH_SCALAR(S21_INSTANTIATE_STRASSEN)
+#undef S21_INSTANTIATE_STRASSEN
@@ -0,0 +1,245 @@
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+std::mutex global_mutex;
+S21ExecutionPolicy global_policy;
+std::shared_ptr<S21ThreadPool> global_pool;
+thread_local const S21ExecutionPolicy *scoped_policy = nullptr;
+// номер очереди рабочего потока пула, -1 для посторонних потоков; пулов
+// может быть несколько (общий и исполнитель s21_async.h), поэтому номер
+// действителен только для worker_pool
+thread_local int worker_index = -1;
+thread_local const S21ThreadPool *worker_pool = nullptr;
+
+// hardware_concurrency() каждый раз читает /sys, что дороже всей работы
+// над маленькой матрицей, поэтому значение запоминается один раз
+int HardwareThreads() {
+  static const int threads =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  return threads;
+}
+
+int PolicyThreads(const S21ExecutionPolicy &policy) {
+  return policy.threads > 0 ? policy.threads : HardwareThreads();
+}
+
+}  // namespace
+
+S21ExecutionPolicy S21GetExecutionPolicy() {
+  if (scoped_policy != nullptr) {
+    return *scoped_policy;
+  }
+  std::lock_guard<std::mutex> lock(global_mutex);
+  return global_policy;
+}
+
+// Старый пул отпускается после снятия блокировки: если ссылка была
+// последней, его разрушение ждет рабочие потоки.
+void S21SetExecutionPolicy(const S21ExecutionPolicy &policy) {
+  std::shared_ptr<S21ThreadPool> replaced;
+  std::lock_guard<std::mutex> lock(global_mutex);
+  global_policy = policy;
+  if (global_pool != nullptr &&
+      global_pool->Size() + 1 < PolicyThreads(policy)) {
+    replaced = std::move(global_pool);
+  }
+}
+
+S21ScopedExecutionPolicy::S21ScopedExecutionPolicy(
+    const S21ExecutionPolicy &policy)
+    : previous_(scoped_policy), policy_(policy) {
+  scoped_policy = &policy_;
+}
+
+S21ScopedExecutionPolicy::~S21ScopedExecutionPolicy() {
+  scoped_policy = previous_;
+}
+
+S21ThreadPool::S21ThreadPool(int workers)
+    : pending_(0), next_queue_(0), stop_(false) {
+  workers = std::max(0, workers);
+  for (int i = 0; i < workers; i++) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  for (int i = 0; i < workers; i++) {
+    workers_.emplace_back(&S21ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+S21ThreadPool::~S21ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+int S21ThreadPool::Size() const { return static_cast<int>(workers_.size()); }
+
+// задача кладется в очередь текущего рабочего потока, а из внешних
+// потоков - по кругу во все очереди
+void S21ThreadPool::Submit(std::function<void()> task) {
+  if (queues_.empty()) {
+    task();
+    return;
+  }
+  int index = worker_pool == this ? worker_index : -1;
+  if (index < 0 || index >= static_cast<int>(queues_.size())) {
+    index = static_cast<int>(next_queue_++ % queues_.size());
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    pending_++;
+  }
+  wake_.notify_one();
+}
+
+bool S21ThreadPool::RunPendingTask(int index) {
+  std::function<void()> task;
+  int count = static_cast<int>(queues_.size());
+  if (index >= 0 && index < count) {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    if (!queues_[index]->tasks.empty()) {
+      task = std::move(queues_[index]->tasks.back());
+      queues_[index]->tasks.pop_back();
+    }
+  }
+  for (int i = 1; !task && i <= count; i++) {
+    Queue &victim = *queues_[(std::max(index, 0) + i) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+    }
+  }
+  if (!task) {
+    return false;
+  }
+  pending_--;
+  task();
+  return true;
+}
+
+void S21ThreadPool::WorkerLoop(int index) {
+  worker_index = index;
+  worker_pool = this;
+  while (true) {
+    if (RunPendingTask(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+// Порции раздаются через общий атомарный счетчик: каждый участник берет
+// следующую свободную порцию, пока они не кончатся, так что более быстрые
+// потоки автоматически делают больше работы.
+void S21ThreadPool::ParallelFor(int begin, int end, int grain, int threads,
+                                const std::function<void(int, int)> &body) {
+  if (begin >= end) {
+    return;
+  }
+  grain = std::max(1, grain);
+  int chunks = (end - begin + grain - 1) / grain;
+  int helpers = std::min({threads - 1, Size(), chunks - 1});
+  if (helpers <= 0) {
+    body(begin, end);
+    return;
+  }
+
+  struct State {
+    std::atomic<int> next;
+    std::atomic<int> running;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<State>();
+  state->next = begin;
+  state->running = helpers;
+  auto work = [state, end, grain, &body]() {
+    for (int first = state->next.fetch_add(grain); first < end;
+         first = state->next.fetch_add(grain)) {
+      try {
+        body(first, std::min(end, first + grain));
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->error) {
+          state->error = std::current_exception();
+        }
+        state->next = end;
+      }
+    }
+  };
+  for (int i = 0; i < helpers; i++) {
+    Submit([state, work]() {
+      work();
+      if (--state->running == 0) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done.notify_one();
+      }
+    });
+  }
+  work();
+  // Пока в очередях есть задачи, вызывающий поток выполняет их. Неудачный
+  // RunPendingTask просматривает все очереди, значит, помощники этого
+  // вызова уже взяты другими потоками и их можно ждать, не занимая ядро:
+  // после kSpinAttempts неудач подряд поток засыпает до конца помощников.
+  constexpr int kSpinAttempts = 64;
+  int idle = 0;
+  while (state->running > 0) {
+    if (RunPendingTask(worker_pool == this ? worker_index : -1)) {
+      idle = 0;
+    } else if (++idle < kSpinAttempts) {
+      std::this_thread::yield();
+    } else {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->done.wait(lock, [&state] { return state->running == 0; });
+    }
+  }
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+std::shared_ptr<S21ThreadPool> S21ThreadPool::Instance() {
+  std::lock_guard<std::mutex> lock(global_mutex);
+  if (global_pool == nullptr) {
+    int threads = std::max(HardwareThreads(), PolicyThreads(global_policy));
+    global_pool = std::make_shared<S21ThreadPool>(threads - 1);
+  }
+  return global_pool;
+}
+
+void S21ParallelFor(int begin, int end, double work,
+                    const std::function<void(int, int)> &body) {
+  S21ExecutionPolicy policy = S21GetExecutionPolicy();
+  int threads = PolicyThreads(policy);
+  if (threads <= 1 || work < policy.parallel_threshold || end - begin < 2) {
+    body(begin, end);
+    return;
+  }
+  int grain = policy.grain;
+  if (grain <= 0) {
+    // по несколько порций на поток, чтобы кража работы выравнивала нагрузку
+    grain = std::max(1, (end - begin) / (threads * 4));
+  }
+  // пул держится до конца вызова, даже если политика его уже заменила
+  std::shared_ptr<S21ThreadPool> pool = S21ThreadPool::Instance();
+  pool->ParallelFor(begin, end, grain, threads, body);
+}
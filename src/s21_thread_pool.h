@@ -0,0 +1,98 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_THREAD_POOL_H_
+#define CPP1_S21_MATRIXPLUS_S21_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Параметры параллельного выполнения операций над матрицами.
+struct S21ExecutionPolicy {
+  // сколько потоков (включая вызывающий) может занять одна операция,
+  // 0 - по числу ядер
+  int threads = 0;
+  // минимальное число итераций в одной порции работы, 0 - подбирается
+  // автоматически
+  int grain = 0;
+  // операции с оценкой стоимости ниже порога (в элементах или flop)
+  // выполняются в вызывающем потоке без пробуждения пула
+  double parallel_threshold = 1 << 16;
+  // размер блока, с которого Штрассен переходит на обычное ядро
+  int strassen_crossover = 256;
+  // S21MulAlgorithm::kAuto выбирает Штрассена, когда все размерности
+  // произведения не меньше этого значения; 0 - никогда
+  int strassen_threshold = 4096;
+};
+
+// Глобальная политика. Установка политики с большим числом потоков, чем в
+// пуле, пересоздает пул; операции, которые уже идут, доработают на старом,
+// и он разрушится после последней из них.
+S21ExecutionPolicy S21GetExecutionPolicy();
+void S21SetExecutionPolicy(const S21ExecutionPolicy &policy);
+
+// Переопределяет политику для текущего потока на время жизни объекта.
+class S21ScopedExecutionPolicy {
+ public:
+  explicit S21ScopedExecutionPolicy(const S21ExecutionPolicy &policy);
+  ~S21ScopedExecutionPolicy();
+  S21ScopedExecutionPolicy(const S21ScopedExecutionPolicy &) = delete;
+  S21ScopedExecutionPolicy &operator=(const S21ScopedExecutionPolicy &) =
+      delete;
+
+ private:
+  const S21ExecutionPolicy *previous_;
+  S21ExecutionPolicy policy_;
+};
+
+// Постоянный пул потоков с очередью на каждый поток и кражей работы:
+// поток берет задачи с конца своей очереди, а опустев, крадет с начала
+// чужих. Ожидающий ParallelFor поток тоже выполняет задачи из очередей,
+// поэтому вложенные параллельные вызовы не блокируют друг друга.
+class S21ThreadPool {
+ public:
+  explicit S21ThreadPool(int workers);
+  ~S21ThreadPool();
+  S21ThreadPool(const S21ThreadPool &) = delete;
+  S21ThreadPool &operator=(const S21ThreadPool &) = delete;
+
+  int Size() const;
+  void Submit(std::function<void()> task);
+  // делит [begin, end) на порции по grain итераций и выполняет
+  // body(first, last) не более чем в threads потоках, включая вызывающий;
+  // первое исключение из body пробрасывается вызывающему
+  void ParallelFor(int begin, int end, int grain, int threads,
+                   const std::function<void(int, int)> &body);
+
+  // общий пул библиотеки; указатель держит пул и после того, как новая
+  // политика его заменит
+  static std::shared_ptr<S21ThreadPool> Instance();
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void WorkerLoop(int index);
+  bool RunPendingTask(int index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<int> pending_;
+  std::atomic<unsigned> next_queue_;
+  bool stop_;
+};
+
+// Выполняет body над [begin, end) по текущей политике: в вызывающем потоке,
+// если work меньше порога, иначе в общем пуле.
+void S21ParallelFor(int begin, int end, double work,
+                    const std::function<void(int, int)> &body);
+
+#endif
@@ -1,5 +1,32 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <thread>
+
 #include "gtest/gtest.h"
+#include "s21_kernels.h"
 #include "s21_matrix_oop.h"
+#include "s21_out_of_core.h"
+
+//Число запросов памяти у пула: каждая матрица и каждый временный буфер
+//операций - ровно один запрос, независимо от того, попал ли он в кэш.
+static long AllocatorRequests() {
+  S21AllocatorStats stats = S21GetAllocatorStats();
+  return static_cast<long>(stats.pool_hits + stats.system_allocations);
+}
+
+//Матрица с элементами i * 10 + j, по значению видно, откуда он взят.
+static S21Matrix NumberedMatrix(int rows, int cols) {
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      result(i, j) = i * 10 + j;
+    }
+  }
+  return result;
+}
 
 //Проверяем базовый конструктор класса S21Matrix.
 //Он создает объект tests с помощью конструктора по умолчанию
@@ -339,6 +366,166 @@ TEST(test_functional, mul_operator) {
   ASSERT_TRUE(tests.EqMatrix(result));
 }
 
+//Проверяем блочное умножение на размерах, пересекающих границы блоков
+//и не кратных размеру микроядра, сравнивая с наивным циклом.
+TEST(test_functional, mul_matrix_blocked) {
+  int m = 131;
+  int k = 259;
+  int n = 37;
+  S21Matrix a(m, k);
+  S21Matrix b(k, n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < k; j++) {
+      a(i, j) = std::sin(i + 2.0 * j);
+    }
+  }
+  for (int i = 0; i < k; i++) {
+    for (int j = 0; j < n; j++) {
+      b(i, j) = std::cos(3.0 * i - j);
+    }
+  }
+  S21Matrix expected(m, n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double sum = 0.0;
+      for (int p = 0; p < k; p++) {
+        sum += a(i, p) * b(p, j);
+      }
+      expected(i, j) = sum;
+    }
+  }
+  S21Matrix result = a * b;
+  EXPECT_EQ(result.GetRows(), m);
+  EXPECT_EQ(result.GetCols(), n);
+  ASSERT_TRUE(result == expected);
+}
+
+//Проверяем Штрассена с маленьким блоком перехода на нескольких уровнях
+//рекурсии, для кратных степени двойки и для нечетных размеров с
+//дополнением нулями.
+TEST(test_functional, mul_matrix_strassen) {
+  S21ExecutionPolicy policy = S21GetExecutionPolicy();
+  policy.strassen_crossover = 8;
+  policy.strassen_threshold = 40;
+  S21ScopedExecutionPolicy scope(policy);
+
+  int shapes[][3] = {{64, 64, 64}, {70, 53, 45}, {41, 90, 77}};
+  for (auto &shape : shapes) {
+    S21Matrix a(shape[0], shape[2]);
+    S21Matrix b(shape[2], shape[1]);
+    for (int i = 0; i < a.GetRows(); i++) {
+      for (int j = 0; j < a.GetCols(); j++) {
+        a(i, j) = std::sin(i * 0.3 + j);
+      }
+    }
+    for (int i = 0; i < b.GetRows(); i++) {
+      for (int j = 0; j < b.GetCols(); j++) {
+        b(i, j) = std::cos(i - 0.5 * j);
+      }
+    }
+    S21Matrix classic = a;
+    classic.MulMatrix(b, S21MulAlgorithm::kClassic);
+    S21Matrix strassen = a;
+    strassen.MulMatrix(b, S21MulAlgorithm::kStrassen);
+    EXPECT_EQ(strassen.GetRows(), shape[0]);
+    EXPECT_EQ(strassen.GetCols(), shape[1]);
+    ASSERT_TRUE(strassen == classic);
+    ASSERT_TRUE(a * b == classic);
+  }
+}
+
+//Произведения с вектором (столбец, строка, внешнее произведение) идут
+//отдельными ядрами; сравниваем с наивным циклом, в том числе для
+//высокой матрицы, которая делится между потоками.
+TEST(test_functional, mul_vector) {
+  for (int rows : {1, 7, 5000}) {
+    int cols = 37;
+    S21Matrix a(rows, cols);
+    S21Matrix column(cols, 1);
+    S21Matrix row(1, rows);
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        a(i, j) = std::sin(i + 2.0 * j);
+      }
+      row(0, i) = std::cos(3.0 * i);
+    }
+    for (int j = 0; j < cols; j++) {
+      column(j, 0) = std::cos(j - 0.5);
+    }
+    S21Matrix ax(rows, 1);
+    S21Matrix xa(1, cols);
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        ax(i, 0) += a(i, j) * column(j, 0);
+        xa(0, j) += row(0, i) * a(i, j);
+      }
+    }
+    ASSERT_TRUE(a * column == ax);
+    ASSERT_TRUE(row * a == xa);
+    ASSERT_TRUE(a.MulVector(column) == ax);
+    ASSERT_TRUE(a.MulVector(row) == xa);
+    S21Matrix outer = ax * column.Transpose();
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        ASSERT_DOUBLE_EQ(outer(i, j), ax(i, 0) * column(j, 0));
+      }
+    }
+  }
+
+  // результат не зависит от числа потоков
+  S21Matrix tall(5000, 40);
+  S21Matrix weights(1, 5000);
+  for (int i = 0; i < 5000; i++) {
+    weights(0, i) = std::sin(i * 0.7);
+    for (int j = 0; j < 40; j++) {
+      tall(i, j) = std::cos(i - 3.0 * j);
+    }
+  }
+  S21Matrix parallel = weights * tall;
+  S21ExecutionPolicy serial_policy = S21GetExecutionPolicy();
+  serial_policy.threads = 1;
+  S21Matrix serial;
+  {
+    S21ScopedExecutionPolicy scope(serial_policy);
+    serial = weights * tall;
+  }
+  for (int j = 0; j < 40; j++) {
+    EXPECT_EQ(serial(0, j), parallel(0, j));
+  }
+
+  // вывод в готовую матрицу без выделения памяти
+  S21Matrix a = NumberedMatrix(6, 4);
+  S21Matrix x(4, 1);
+  x(1, 0) = 1.0;
+  x(3, 0) = 2.0;
+  S21Matrix y(6, 1);
+  long before = AllocatorRequests();
+  a.MulVector(x, &y);
+  EXPECT_EQ(AllocatorRequests() - before, 0);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_EQ(y(i, 0), a(i, 1) + 2.0 * a(i, 3));
+  }
+  S21Matrix wrong_size(2, 2);
+  a.MulVector(x, &wrong_size);
+  ASSERT_TRUE(wrong_size == y);
+  S21Matrix square = NumberedMatrix(4, 4);
+  S21Matrix alias = x;
+  square.MulVector(alias, &alias);
+  ASSERT_TRUE(alias == square * x);
+
+  // столбец вида лежит с шагом
+  S21ConstMatrixView strided = a.View().Col(2);
+  ASSERT_TRUE(S21Matrix(1, 6) * strided == S21Matrix(1, 1));
+  ASSERT_TRUE(NumberedMatrix(3, 6) * strided ==
+              NumberedMatrix(3, 6) * S21Matrix(strided));
+  ASSERT_TRUE(strided * NumberedMatrix(1, 5) ==
+              S21Matrix(strided) * NumberedMatrix(1, 5));
+
+  EXPECT_THROW(a.MulVector(S21Matrix(6, 1)), std::invalid_argument);
+  EXPECT_THROW(a.MulVector(S21Matrix(4, 2)), std::invalid_argument);
+  EXPECT_THROW(a.MulVector(S21Matrix(1, 4)), std::invalid_argument);
+}
+
 TEST(test_functional, mul_operator_num) {
   int rows = 2;
   int cols = 3;
@@ -387,6 +574,34 @@ TEST(test_functional, transpose) {
   ASSERT_TRUE(tests == tests_1);
 }
 
+//Проверяем блочное транспонирование и транспонирование на месте для
+//квадратных и прямоугольных матриц с неполными краевыми блоками.
+TEST(test_functional, transpose_tiled_and_in_place) {
+  int shapes[][2] = {{1, 1}, {2, 3}, {37, 70}, {100, 100}, {67, 5}};
+  for (auto &shape : shapes) {
+    S21Matrix tests(shape[0], shape[1]);
+    for (int i = 0; i < shape[0]; i++) {
+      for (int j = 0; j < shape[1]; j++) {
+        tests(i, j) = i * 1000 + j;
+      }
+    }
+    S21Matrix result = tests.Transpose();
+    S21Matrix in_place = tests;
+    in_place.TransposeInPlace();
+    ASSERT_EQ(result.GetRows(), shape[1]);
+    ASSERT_EQ(in_place.GetRows(), shape[1]);
+    ASSERT_EQ(in_place.GetCols(), shape[0]);
+    for (int i = 0; i < shape[0]; i++) {
+      for (int j = 0; j < shape[1]; j++) {
+        ASSERT_EQ(result(j, i), tests(i, j));
+        ASSERT_EQ(in_place(j, i), tests(i, j));
+      }
+    }
+    in_place.TransposeInPlace();
+    ASSERT_TRUE(in_place == tests);
+  }
+}
+
 //исключение
 TEST(test_functional, determinant) {
   S21Matrix tests(2, 3);
@@ -462,6 +677,101 @@ TEST(test_functional, determinant_2) {
   ASSERT_NEAR(result, 7, epsilon);
 }
 
+//Определитель большой матрицы считается через LU-разложение: для
+//нижнетреугольной матрицы с переставленными строками он равен
+//произведению диагонали со знаком перестановки.
+TEST(test_functional, determinant_lu_large) {
+  int size = 120;
+  S21Matrix tests(size, size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j <= i; j++) {
+      tests(i, j) = (i == j) ? 1.0 + (i % 2) : 0.5;
+    }
+  }
+  double expected = std::pow(2.0, size / 2);
+  ASSERT_NEAR(tests.Determinant() / expected, 1.0, 1e-12);
+
+  S21Matrix swapped = tests;
+  for (int j = 0; j < size; j++) {
+    std::swap(swapped(0, j), swapped(1, j));
+  }
+  ASSERT_NEAR(swapped.Determinant() / expected, -1.0, 1e-12);
+}
+
+//Вырожденность определяется относительно масштаба матрицы,
+//без сравнения с абсолютным epsilon.
+TEST(test_functional, lu_singular) {
+  S21Matrix tests(3, 3);
+  tests(0, 0) = 1e-12;
+  tests(1, 1) = 1e-12;
+  tests(2, 2) = 1e-12;
+  EXPECT_FALSE(tests.LU().IsSingular());
+
+  tests(2, 2) = 0.0;
+  S21LU lu = tests.LU();
+  EXPECT_TRUE(lu.IsSingular());
+  EXPECT_EQ(lu.Determinant(), 0.0);
+  EXPECT_ANY_THROW(S21Matrix(2, 3).LU());
+}
+
+//Порог вырожденности не обнуляет определитель плохо масштабированной
+//матрицы: он равен произведению настоящих ведущих элементов.
+TEST(test_functional, determinant_badly_scaled) {
+  S21Matrix tests(2, 2);
+  tests(0, 0) = 1e10;
+  tests(0, 1) = 1;
+  tests(1, 1) = 1e-10;
+  EXPECT_TRUE(tests.LU().IsSingular());
+  EXPECT_DOUBLE_EQ(tests.LU().Determinant(), 1.0);
+  EXPECT_DOUBLE_EQ(tests.Determinant(), 1.0);
+  EXPECT_THROW(tests.Solve(S21Matrix(2, 1)), std::logic_error);
+
+  tests(0, 0) = 1;
+  tests(0, 1) = 0.5;
+  tests(1, 1) = 1e-16;
+  EXPECT_DOUBLE_EQ(tests.Determinant(), 1e-16);
+  tests(1, 1) = 0;
+  EXPECT_EQ(tests.Determinant(), 0.0);
+}
+
+//Проверяем, что P * A = L * U.
+TEST(test_functional, lu_factors) {
+  S21Matrix tests(3, 3);
+  tests(0, 0) = 2;
+  tests(0, 1) = 3;
+  tests(0, 2) = 1;
+  tests(1, 0) = 7;
+  tests(1, 1) = 4;
+  tests(1, 2) = 1;
+  tests(2, 0) = 9;
+  tests(2, 1) = -2;
+  tests(2, 2) = 1;
+
+  S21LU lu = tests.LU();
+  const S21Matrix &f = lu.Factors();
+  S21Matrix l(3, 3);
+  S21Matrix u(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      if (i > j) {
+        l(i, j) = f(i, j);
+      } else {
+        u(i, j) = f(i, j);
+      }
+    }
+    l(i, i) = 1.0;
+  }
+  S21Matrix pa = tests;
+  for (int k = 0; k < 3; k++) {
+    int p = lu.Pivots()[k];
+    for (int j = 0; j < 3; j++) {
+      std::swap(pa(k, j), pa(p, j));
+    }
+  }
+  ASSERT_TRUE(l * u == pa);
+  ASSERT_NEAR(lu.Determinant(), -32, epsilon);
+}
+
 TEST(test_functional, complements_throw) {
   S21Matrix tests(3, 12);
   EXPECT_ANY_THROW(tests.CalcComplements());
@@ -632,6 +942,368 @@ TEST(test_functional, inverse_1x1) {
   ASSERT_NEAR(expected, result, 1e-06);
 }
 
+//Проверяем обращение большой матрицы: A * A^-1 = E.
+TEST(test_functional, inverse_large) {
+  int size = 150;
+  S21Matrix tests(size, size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      tests(i, j) = (i == j) ? size : std::sin(i * 7 + j * 3);
+    }
+  }
+  S21Matrix identity(size, size);
+  for (int i = 0; i < size; i++) {
+    identity(i, i) = 1.0;
+  }
+  ASSERT_TRUE(tests * tests.InverseMatrix() == identity);
+}
+
+//Решение для нескольких правых частей сверяется с A * X = B, в том числе
+//при распараллеливании по столбцам.
+TEST(test_functional, solve) {
+  int size = 60;
+  S21Matrix a(size, size);
+  S21Matrix b(size, 3 * size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      a(i, j) = (i == j) ? 0.1 : std::sin(i * 5 + j * 2);
+    }
+    for (int j = 0; j < b.GetCols(); j++) {
+      b(i, j) = std::cos(i + j * 3);
+    }
+  }
+  ASSERT_TRUE(a * a.Solve(b) == b);
+  S21ExecutionPolicy policy;
+  policy.threads = 4;
+  policy.parallel_threshold = 0;
+  policy.grain = 1;
+  S21ScopedExecutionPolicy scope(policy);
+  ASSERT_TRUE(a * a.Solve(b) == b);
+
+  EXPECT_THROW(a.Solve(S21Matrix(size + 1, 1)), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(2, 3).Solve(S21Matrix(2, 1)), std::length_error);
+  S21Matrix singular(2, 2);
+  singular(0, 0) = 1;
+  singular(0, 1) = 2;
+  singular(1, 0) = 2;
+  singular(1, 1) = 4;
+  EXPECT_THROW(singular.Solve(S21Matrix(2, 1)), std::logic_error);
+  singular(1, 1) = 5;
+  S21Matrix rhs(2, 1);
+  rhs(0, 0) = 1;
+  EXPECT_NEAR(singular.Solve(rhs)(0, 0), 5, epsilon);
+}
+
+//Запомненное разложение не должно переживать ни одно изменение матрицы.
+TEST(test_functional, solve_cache_invalidation) {
+  S21Matrix a(3, 3);
+  S21Matrix b(3, 2);
+  for (int i = 0; i < 3; i++) {
+    a(i, i) = 2.0;
+    b(i, 0) = i + 1;
+    b(i, 1) = 1.0;
+  }
+  auto check = [&b](const S21Matrix &matrix) {
+    EXPECT_TRUE(matrix * matrix.Solve(b) == b);
+  };
+  check(a);
+  S21Matrix copy = a;
+  a(0, 1) = 1.0;
+  check(a);
+  check(copy);
+  a.SetValue(2, 0, -1.0);
+  check(a);
+  a.SumMatrix(copy);
+  check(a);
+  a.SubMatrix(copy);
+  check(a);
+  a.MulNumber(3.0);
+  check(a);
+  a += copy * 2.0;
+  check(a);
+  a.TransposeInPlace();
+  check(a);
+  a.Data()[1] = 4.0;
+  check(a);
+  a.View()(1, 2) = 5.0;
+  check(a);
+  a.GetMatrix()[2][1] = 6.0;
+  check(a);
+  a = copy;
+  check(a);
+  EXPECT_DOUBLE_EQ(a.Determinant(), 8.0);
+  a.MulMatrix(a);
+  check(a);
+  EXPECT_DOUBLE_EQ(a.Determinant(), 64.0);
+}
+
+//Решение со смешанной точностью совпадает с решением в double до
+//округления; плохо обусловленная матрица решается в double целиком.
+TEST(test_functional, solve_mixed) {
+  int size = 80;
+  S21Matrix a(size, size);
+  S21Matrix b(size, 4);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      a(i, j) = (i == j ? size : 0.0) + std::sin(i * 5 + j * 2);
+    }
+    for (int j = 0; j < b.GetCols(); j++) {
+      b(i, j) = std::cos(i + j * 3);
+    }
+  }
+  S21RefinementReport report;
+  S21Matrix x = a.SolveMixed(b, &report);
+  S21Matrix expected = a.Solve(b);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < b.GetCols(); j++) {
+      EXPECT_NEAR(x(i, j), expected(i, j), 1e-14);
+    }
+  }
+  EXPECT_FALSE(report.fell_back);
+  EXPECT_GE(report.iterations, 1);
+  EXPECT_LE(report.backward_error,
+            std::sqrt(size) * std::numeric_limits<double>::epsilon());
+  EXPECT_LE(report.residual_norm, 1e-12);
+  S21RefinementReport again;
+  a.SolveMixed(b, &again);
+  EXPECT_EQ(again.iterations, report.iterations);
+
+  S21Matrix inverse = a.InverseMixed(&report);
+  EXPECT_FALSE(report.fell_back);
+  S21Matrix identity(size, size);
+  for (int i = 0; i < size; i++) {
+    identity(i, i) = 1.0;
+  }
+  ASSERT_TRUE(a * inverse == identity);
+  a(0, 0) += 1.0;
+  ASSERT_TRUE(a * a.SolveMixed(b) == b);
+
+  // матрица Гильберта 10 x 10: cond ~ 1e13, во float она вырождена
+  S21Matrix hilbert(10, 10);
+  for (int i = 0; i < 10; i++) {
+    for (int j = 0; j < 10; j++) {
+      hilbert(i, j) = 1.0 / (i + j + 1);
+    }
+  }
+  S21Matrix column(10, 1);
+  column(3, 0) = 1.0;
+  x = hilbert.SolveMixed(column, &report);
+  EXPECT_TRUE(report.fell_back);
+  EXPECT_TRUE(x == hilbert.Solve(column));
+  // элементы за пределами float
+  S21Matrix huge = hilbert * 1e300;
+  huge.SolveMixed(column, &report);
+  EXPECT_TRUE(report.fell_back);
+
+  EXPECT_THROW(S21Matrix(2, 3).SolveMixed(S21Matrix(2, 1)),
+               std::length_error);
+  EXPECT_THROW(a.SolveMixed(S21Matrix(size + 1, 1)), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(3, 3).InverseMixed(), std::logic_error);
+  EXPECT_THROW(S21Matrix(3, 2).InverseMixed(), std::invalid_argument);
+  EXPECT_THROW(S21BasicMatrix<std::int64_t>(2, 2).InverseMixed(),
+               std::logic_error);
+
+  // long double уточняется от разложения в double
+  S21BasicMatrix<long double> wide(a);
+  S21BasicMatrix<long double> wide_b(b);
+  wide.SolveMixed(wide_b, &report);
+  EXPECT_FALSE(report.fell_back);
+  EXPECT_LE(report.backward_error,
+            std::sqrt(size) * std::numeric_limits<long double>::epsilon());
+}
+
+//Размер 150 задевает несколько блоков разложения и неполный последний.
+TEST(test_functional, cholesky) {
+  int size = 150;
+  S21Matrix b(size, size);
+  S21Matrix rhs(size, 3);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      b(i, j) = std::sin(i * 3 + j * 7);
+    }
+    for (int j = 0; j < rhs.GetCols(); j++) {
+      rhs(i, j) = std::cos(i * 2 + j);
+    }
+  }
+  // элементы порядка единицы, чтобы определитель не переполнился
+  S21Matrix a = b.Transpose() * b * (1.0 / size);
+  for (int i = 0; i < size; i++) {
+    a(i, i) += 1.0;
+  }
+  S21Cholesky cholesky = a.Cholesky();
+  ASSERT_TRUE(cholesky.IsPositiveDefinite());
+  const S21Matrix &l = cholesky.Factor();
+  for (int i = 0; i < size; i++) {
+    for (int j = i + 1; j < size; j++) {
+      ASSERT_EQ(l(i, j), 0.0);
+    }
+  }
+  ASSERT_TRUE(l * l.Transpose() == a);
+  double det = a.LU().Determinant();
+  EXPECT_NEAR(cholesky.Determinant() / det, 1.0, 1e-10);
+  ASSERT_TRUE(a * cholesky.Solve(rhs) == rhs);
+  S21Matrix identity(size, size);
+  for (int i = 0; i < size; i++) {
+    identity(i, i) = 1.0;
+  }
+  ASSERT_TRUE(a * cholesky.Inverse() == identity);
+
+  // автоматический выбор: результаты совпадают с LU
+  EXPECT_NEAR(a.Determinant() / det, 1.0, 1e-10);
+  ASSERT_TRUE(a.Solve(rhs) == a.LU().Solve(rhs));
+  ASSERT_TRUE(a * a.InverseMatrix() == identity);
+
+  // симметричная, но не положительно определенная - через LU
+  S21Matrix indefinite = a;
+  indefinite(0, 0) = -1.0;
+  EXPECT_FALSE(indefinite.Cholesky().IsPositiveDefinite());
+  EXPECT_THROW(indefinite.Cholesky().Determinant(), std::logic_error);
+  EXPECT_THROW(indefinite.Cholesky().Solve(rhs), std::logic_error);
+  EXPECT_NEAR(indefinite.Determinant(), indefinite.LU().Determinant(),
+              std::abs(indefinite.LU().Determinant()) * 1e-10);
+  ASSERT_TRUE(indefinite * indefinite.Solve(rhs) == rhs);
+  ASSERT_TRUE(indefinite * indefinite.InverseMatrix() == identity);
+
+  S21BasicMatrix<float> a_float(a);
+  S21BasicMatrix<float> rhs_float(rhs);
+  S21BasicMatrix<float> residual =
+      a_float * a_float.Cholesky().Solve(rhs_float) - rhs_float;
+  for (int i = 0; i < size; i++) {
+    EXPECT_NEAR(residual(i, 0), 0.0f, 1e-4f);
+  }
+
+  // после изменения разложение не используется
+  a(1, 1) += 1.0;
+  ASSERT_TRUE(a * a.Solve(rhs) == rhs);
+  a(1, 2) += 1.0;
+  ASSERT_TRUE(a * a.Solve(rhs) == rhs);
+
+  EXPECT_THROW(S21Matrix(2, 3).Cholesky(), std::length_error);
+  EXPECT_THROW(S21BasicMatrix<std::int64_t>(2, 2).Cholesky(),
+               std::logic_error);
+  EXPECT_THROW(a.Cholesky().Solve(S21Matrix(size + 1, 1)),
+               std::invalid_argument);
+}
+
+//Неудачная попытка Холецкого запоминается: повторный Determinant
+//обходится без копии для разложения, пока матрица не изменится.
+TEST(test_functional, cholesky_failure_cached) {
+  int size = 40;
+  S21Matrix a(size, size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      a(i, j) = i == j ? 4.0 : 1.0 / (1 + i + j);
+    }
+  }
+  a(size - 1, size - 1) = -4.0;
+  long before = AllocatorRequests();
+  double det = a.Determinant();
+  long first = AllocatorRequests() - before;
+  before = AllocatorRequests();
+  EXPECT_EQ(a.Determinant(), det);
+  long second = AllocatorRequests() - before;
+  EXPECT_LT(second, first);
+  S21Matrix copy = a;
+  before = AllocatorRequests();
+  EXPECT_EQ(copy.Determinant(), det);
+  EXPECT_EQ(AllocatorRequests() - before, second);
+
+  // после изменения попытка повторяется, и разложение запоминается
+  a(size - 1, size - 1) = 4.0;
+  double positive = a.Determinant();
+  EXPECT_NEAR(positive / a.LU().Determinant(), 1.0, 1e-12);
+  before = AllocatorRequests();
+  EXPECT_EQ(a.Determinant(), positive);
+  EXPECT_EQ(AllocatorRequests() - before, 0);
+}
+
+TEST(test_functional, qr) {
+  int rows = 130;
+  int cols = 70;
+  S21Matrix a(rows, cols);
+  S21Matrix rhs(rows, 2);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      a(i, j) = std::sin(i * 5 + j * 3) + (i == j ? 2.0 : 0.0);
+    }
+    for (int j = 0; j < rhs.GetCols(); j++) {
+      rhs(i, j) = std::cos(i + j * 4);
+    }
+  }
+  S21QR qr = a.QR();
+  ASSERT_TRUE(qr.IsFullRank());
+  S21Matrix q = qr.Q();
+  S21Matrix r = qr.R();
+  ASSERT_EQ(q.GetRows(), rows);
+  ASSERT_EQ(q.GetCols(), cols);
+  ASSERT_TRUE(q * r == a);
+  S21Matrix identity(cols, cols);
+  for (int i = 0; i < cols; i++) {
+    identity(i, i) = 1.0;
+    for (int j = 0; j < i; j++) {
+      ASSERT_EQ(r(i, j), 0.0);
+    }
+  }
+  ASSERT_TRUE(q.Transpose() * q == identity);
+
+  // решение наименьших квадратов удовлетворяет A^T * A * x = A^T * b
+  S21Matrix x = a.LeastSquares(rhs);
+  ASSERT_EQ(x.GetRows(), cols);
+  S21Matrix normal = a.Transpose() * a;
+  ASSERT_TRUE(normal * x == a.Transpose() * rhs);
+  ASSERT_TRUE(x == normal.Solve(a.Transpose() * rhs));
+
+  // квадратная матрица: решение и определитель совпадают с LU
+  S21Matrix square(cols, cols);
+  for (int i = 0; i < cols; i++) {
+    for (int j = 0; j < cols; j++) {
+      square(i, j) = a(i, j);
+    }
+  }
+  S21Matrix square_rhs(cols, 1);
+  square_rhs(5, 0) = 1.0;
+  ASSERT_TRUE(square.LeastSquares(square_rhs) == square.Solve(square_rhs));
+  EXPECT_NEAR(square.QR().Determinant() / square.Determinant(), 1.0, 1e-10);
+  S21Matrix swap(2, 2);
+  swap(0, 1) = 1.0;
+  swap(1, 0) = 1.0;
+  EXPECT_NEAR(swap.QR().Determinant(), -1.0, 1e-15);
+
+  // неполный ранг: два одинаковых столбца
+  for (int i = 0; i < rows; i++) {
+    a(i, 1) = a(i, 0);
+  }
+  EXPECT_FALSE(a.QR().IsFullRank());
+  EXPECT_THROW(a.LeastSquares(rhs), std::logic_error);
+  EXPECT_THROW(S21Matrix(2, 3).QR(), std::length_error);
+  EXPECT_THROW(a.QR().Determinant(), std::length_error);
+  EXPECT_THROW(qr.Solve(S21Matrix(cols, 1)), std::invalid_argument);
+  EXPECT_THROW(S21BasicMatrix<std::int64_t>(2, 2).QR(), std::logic_error);
+}
+
+//Дополнения вырожденной матрицы считаются через миноры, а для обратимой
+//совпадают с det(A) * (A^-1)^T.
+TEST(test_functional, complements_singular) {
+  S21Matrix tests(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      tests(i, j) = i * 3 + j + 1;
+    }
+  }
+  S21Matrix expected(3, 3);
+  expected(0, 0) = -3;
+  expected(0, 1) = 6;
+  expected(0, 2) = -3;
+  expected(1, 0) = 6;
+  expected(1, 1) = -12;
+  expected(1, 2) = 6;
+  expected(2, 0) = -3;
+  expected(2, 1) = 6;
+  expected(2, 2) = -3;
+  ASSERT_TRUE(tests.CalcComplements() == expected);
+  EXPECT_ANY_THROW(tests.InverseMatrix());
+}
+
 TEST(test_functional, brackets_const) {
   const S21Matrix tests(3, 3);
 
@@ -650,6 +1322,1499 @@ TEST(test_functional, set_rows) {
   EXPECT_EQ(tests_1.GetRows(), 0);
 }
 
+//Проверяем, что элементы лежат одним выровненным буфером по строкам
+//и что GetMatrix() указывает внутрь этого буфера.
+TEST(test_storage, contiguous_aligned) {
+  S21Matrix tests(3, 5);
+  tests(2, 4) = 7.0;
+
+  const double *data = tests.Data();
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % S21Matrix::kAlignment,
+            0u);
+  EXPECT_EQ(tests.Stride(), 5);
+  EXPECT_EQ(data[2 * tests.Stride() + 4], 7.0);
+  EXPECT_EQ(tests.GetMatrix()[2] + 4, data + 2 * tests.Stride() + 4);
+}
+
+//Проверяем, что SetRows/SetCols сохраняют общий блок и зануляют новые
+//элементы.
+TEST(test_storage, resize_keeps_values) {
+  S21Matrix tests(2, 3);
+  tests(0, 0) = 1.0;
+  tests(1, 2) = 6.0;
+
+  tests.SetCols(4);
+  EXPECT_EQ(tests(0, 0), 1.0);
+  EXPECT_EQ(tests(1, 2), 6.0);
+  EXPECT_EQ(tests(1, 3), 0.0);
+
+  tests.SetRows(1);
+  tests.SetCols(2);
+  EXPECT_EQ(tests.GetRows(), 1);
+  EXPECT_EQ(tests.GetCols(), 2);
+  EXPECT_EQ(tests(0, 0), 1.0);
+}
+
+//Проверяем, что каждое доступное на процессоре векторное ядро совпадает
+//со скалярным, включая хвосты длиной меньше ширины вектора.
+TEST(test_simd, kernels_match_scalar) {
+  const S21ElementwiseKernels *scalar = S21KernelsFor(S21Isa::kScalar);
+  ASSERT_NE(scalar, nullptr);
+  EXPECT_NE(S21KernelsFor(S21Matrix::ActiveIsa()), nullptr);
+  for (S21Isa isa : {S21Isa::kSse2, S21Isa::kAvx2, S21Isa::kAvx512}) {
+    const S21ElementwiseKernels *kernels = S21KernelsFor(isa);
+    if (kernels == nullptr) {
+      continue;
+    }
+    for (std::size_t n : {0u, 1u, 3u, 8u, 13u, 31u}) {
+      std::vector<double> a(n), b(n);
+      for (std::size_t k = 0; k < n; k++) {
+        a[k] = std::sin(k + 1.0);
+        b[k] = std::cos(k + 2.0);
+      }
+      std::vector<double> expected = a, result = a;
+      scalar->add(n, expected.data(), b.data());
+      kernels->add(n, result.data(), b.data());
+      EXPECT_EQ(expected, result);
+      scalar->sub(n, expected.data(), b.data());
+      kernels->sub(n, result.data(), b.data());
+      EXPECT_EQ(expected, result);
+      scalar->scale(n, expected.data(), -2.5);
+      kernels->scale(n, result.data(), -2.5);
+      EXPECT_EQ(expected, result);
+      EXPECT_TRUE(kernels->equal(n, a.data(), a.data(), epsilon));
+      // векторные суммы складываются в другом порядке
+      EXPECT_NEAR(kernels->dot(n, a.data(), b.data()),
+                  scalar->dot(n, a.data(), b.data()), 1e-14);
+      std::vector<double> axpy = a, axpy_scalar = a;
+      kernels->axpy(n, axpy.data(), b.data(), 0.75);
+      scalar->axpy(n, axpy_scalar.data(), b.data(), 0.75);
+      for (std::size_t k = 0; k < n; k++) {
+        EXPECT_NEAR(axpy[k], axpy_scalar[k], 1e-15);
+      }
+      int rows = static_cast<int>(n % 7) + 1;
+      int cols = static_cast<int>(n / 3) + 1;
+      std::vector<double> src(rows * cols), dst(rows * cols),
+          reference(rows * cols);
+      for (std::size_t k = 0; k < src.size(); k++) {
+        src[k] = static_cast<double>(k);
+      }
+      scalar->transpose(rows, cols, src.data(), cols, reference.data(), rows);
+      kernels->transpose(rows, cols, src.data(), cols, dst.data(), rows);
+      EXPECT_EQ(reference, dst);
+      if (n > 0) {
+        result[n - 1] += 1e-3;
+        EXPECT_FALSE(
+            kernels->equal(n, expected.data(), result.data(), epsilon));
+      }
+    }
+  }
+}
+
+//Проверяем, что ParallelFor обходит каждую итерацию ровно один раз и
+//пробрасывает исключение из тела цикла.
+TEST(test_parallel, thread_pool) {
+  S21ThreadPool pool(3);
+  std::vector<std::atomic<int>> hits(1000);
+  pool.ParallelFor(0, 1000, 7, 4, [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      hits[i]++;
+    }
+  });
+  for (const std::atomic<int> &hit : hits) {
+    EXPECT_EQ(hit, 1);
+  }
+  EXPECT_THROW(pool.ParallelFor(0, 100, 1, 4,
+                                [](int first, int) {
+                                  if (first == 50) {
+                                    throw std::runtime_error("stop");
+                                  }
+                                }),
+               std::runtime_error);
+
+  // долгие порции помощников: вызывающий поток засыпает в ожидании их
+  std::atomic<int> slow(0);
+  pool.ParallelFor(0, 4, 1, 4, [&](int first, int) {
+    if (first > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    slow++;
+  });
+  EXPECT_EQ(slow, 4);
+}
+
+//Проверяем, что параллельные версии операций дают тот же результат, что и
+//однопоточные.
+TEST(test_parallel, operations_match_serial) {
+  int size = 97;
+  S21Matrix a(size, size + 3);
+  S21Matrix b(size + 3, size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size + 3; j++) {
+      a(i, j) = std::sin(i * 1.3 + j) + (i == j ? size : 0);
+      b(j, i) = std::cos(i * j - 0.7) + (i == j ? size : 0);
+    }
+  }
+
+  S21ExecutionPolicy serial;
+  serial.threads = 1;
+  S21ExecutionPolicy parallel;
+  parallel.threads = 4;
+  parallel.parallel_threshold = 0;
+  S21ExecutionPolicy previous = S21GetExecutionPolicy();
+  S21SetExecutionPolicy(parallel);
+
+  S21Matrix product = a * b;
+  S21Matrix sum = a + a;
+  S21Matrix transposed = a.Transpose();
+  S21Matrix inverse = product.InverseMatrix();
+  double det = product.Determinant();
+  {
+    S21ScopedExecutionPolicy scope(serial);
+    EXPECT_EQ(S21GetExecutionPolicy().threads, 1);
+    ASSERT_TRUE(product == a * b);
+    ASSERT_TRUE(sum == a * 2.0);
+    ASSERT_TRUE(transposed.Transpose() == a);
+    ASSERT_TRUE(inverse == product.InverseMatrix());
+    EXPECT_DOUBLE_EQ(det, product.Determinant());
+  }
+  EXPECT_EQ(S21GetExecutionPolicy().threads, 4);
+  S21SetExecutionPolicy(previous);
+}
+
+//Цепочка поэлементных операций вычисляется одним выражением и дает тот
+//же результат, что и пошаговые SumMatrix/SubMatrix/MulNumber.
+TEST(test_expr, fused_chain) {
+  S21Matrix a(3, 4);
+  S21Matrix b(3, 4);
+  S21Matrix c(3, 4);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      a(i, j) = i + j;
+      b(i, j) = i * j;
+      c(i, j) = i - j;
+    }
+  }
+  S21Matrix expected = a;
+  expected.SumMatrix(b);
+  S21Matrix scaled = c;
+  scaled.MulNumber(2.0);
+  expected.SubMatrix(scaled);
+
+  S21Matrix result = a + b - c * 2.0;
+  ASSERT_TRUE(result == expected);
+  EXPECT_EQ((a + b - c * 2.0)(2, 3), expected(2, 3));
+  EXPECT_EQ((a + b).GetRows(), 3);
+  EXPECT_EQ((a + b).GetCols(), 4);
+
+  //матрица может входить в выражение, которое ей же присваивается
+  a = a + b - c * 2.0;
+  ASSERT_TRUE(a == expected);
+  ASSERT_TRUE((b - c) * 1.0 == b - c);
+}
+
+//Размеры проверяются при построении выражения, до вычислений.
+TEST(test_expr, size_check_before_work) {
+  S21Matrix a(2, 2);
+  S21Matrix b(2, 2);
+  S21Matrix c(3, 2);
+  a(0, 0) = 5.0;
+  S21Matrix result = a;
+  EXPECT_THROW(result = a + b - c, std::invalid_argument);
+  EXPECT_EQ(result(0, 0), 5.0);
+  EXPECT_THROW(result += c * 2.0, std::invalid_argument);
+  EXPECT_THROW((a + b)(2, 0), std::out_of_range);
+}
+
+//Операторы с временным операндом переиспользуют его буфер и не выделяют
+//память под результат.
+TEST(test_rvalue, reuse_temporary_buffer) {
+  S21Matrix a(4, 4);
+  S21Matrix b(4, 4);
+  S21Matrix c(4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      a(i, j) = i + j;
+      b(i, j) = i * j + 1;
+      c(i, j) = i - j;
+    }
+  }
+  S21Matrix expected = a + b - c;
+
+  S21Matrix moved = a;
+  const double *buffer = moved.Data();
+  long before = AllocatorRequests();
+  S21Matrix result = std::move(moved) + b - c;
+  EXPECT_EQ(AllocatorRequests() - before, 0);
+  EXPECT_EQ(result.Data(), buffer);
+  ASSERT_TRUE(result == expected);
+
+  //(A * B) выделяет память под произведение, дальше цепочка работает в нем
+  before = AllocatorRequests();
+  S21Matrix chain = (a * b) + c - b * 2.0;
+  long after = AllocatorRequests();
+  S21Matrix product = a * b;
+  ASSERT_TRUE(chain == product + c - b * 2.0);
+  EXPECT_EQ(after - before, 1 + 2);  //результат и два буфера упаковки GEMM
+
+  before = AllocatorRequests();
+  S21Matrix scaled = std::move(result) * 3.0;
+  S21Matrix diff = a - std::move(scaled);
+  EXPECT_EQ(AllocatorRequests() - before, 0);
+  EXPECT_EQ(diff.Data(), buffer);
+  ASSERT_TRUE(diff == a - expected * 3.0);
+}
+
+//Транспонирование временной квадратной матрицы и вектора выполняется без
+//выделения памяти.
+TEST(test_rvalue, transpose_temporary) {
+  S21Matrix square(3, 3);
+  S21Matrix row(1, 5);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      square(i, j) = i * 3 + j;
+    }
+  }
+  for (int j = 0; j < 5; j++) {
+    row(0, j) = j;
+  }
+  S21Matrix expected_square = square.Transpose();
+  S21Matrix expected_row = row.Transpose();
+
+  long before = AllocatorRequests();
+  S21Matrix square_t = std::move(square).Transpose();
+  S21Matrix row_t = std::move(row).Transpose();
+  EXPECT_EQ(AllocatorRequests() - before, 0);
+  ASSERT_TRUE(square_t == expected_square);
+  EXPECT_EQ(row_t.GetRows(), 5);
+  EXPECT_EQ(row_t.GetCols(), 1);
+  ASSERT_TRUE(row_t == expected_row);
+}
+
+//Повторное умножение после прогрева берет все буферы из кэша пула и не
+//обращается к системному распределителю.
+TEST(test_allocator, pool_reuses_blocks) {
+  S21Matrix a(64, 64);
+  S21Matrix b(64, 64);
+  for (int i = 0; i < 64; i++) {
+    for (int j = 0; j < 64; j++) {
+      a(i, j) = i - j;
+      b(i, j) = i + j;
+    }
+  }
+  S21Matrix expected = a * b;
+
+  S21AllocatorStats before = S21GetAllocatorStats();
+  for (int round = 0; round < 5; round++) {
+    S21Matrix product = a * b;
+    ASSERT_TRUE(product == expected);
+  }
+  S21AllocatorStats after = S21GetAllocatorStats();
+  EXPECT_EQ(after.system_allocations, before.system_allocations);
+  EXPECT_EQ(after.pool_hits - before.pool_hits, 5u * 3u);
+
+  //размеры одного класса делят блоки между собой
+  S21Matrix near(63, 64);
+  S21Matrix blocks_reused(64, 63);
+  EXPECT_EQ(S21GetAllocatorStats().system_allocations,
+            after.system_allocations);
+}
+
+//Блок, освобожденный в другом потоке, попадает в кэш этого потока.
+TEST(test_allocator, free_in_other_thread) {
+  S21Matrix *matrix = new S21Matrix(100, 100);
+  (*matrix)(99, 99) = 1.0;
+  std::thread worker([matrix]() {
+    delete matrix;
+    S21AllocatorStats before = S21GetAllocatorStats();
+    S21Matrix again(100, 100);
+    EXPECT_EQ(S21GetAllocatorStats().pool_hits - before.pool_hits, 1u);
+    EXPECT_DOUBLE_EQ(again(99, 99), 0.0);
+  });
+  worker.join();
+}
+
+//TrimAll освобождает кэш и потока, который еще жив и сам его не чистит.
+TEST(test_allocator, trim_all_threads) {
+  std::promise<void> freed;
+  std::promise<void> trimmed;
+  std::thread worker([&freed, &trimmed]() {
+    { S21Matrix temporary(100, 100); }
+    freed.set_value();
+    trimmed.get_future().wait();
+  });
+  freed.get_future().wait();
+  EXPECT_GE(S21GetAllocatorStats().cached_bytes, 100u * 100u * 8u);
+  S21PoolAllocator::Instance().TrimAll();
+  EXPECT_EQ(S21GetAllocatorStats().cached_bytes, 0u);
+  trimmed.set_value();
+  worker.join();
+
+  //сверх общего лимита блоки не кэшируются (страницы блоков не
+  //затрагиваются, так что память на деле не расходуется)
+  S21PoolAllocator &pool = S21PoolAllocator::Instance();
+  std::size_t bytes = S21PoolAllocator::kMaxPooledBytes;
+  int count = static_cast<int>(S21PoolAllocator::kMaxTotalCachedBytes /
+                               S21PoolAllocator::kMaxCachedBytes) +
+              1;
+  std::vector<std::promise<void>> cached(count);
+  std::promise<void> checked;
+  std::shared_future<void> done = checked.get_future().share();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < count; i++) {
+    threads.emplace_back([&pool, &cached, done, bytes, i]() {
+      void *first = pool.Allocate(bytes);
+      void *second = pool.Allocate(bytes);
+      pool.Deallocate(first, bytes);
+      pool.Deallocate(second, bytes);
+      cached[i].set_value();
+      done.wait();
+    });
+  }
+  for (std::promise<void> &ready : cached) {
+    ready.get_future().wait();
+  }
+  std::uint64_t total = S21GetAllocatorStats().cached_bytes;
+  EXPECT_LE(total, S21PoolAllocator::kMaxTotalCachedBytes);
+  EXPECT_GE(total, S21PoolAllocator::kMaxTotalCachedBytes - 2 * bytes);
+  checked.set_value();
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+//Внутри области арены матрицы и временные буферы берутся из арены, после
+//Reset() та же память выдается заново.
+TEST(test_allocator, arena_scope) {
+  S21Matrix a(20, 30);
+  S21Matrix b(30, 10);
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 30; j++) {
+      a(i, j) = (i * 7 + j) % 11;
+    }
+  }
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 10; j++) {
+      b(i, j) = (i + j * 3) % 5;
+    }
+  }
+  S21Matrix expected = a * b;
+
+  S21Arena arena(1 << 16);
+  const double *first = nullptr;
+  long pool_before = AllocatorRequests();
+  {
+    S21ArenaScope scope(arena);
+    S21AllocatorStats before = S21GetAllocatorStats();
+    S21Matrix product = a * b;
+    first = product.Data();
+    ASSERT_TRUE(product == expected);
+    EXPECT_EQ(S21GetAllocatorStats().arena_allocations -
+                  before.arena_allocations,
+              3u);
+    EXPECT_GT(arena.BytesUsed(), 20u * 10u * sizeof(double));
+  }
+  arena.Reset();
+  EXPECT_EQ(arena.BytesUsed(), 0u);
+  {
+    S21ArenaScope scope(arena);
+    S21Matrix product = a * b;
+    EXPECT_EQ(product.Data(), first);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(product.Data()) %
+                  S21Matrix::kAlignment,
+              0u);
+  }
+  //один кусок арены - одно системное выделение, пул не задействован
+  EXPECT_EQ(AllocatorRequests() - pool_before, 1);
+}
+
+//Последний выделенный блок арены освобождается сразу.
+TEST(test_allocator, arena_releases_last_block) {
+  S21Arena arena(1024);
+  void *first = arena.Allocate(100);
+  void *second = arena.Allocate(100);
+  EXPECT_EQ(arena.BytesUsed(), 256u);
+  arena.Deallocate(second, 100);
+  EXPECT_EQ(arena.BytesUsed(), 128u);
+  arena.Deallocate(first, 100);  //уже не последний, память не возвращается
+  EXPECT_EQ(arena.BytesUsed(), 128u);
+  void *large = arena.Allocate(4096);  //не помещается в кусок - новый кусок
+  EXPECT_NE(large, nullptr);
+  EXPECT_EQ(arena.BytesUsed(), 1024u + 4096u);
+  arena.Reset();
+  EXPECT_EQ(arena.Allocate(64), first);
+}
+
+//Операции S21FixedMatrix вычисляются на этапе компиляции.
+TEST(test_fixed, constexpr_kernels) {
+  constexpr S21FixedMatrix<2, 2> a{1, 2, 3, 4};
+  constexpr S21FixedMatrix<2, 3> b{1, 0, 2, 0, 1, 3};
+  static_assert(a.Determinant() == -2.0, "det 2x2");
+  static_assert((a * b)(1, 2) == 3 * 2 + 4 * 3, "product");
+  static_assert(b.Transpose()(2, 1) == 3, "transpose");
+  static_assert(a.InverseMatrix()(0, 0) == -2.0, "inverse");
+  static_assert(a.CalcComplements()(0, 1) == -3.0, "complements");
+  static_assert((a + a - a * 2.0) == S21FixedMatrix<2, 2>(), "arithmetic");
+  static_assert(S21FixedMatrix<3, 3, std::int64_t>{2, 0, 0, 0, 3, 0, 0, 0, 4}
+                        .Determinant() == 24,
+                "integer det");
+  EXPECT_EQ(sizeof(S21FixedMatrix<4, 4>), 16 * sizeof(double));
+}
+
+//Результаты совпадают с S21Matrix для размеров с явными формулами и
+//для общего случая.
+template <int N>
+void ExpectFixedMatchesDynamic() {
+  S21FixedMatrix<N, N> fixed;
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      fixed(i, j) = ((i * 7 + j * 3) % 5) + (i == j ? N : 0) - 1.5;
+    }
+  }
+  S21Matrix dynamic(fixed);
+  EXPECT_NEAR(fixed.Determinant(), dynamic.Determinant(), 1e-9);
+  ASSERT_TRUE(S21Matrix(fixed.InverseMatrix()) == dynamic.InverseMatrix());
+  ASSERT_TRUE(S21Matrix(fixed * fixed.Transpose()) ==
+              dynamic * dynamic.Transpose());
+  if (N > 1) {
+    ASSERT_TRUE(S21Matrix(fixed.CalcComplements()) ==
+                dynamic.CalcComplements());
+  }
+  S21FixedMatrix<N, N> identity = S21FixedMatrix<N, N>::Identity();
+  ASSERT_TRUE(fixed * fixed.InverseMatrix() == identity);
+}
+
+template <>
+void ExpectFixedMatchesDynamic<1>() {
+  S21FixedMatrix<1, 1> fixed{4.0};
+  EXPECT_DOUBLE_EQ(fixed.InverseMatrix()(0, 0), 0.25);
+  EXPECT_DOUBLE_EQ(fixed.Determinant(), 4.0);
+}
+
+//Целые определители больше 4x4 считаются без дробей и точно.
+template <int N>
+void ExpectFixedIntegerMatchesDynamic() {
+  using Fixed = S21FixedMatrix<N, N, std::int64_t>;
+  Fixed fixed;
+  S21BasicMatrix<std::int64_t> dynamic(N, N);
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      fixed(i, j) = (i * 7 + j * 3) % 5 - 2 + (i == j ? N : 0);
+      dynamic(i, j) = fixed(i, j);
+    }
+  }
+  EXPECT_EQ(fixed.Determinant(), dynamic.Determinant()) << N;
+  Fixed complements = fixed.CalcComplements();
+  S21BasicMatrix<std::int64_t> expected = dynamic.CalcComplements();
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      EXPECT_EQ(complements(i, j), expected(i, j)) << N;
+    }
+  }
+}
+
+TEST(test_fixed, matches_dynamic) {
+  ExpectFixedMatchesDynamic<1>();
+  ExpectFixedMatchesDynamic<2>();
+  ExpectFixedMatchesDynamic<3>();
+  ExpectFixedMatchesDynamic<4>();
+  ExpectFixedMatchesDynamic<6>();
+  ExpectFixedIntegerMatchesDynamic<5>();
+  ExpectFixedIntegerMatchesDynamic<6>();
+
+  using Fixed5 = S21FixedMatrix<5, 5, std::int64_t>;
+  static_assert(Fixed5{2, 1, 0, 0, 0, 1, 3, 1, 0, 0, 0, 1, 4,
+                       1, 0, 0, 0, 1, 5, 1, 0, 0, 0, 1, 6}
+                        .Determinant() == 492,
+                "integer tridiagonal det");
+  static_assert(Fixed5{1, 2, 0, 0, 0, 3, 4, 0, 0, 0, 0, 0, 1,
+                       0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1}
+                        .Determinant() == -2,
+                "integer block diagonal det");
+}
+
+TEST(test_fixed, errors) {
+  S21FixedMatrix<3, 3> singular{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_THROW(singular.InverseMatrix(), std::logic_error);
+  EXPECT_THROW((S21FixedMatrix<2, 3>(S21Matrix(3, 2))), std::invalid_argument);
+  EXPECT_THROW(singular.At(3, 0), std::out_of_range);
+  EXPECT_THROW((S21FixedMatrix<1, 2>{1, 2, 3}), std::invalid_argument);
+
+  S21FixedMatrix<2, 3> m{1, 2, 3, 4, 5, 6};
+  m.MulMatrix(S21FixedMatrix<3, 3>::Identity() * 2.0);
+  m -= S21FixedMatrix<2, 3>{1, 2, 3, 4, 5, 6};
+  ASSERT_TRUE(m == (S21FixedMatrix<2, 3>{1, 2, 3, 4, 5, 6}));
+}
+
+//Блоки, диапазоны и транспонирование ссылаются на данные матрицы.
+TEST(test_view, slicing) {
+  S21Matrix m = NumberedMatrix(5, 6);
+  S21MatrixView block = m.View().Block(1, 2, 3, 3);
+  EXPECT_EQ(block.GetRows(), 3);
+  EXPECT_EQ(block.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(block(0, 0), 12);
+  EXPECT_DOUBLE_EQ(block(2, 1), 33);
+  EXPECT_EQ(&block(0, 0), &m(1, 2));
+  EXPECT_TRUE(block.IsDense());
+
+  S21ConstMatrixView transposed = block.Transposed();
+  EXPECT_FALSE(transposed.IsDense());
+  EXPECT_DOUBLE_EQ(transposed(1, 2), 33);
+  EXPECT_DOUBLE_EQ(m.View().Row(4)(0, 5), 45);
+  EXPECT_DOUBLE_EQ(m.View().Col(3)(4, 0), 43);
+  EXPECT_DOUBLE_EQ(m.View().RowRange(2, 2).ColRange(1, 2)(1, 1), 32);
+
+  block(1, 1) = -1;
+  EXPECT_DOUBLE_EQ(m(2, 3), -1);
+  EXPECT_THROW(block(3, 0), std::out_of_range);
+  EXPECT_THROW(m.View().Block(4, 0, 2, 1), std::out_of_range);
+}
+
+//Минор - вид с пропущенной строкой и столбцом.
+TEST(test_view, skip_masks) {
+  S21Matrix m = NumberedMatrix(4, 4);
+  S21ConstMatrixView minor = m.View().Minor(1, 2);
+  S21Matrix expected(3, 3);
+  int rows[] = {0, 2, 3};
+  int cols[] = {0, 1, 3};
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      expected(i, j) = rows[i] * 10 + cols[j];
+    }
+  }
+  ASSERT_TRUE(minor == expected);
+  ASSERT_TRUE(S21Matrix(minor) == expected);
+  EXPECT_FALSE(minor.IsDense());
+  //блок, начинающийся до пропуска, сохраняет его, после - уже нет
+  EXPECT_DOUBLE_EQ(minor.Block(0, 0, 2, 2)(1, 1), 21);
+  EXPECT_DOUBLE_EQ(minor.Block(1, 1, 2, 2)(0, 0), 21);
+  EXPECT_TRUE(minor.Block(1, 2, 2, 1).IsDense());
+  ASSERT_TRUE(minor.Transposed() == expected.Transpose());
+  EXPECT_THROW(minor.SkipRow(0), std::logic_error);
+}
+
+//Поэлементные операции и запись в блок большой матрицы.
+TEST(test_view, arithmetic) {
+  S21Matrix m = NumberedMatrix(6, 6);
+  S21ConstMatrixView top_left = m.View().Block(0, 0, 3, 3);
+  S21ConstMatrixView bottom_right = m.View().Block(3, 3, 3, 3);
+  S21Matrix sum = top_left + bottom_right * 2.0 - S21Matrix(3, 3);
+  EXPECT_DOUBLE_EQ(sum(1, 2), 12 + 2 * 45);
+
+  S21Matrix ones(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      ones(i, j) = 1;
+    }
+  }
+  S21MatrixView tile = m.View().Block(3, 0, 3, 3);
+  tile += ones;
+  tile *= 2.0;
+  EXPECT_DOUBLE_EQ(m(4, 1), (41 + 1) * 2);
+  EXPECT_DOUBLE_EQ(m(4, 3), 43);
+  tile = top_left.Transposed();
+  EXPECT_DOUBLE_EQ(m(5, 0), 2);
+  tile = ones;
+  ASSERT_TRUE(tile == ones);
+  ASSERT_TRUE(ones == tile);
+  EXPECT_FALSE(tile == top_left);
+  EXPECT_THROW(tile -= S21Matrix(2, 2), std::invalid_argument);
+}
+
+//Выражение с видом на саму матрицу: вид читает не те элементы, что
+//пишутся, поэтому результат не должен зависеть от порядка записи.
+TEST(test_view, self_assignment) {
+  S21Matrix zero(3, 3);
+  S21Matrix a = NumberedMatrix(3, 3);
+  a = a.View().Transposed() + zero;
+  ASSERT_TRUE(a == NumberedMatrix(3, 3).Transpose());
+  a += a.View().Transposed() * 2.0;
+  ASSERT_TRUE(a == NumberedMatrix(3, 3).Transpose() +
+                       NumberedMatrix(3, 3) * 2.0);
+  a = NumberedMatrix(3, 3);
+  a -= a.View().Transposed();
+  EXPECT_DOUBLE_EQ(a(0, 1), 1 - 10);
+  EXPECT_DOUBLE_EQ(a(1, 0), 10 - 1);
+
+  // сдвинутый блок той же матрицы, в том числе с другими размерами
+  S21Matrix b = NumberedMatrix(4, 5);
+  b = b.View().Block(0, 1, 4, 4) + S21Matrix(4, 4);
+  ASSERT_TRUE(b == NumberedMatrix(4, 5).View().Block(0, 1, 4, 4));
+  S21Matrix c = NumberedMatrix(4, 4);
+  S21ConstMatrixView lower(c.Data() + c.Stride(), 3, 4, c.Stride());
+  c = lower * 1.0;
+  ASSERT_TRUE(c == NumberedMatrix(4, 4).View().Block(1, 0, 3, 4));
+}
+
+//Плотные и транспонированные виды умножаются без копирования, виды с
+//пропусками копируются.
+TEST(test_view, multiply) {
+  S21Matrix m = NumberedMatrix(40, 30);
+  S21ConstMatrixView a = m.View().Block(2, 1, 20, 25);
+  S21ConstMatrixView b = m.View().Block(5, 3, 25, 10);
+  S21Matrix expected = S21Matrix(a) * S21Matrix(b);
+
+  long before = AllocatorRequests();
+  S21Matrix product = a * b;
+  EXPECT_EQ(AllocatorRequests() - before, 1 + 2);
+  ASSERT_TRUE(product == expected);
+  ASSERT_TRUE(S21Matrix(a) * b == expected);
+
+  const S21Matrix at = S21Matrix(a).Transpose();
+  const S21Matrix bt = S21Matrix(b).Transpose();
+  before = AllocatorRequests();
+  product = at.View().Transposed() * bt.View().Transposed();
+  EXPECT_EQ(AllocatorRequests() - before, 1 + 2);
+  ASSERT_TRUE(product == expected);
+  ASSERT_TRUE(a.Transposed().Transposed() * b == expected);
+  ASSERT_TRUE(at.View().Transposed() * b == expected);
+  ASSERT_TRUE(a * bt.View().Transposed() == expected);
+  // несколько блоков упаковки по каждой размерности
+  S21Matrix wide = NumberedMatrix(300, 270) * 0.01;
+  S21Matrix tall = NumberedMatrix(290, 300) * 0.01;
+  ASSERT_TRUE(wide.View().Transposed() * tall.View().Transposed() ==
+              wide.Transpose() * tall.Transpose());
+  S21ConstMatrixView minor = m.View().Block(0, 0, 21, 25).SkipRow(7);
+  ASSERT_TRUE(minor * b == S21Matrix(minor) * S21Matrix(b));
+  ASSERT_TRUE(b.Transposed() * a.Transposed() == expected.Transpose());
+  ASSERT_TRUE((a + a) * b == expected * 2.0);
+  EXPECT_THROW(a * a, std::invalid_argument);
+}
+
+//Плотная матрица с редкими ненулевыми элементами.
+static S21Matrix SparsePattern(int rows, int cols, int seed) {
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      if ((i * 31 + j * 17 + seed) % 23 == 0) {
+        result(i, j) = (i - j + seed) % 7 + 0.5;
+      }
+    }
+  }
+  return result;
+}
+
+//Построение из плотной матрицы, из COO и преобразование в CSC.
+TEST(test_sparse, construction) {
+  S21Matrix dense = SparsePattern(30, 40, 3);
+  dense(0, 0) = 1e-12;
+  S21SparseMatrix sparse(dense, 1e-9);
+  EXPECT_DOUBLE_EQ(sparse(0, 0), 0.0);
+  dense(0, 0) = 0.0;
+  ASSERT_TRUE(sparse.ToDense() == dense);
+  EXPECT_LT(sparse.NonZeros(), 30u * 40u / 10u);
+
+  S21SparseMatrix coo(3, 4, {{2, 1, 1.0}, {0, 3, 2.0}, {2, 1, 4.0},
+                             {1, 0, 3.0}, {1, 2, 1.0}, {1, 2, -1.0}});
+  EXPECT_EQ(coo.NonZeros(), 3u);
+  EXPECT_DOUBLE_EQ(coo(2, 1), 5.0);
+  EXPECT_DOUBLE_EQ(coo(1, 2), 0.0);
+  EXPECT_EQ(coo.RowOffsets(), (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_THROW(S21SparseMatrix(2, 2, {{2, 0, 1.0}}), std::out_of_range);
+
+  S21CscMatrix csc = sparse.ToCsc();
+  EXPECT_EQ(csc.col_offsets.size(), 41u);
+  EXPECT_EQ(csc.values.size(), sparse.NonZeros());
+  ASSERT_TRUE(S21SparseMatrix(csc) == sparse);
+  ASSERT_TRUE(sparse.Transpose().ToDense() == dense.Transpose());
+}
+
+//Произведения и суммы совпадают с плотными.
+TEST(test_sparse, arithmetic) {
+  S21Matrix a = SparsePattern(50, 60, 1);
+  S21Matrix b = SparsePattern(50, 60, 5);
+  S21Matrix d = NumberedMatrix(60, 20);
+  S21SparseMatrix sa(a);
+  S21SparseMatrix sb(b);
+
+  ASSERT_TRUE((sa + sb).ToDense() == a + b);
+  ASSERT_TRUE((sa - sa).NonZeros() == 0u);
+  ASSERT_TRUE((sa * 2.0).ToDense() == a * 2.0);
+  ASSERT_TRUE(sa * d == a * d);
+  ASSERT_TRUE(d.Transpose() * sb.Transpose() == d.Transpose() * b.Transpose());
+  ASSERT_TRUE(a + sb == a + b);
+  ASSERT_TRUE(sb + a == a + b);
+  ASSERT_TRUE((a - b) - sa == b * -1.0);
+  ASSERT_TRUE(sa - b == a - b);
+  ASSERT_TRUE(sb - (a + b) == a * -1.0);
+
+  std::vector<double> x(60);
+  for (int j = 0; j < 60; j++) {
+    x[j] = j * 0.25 - 3;
+  }
+  std::vector<double> y = sa.MulVector(x);
+  S21Matrix column(60, 1);
+  for (int j = 0; j < 60; j++) {
+    column(j, 0) = x[j];
+  }
+  S21Matrix expected = a * column;
+  for (int i = 0; i < 50; i++) {
+    EXPECT_NEAR(y[i], expected(i, 0), 1e-12);
+  }
+
+  S21Matrix product = d.Transpose();
+  product.MulMatrix(sa.Transpose());
+  ASSERT_TRUE(product == d.Transpose() * a.Transpose());
+  EXPECT_THROW(sa * sa.ToDense(), std::invalid_argument);
+  EXPECT_THROW(sa + S21SparseMatrix(50, 61), std::invalid_argument);
+  EXPECT_THROW(sa - S21Matrix(50, 61), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(50, 61) - sa, std::invalid_argument);
+}
+
+//Большие произведения распараллеливаются и дают тот же результат.
+TEST(test_sparse, parallel) {
+  S21Matrix a = SparsePattern(400, 300, 2);
+  S21Matrix d = NumberedMatrix(300, 64);
+  S21SparseMatrix sa(a);
+  S21Matrix serial;
+  {
+    S21ExecutionPolicy policy = S21GetExecutionPolicy();
+    policy.threads = 1;
+    S21ScopedExecutionPolicy scope(policy);
+    serial = sa * d;
+  }
+  S21ExecutionPolicy policy = S21GetExecutionPolicy();
+  policy.threads = 4;
+  policy.parallel_threshold = 0;
+  S21ScopedExecutionPolicy scope(policy);
+  ASSERT_TRUE(sa * d == serial);
+  ASSERT_TRUE(serial == a * d);
+}
+
+//Сохранение и загрузка: те же элементы, порча данных ловится
+//контрольной суммой, чужой файл - проверкой заголовка.
+TEST(test_io, save_load) {
+  const std::string path = "test_io_save.bin";
+  S21Matrix a = NumberedMatrix(7, 5);
+  a.Save(path);
+  S21Matrix b = S21Matrix::Load(path);
+  EXPECT_EQ(b.Storage(), S21Storage::kOwned);
+  ASSERT_TRUE(a == b);
+
+  std::FILE *file = std::fopen(path.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fseek(file, sizeof(S21MatrixFileHeader) + 3 * sizeof(double), SEEK_SET);
+  std::fputc(0x5a, file);
+  std::fclose(file);
+  EXPECT_THROW(S21Matrix::Load(path), std::runtime_error);
+
+  file = std::fopen(path.c_str(), "wb");
+  std::fputs("not a matrix, just some text of reasonable length......"
+             "................",
+             file);
+  std::fclose(file);
+  EXPECT_THROW(S21Matrix::Load(path), std::runtime_error);
+  EXPECT_THROW(S21Matrix::MapFile(path), std::runtime_error);
+  std::remove(path.c_str());
+  EXPECT_THROW(S21Matrix::Load(path), std::system_error);
+
+  S21Matrix().Save(path);
+  EXPECT_EQ(S21Matrix::Load(path).GetRows(), 0);
+  std::remove(path.c_str());
+}
+
+//Файл с другим порядком байт читается с перестановкой.
+TEST(test_io, foreign_byte_order) {
+  const std::string path = "test_io_swapped.bin";
+  S21Matrix a = NumberedMatrix(2, 3);
+  S21MatrixFileHeader header{};
+  std::memcpy(header.magic, kS21MatrixMagic, sizeof(header.magic));
+  header.version = __builtin_bswap32(kS21MatrixFileVersion);
+  header.byte_order = __builtin_bswap32(kS21ByteOrderMark);
+  header.dtype =
+      __builtin_bswap32(static_cast<std::uint32_t>(S21DType::kFloat64));
+  header.header_bytes = __builtin_bswap32(sizeof(S21MatrixFileHeader));
+  header.rows = __builtin_bswap64(2);
+  header.cols = __builtin_bswap64(3);
+  header.checksum = __builtin_bswap64(S21MatrixChecksum(a.Data(), 6));
+  std::uint64_t words[6];
+  std::memcpy(words, a.Data(), sizeof(words));
+  for (std::uint64_t &word : words) {
+    word = __builtin_bswap64(word);
+  }
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  std::fwrite(&header, sizeof(header), 1, file);
+  std::fwrite(words, sizeof(words), 1, file);
+  std::fclose(file);
+
+  ASSERT_TRUE(S21Matrix::Load(path) == a);
+  EXPECT_THROW(S21Matrix::MapFile(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+//Заголовок, у которого rows * cols * 8 переполняет 64 бита и по модулю
+//2^64 совпадает с размером файла, отвергается.
+TEST(test_io, corrupted_header_size) {
+  const std::string path = "test_io_corrupted.bin";
+  S21MatrixFileHeader header = S21MakeMatrixHeader(
+      1519111591, 1517889155, kS21ChecksumSeed, S21DType::kFloat64);
+  std::vector<unsigned char> payload(13288 - sizeof(header));
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  std::fwrite(&header, sizeof(header), 1, file);
+  std::fwrite(payload.data(), payload.size(), 1, file);
+  std::fclose(file);
+  EXPECT_THROW(S21Matrix::Load(path), std::runtime_error);
+  EXPECT_THROW(S21Matrix::MapFile(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+//Отображение файла: чтение без копирования, запись в режиме только для
+//чтения отцепляет копию, копирование при записи не меняет файл.
+TEST(test_io, map_file) {
+  const std::string path = "test_io_map.bin";
+  S21Matrix a = NumberedMatrix(64, 48);
+  a.Save(path);
+
+  S21Matrix mapped = S21Matrix::MapFile(path);
+  EXPECT_EQ(mapped.Storage(), S21Storage::kMappedReadOnly);
+  const S21Matrix &view = mapped;
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(view.Data()) %
+                S21Matrix::kAlignment,
+            0u);
+  ASSERT_TRUE(view == a);
+  ASSERT_TRUE(view * a.Transpose() == a * a.Transpose());
+  EXPECT_EQ(mapped.Storage(), S21Storage::kMappedReadOnly);
+
+  S21Matrix moved = std::move(mapped);
+  EXPECT_EQ(moved.Storage(), S21Storage::kMappedReadOnly);
+  moved += moved * 2.0;
+  EXPECT_EQ(moved.Storage(), S21Storage::kOwned);
+  ASSERT_TRUE(moved == a * 3.0);
+
+  S21Matrix other = S21Matrix::MapFile(path);
+  other(1, 2) = -1.0;
+  EXPECT_EQ(other.Storage(), S21Storage::kOwned);
+  EXPECT_DOUBLE_EQ(other(1, 2), -1.0);
+  other = S21Matrix::MapFile(path);
+  other = a * 2.0;
+  ASSERT_TRUE(other == a * 2.0);
+
+  S21Matrix cow = S21Matrix::MapFile(path, S21MapMode::kCopyOnWrite);
+  EXPECT_EQ(cow.Storage(), S21Storage::kMappedCopyOnWrite);
+  cow.MulNumber(-1.0);
+  EXPECT_EQ(cow.Storage(), S21Storage::kMappedCopyOnWrite);
+  ASSERT_TRUE(cow == a * -1.0);
+  S21Matrix copy = cow;
+  EXPECT_EQ(copy.Storage(), S21Storage::kOwned);
+  ASSERT_TRUE(S21Matrix::Load(path) == a);
+  std::remove(path.c_str());
+}
+
+//Потоковые операции над файлами совпадают с обычными при любом делении
+//на панели, в том числе без предвыборки.
+TEST(test_out_of_core, multiply) {
+  S21Matrix a = NumberedMatrix(37, 23);
+  S21Matrix b = NumberedMatrix(23, 29) * 0.5;
+  a.Save("test_ooc_a.bin");
+  b.Save("test_ooc_b.bin");
+  for (std::size_t budget : {std::size_t(4000), std::size_t(1) << 20}) {
+    for (bool prefetch : {true, false}) {
+      S21OutOfCoreOptions options;
+      options.memory_budget = budget;
+      options.prefetch = prefetch;
+      S21OutOfCoreReport report = S21MulFiles(
+          "test_ooc_a.bin", "test_ooc_b.bin", "test_ooc_c.bin", options);
+      ASSERT_TRUE(S21Matrix::Load("test_ooc_c.bin") == a * b);
+      EXPECT_GE(report.bytes_read, 8u * (37 * 23 + 23 * 29));
+      EXPECT_EQ(report.bytes_written,
+                8u * 37 * 29 + sizeof(S21MatrixFileHeader));
+      EXPECT_GE(report.Overlap(), 0.0);
+      EXPECT_LE(report.Overlap(), 1.0);
+      if (!prefetch) {
+        EXPECT_NEAR(report.Overlap(), 0.0, 1e-9);
+      }
+      if (budget == 4000) {
+        EXPECT_LT(report.panel_rows, 37);
+        EXPECT_LT(report.panel_cols, 29);
+      } else {
+        EXPECT_EQ(report.bytes_read, 8u * (37 * 23 + 23 * 29));
+      }
+    }
+  }
+  S21OutOfCoreOptions tiny;
+  tiny.memory_budget = 64;
+  EXPECT_THROW(S21MulFiles("test_ooc_a.bin", "test_ooc_b.bin",
+                           "test_ooc_c.bin", tiny),
+               std::invalid_argument);
+  EXPECT_THROW(S21MulFiles("test_ooc_a.bin", "test_ooc_a.bin",
+                           "test_ooc_c.bin"),
+               std::invalid_argument);
+  EXPECT_THROW(S21MulFiles("test_ooc_a.bin", "test_ooc_b.bin",
+                           "test_ooc_b.bin"),
+               std::invalid_argument);
+  ASSERT_TRUE(S21Matrix::Load("test_ooc_b.bin") == b);
+  std::remove("test_ooc_a.bin");
+  std::remove("test_ooc_b.bin");
+  std::remove("test_ooc_c.bin");
+}
+
+TEST(test_out_of_core, sum_sub) {
+  S21Matrix a = NumberedMatrix(41, 13);
+  S21Matrix b = NumberedMatrix(41, 13) * -0.25;
+  a.Save("test_ooc_a.bin");
+  b.Save("test_ooc_b.bin");
+  S21OutOfCoreOptions options;
+  options.memory_budget = 13 * 8 * 4 * 3;
+  S21OutOfCoreReport report = S21SumFiles("test_ooc_a.bin", "test_ooc_b.bin",
+                                          "test_ooc_c.bin", options);
+  EXPECT_EQ(report.panel_rows, 3);
+  ASSERT_TRUE(S21Matrix::Load("test_ooc_c.bin") == a + b);
+  options.prefetch = false;
+  S21SubFiles("test_ooc_a.bin", "test_ooc_b.bin", "test_ooc_c.bin", options);
+  ASSERT_TRUE(S21Matrix::Load("test_ooc_c.bin") == a - b);
+  S21Matrix(2, 2).Save("test_ooc_b.bin");
+  EXPECT_THROW(S21SumFiles("test_ooc_a.bin", "test_ooc_b.bin",
+                           "test_ooc_c.bin"),
+               std::invalid_argument);
+  std::remove("test_ooc_a.bin");
+  std::remove("test_ooc_b.bin");
+  std::remove("test_ooc_c.bin");
+}
+
+//Случайная хорошо обусловленная матрица для пакетных тестов.
+static S21Matrix BatchMatrix(int rows, int cols, int seed) {
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      result(i, j) = std::sin(seed * 7.0 + i * 3.0 + j) + (i == j ? 3.0 : 0.0);
+    }
+  }
+  return result;
+}
+
+//Пакетные операции совпадают с поматричными для всех размеров и всех
+//наборов инструкций, вырожденные матрицы только отмечаются.
+TEST(test_batch, matches_single) {
+  const int count = 13;
+  for (int n = 1; n <= 6; n++) {
+    S21MatrixBatch batch(count, n, n);
+    for (int b = 0; b < count; b++) {
+      batch.Set(b, BatchMatrix(n, n, b));
+    }
+    batch.Set(5, S21Matrix(n, n));
+    if (n > 1) {
+      S21Matrix rank_deficient = BatchMatrix(n, n, 5);
+      for (int j = 0; j < n; j++) {
+        rank_deficient(n - 1, j) = 2.0 * rank_deficient(0, j);
+      }
+      batch.Set(9, rank_deficient);
+    }
+
+    std::vector<double> det = batch.Determinant();
+    std::vector<std::uint8_t> singular;
+    S21MatrixBatch inverse = batch.InverseMatrix(&singular);
+    ASSERT_EQ(det.size(), static_cast<std::size_t>(count));
+    ASSERT_EQ(singular.size(), static_cast<std::size_t>(count));
+    for (int b = 0; b < count; b++) {
+      S21Matrix single = batch.Get(b);
+      bool degenerate = b == 5 || (b == 9 && n > 1);
+      EXPECT_EQ(singular[b], degenerate ? 1 : 0) << n << " " << b;
+      if (degenerate) {
+        EXPECT_NEAR(det[b], 0.0, 1e-9) << n << " " << b;
+        EXPECT_TRUE(std::isnan(inverse(b, 0, 0)));
+        continue;
+      }
+      EXPECT_NEAR(det[b], single.Determinant(), 1e-9 * std::fabs(det[b]));
+      ASSERT_TRUE(inverse.Get(b) == single.InverseMatrix());
+    }
+
+    S21MatrixBatch product = batch.MulBatch(inverse);
+    S21MatrixBatch transposed = batch.Transpose();
+    for (int b = 0; b < count; b++) {
+      ASSERT_TRUE(product.Get(b) == batch.Get(b) * inverse.Get(b));
+      ASSERT_TRUE(transposed.Get(b) == batch.Get(b).Transpose());
+    }
+
+    for (S21Isa isa : {S21Isa::kScalar, S21Isa::kAvx2, S21Isa::kAvx512}) {
+      const S21BatchKernels *kernels = S21BatchKernelsFor(isa);
+      if (kernels == nullptr) {
+        continue;
+      }
+      int stride = batch.PlaneStride();
+      std::vector<double> other_det(stride);
+      std::vector<double> other_inverse(n * n * stride);
+      std::vector<std::uint8_t> other_singular(stride);
+      kernels->determinant(n, batch.Plane(0, 0), stride, 0, stride,
+                           other_det.data());
+      kernels->inverse(n, batch.Plane(0, 0), stride, 0, stride,
+                       other_inverse.data(), other_singular.data());
+      for (int b = 0; b < count; b++) {
+        EXPECT_NEAR(other_det[b], det[b], 1e-12 * (1.0 + std::fabs(det[b])));
+        EXPECT_EQ(other_singular[b], singular[b]);
+        if (!singular[b]) {
+          EXPECT_NEAR(other_inverse[b], inverse(b, 0, 0), 1e-12);
+        }
+      }
+    }
+  }
+}
+
+//Определитель плохо отмасштабированной матрицы не обнуляется порогом,
+//который только отмечает вырожденность в обратной.
+TEST(test_batch, determinant_badly_scaled) {
+  for (int n : {2, 5}) {
+    S21MatrixBatch batch(3, n, n);
+    S21Matrix scaled(n, n);
+    for (int i = 0; i < n; i++) {
+      scaled(i, i) = 1.0;
+    }
+    scaled(0, 0) = 1e10;
+    scaled(0, 1) = 1.0;
+    scaled(n - 1, n - 1) = 1e-10;
+    batch.Set(0, scaled);
+    batch.Set(1, S21Matrix(n, n));
+    batch.Set(2, BatchMatrix(n, n, 2));
+    std::vector<double> det = batch.Determinant();
+    EXPECT_NEAR(det[0], 1.0, 1e-12) << n;
+    EXPECT_EQ(det[1], 0.0) << n;
+    EXPECT_NEAR(det[2], batch.Get(2).Determinant(),
+                1e-9 * std::fabs(det[2]));
+    std::vector<std::uint8_t> singular;
+    S21MatrixBatch inverse = batch.InverseMatrix(&singular);
+    EXPECT_EQ(singular, (std::vector<std::uint8_t>{1, 1, 0})) << n;
+    EXPECT_TRUE(std::isnan(inverse(0, 0, 0)));
+  }
+}
+
+//Поэлементные операции, доступ к элементам и ошибки размеров.
+TEST(test_batch, elementwise) {
+  S21MatrixBatch a(10, 2, 3);
+  S21MatrixBatch b(10, 2, 3);
+  for (int k = 0; k < 10; k++) {
+    a.Set(k, BatchMatrix(2, 3, k));
+    b.Set(k, BatchMatrix(2, 3, k + 20));
+  }
+  S21MatrixBatch sum = a;
+  sum.SumBatch(b);
+  S21MatrixBatch difference = a;
+  difference.SubBatch(b);
+  S21MatrixBatch scaled = a;
+  scaled.MulNumber(-1.5);
+  for (int k = 0; k < 10; k++) {
+    ASSERT_TRUE(sum.Get(k) == a.Get(k) + b.Get(k));
+    ASSERT_TRUE(difference.Get(k) == a.Get(k) - b.Get(k));
+    ASSERT_TRUE(scaled.Get(k) == a.Get(k) * -1.5);
+  }
+  EXPECT_DOUBLE_EQ(a(3, 1, 2), a.Plane(1, 2)[3]);
+  EXPECT_EQ(a.PlaneStride() % S21MatrixBatch::kLanes, 0);
+  EXPECT_THROW(a(10, 0, 0), std::out_of_range);
+  EXPECT_THROW(a.Set(0, S21Matrix(3, 2)), std::invalid_argument);
+  EXPECT_THROW(a.SumBatch(S21MatrixBatch(9, 2, 3)), std::invalid_argument);
+  EXPECT_THROW(a.MulBatch(b), std::invalid_argument);
+  EXPECT_THROW(a.Determinant(), std::length_error);
+  EXPECT_THROW(a.InverseMatrix(), std::invalid_argument);
+
+  S21MatrixBatch moved = std::move(sum);
+  EXPECT_EQ(moved.Count(), 10);
+  EXPECT_EQ(S21MatrixBatch(0, 3, 3).Determinant().size(), 0u);
+
+  S21ExecutionPolicy policy = S21GetExecutionPolicy();
+  policy.threads = 4;
+  policy.parallel_threshold = 0;
+  policy.grain = 1;
+  S21ScopedExecutionPolicy scope(policy);
+  S21MatrixBatch big(100, 4, 4);
+  for (int k = 0; k < 100; k++) {
+    big.Set(k, BatchMatrix(4, 4, k));
+  }
+  std::vector<double> det = big.Determinant();
+  S21MatrixBatch square = big.MulBatch(big);
+  for (int k = 0; k < 100; k += 17) {
+    EXPECT_NEAR(det[k], big.Get(k).Determinant(), 1e-9 * std::fabs(det[k]));
+    ASSERT_TRUE(square.Get(k) == big.Get(k) * big.Get(k));
+  }
+}
+
+//Векторные ядра для типа T совпадают со скалярными; целые значения
+//выбраны так, чтобы вычисления в float были точными.
+template <typename T>
+static void ExpectKernelsMatchScalar() {
+  const S21BasicElementwiseKernels<T> *scalar =
+      S21KernelsFor<T>(S21Isa::kScalar);
+  ASSERT_NE(scalar, nullptr);
+  for (S21Isa isa : {S21Isa::kSse2, S21Isa::kAvx2, S21Isa::kAvx512}) {
+    const S21BasicElementwiseKernels<T> *kernels = S21KernelsFor<T>(isa);
+    if (kernels == nullptr) {
+      continue;
+    }
+    for (std::size_t n : {0u, 1u, 3u, 8u, 17u, 35u}) {
+      std::vector<T> a(n), b(n);
+      for (std::size_t k = 0; k < n; k++) {
+        a[k] = static_cast<T>(k % 11) - 5;
+        b[k] = static_cast<T>(k % 7) * 3;
+      }
+      std::vector<T> expected = a, result = a;
+      scalar->add(n, expected.data(), b.data());
+      kernels->add(n, result.data(), b.data());
+      EXPECT_EQ(expected, result);
+      scalar->sub(n, expected.data(), b.data());
+      kernels->sub(n, result.data(), b.data());
+      EXPECT_EQ(expected, result);
+      scalar->scale(n, expected.data(), T(-3));
+      kernels->scale(n, result.data(), T(-3));
+      EXPECT_EQ(expected, result);
+      T tolerance = S21MatrixTraits<T>::kTolerance;
+      EXPECT_TRUE(kernels->equal(n, a.data(), a.data(), tolerance));
+      // на целых значениях порядок сложения не влияет
+      EXPECT_EQ(kernels->dot(n, a.data(), b.data()),
+                scalar->dot(n, a.data(), b.data()));
+      std::vector<T> axpy = a, axpy_scalar = a;
+      kernels->axpy(n, axpy.data(), b.data(), T(3));
+      scalar->axpy(n, axpy_scalar.data(), b.data(), T(3));
+      EXPECT_EQ(axpy, axpy_scalar);
+      if (n > 0) {
+        result[n - 1] += 1;
+        EXPECT_FALSE(
+            kernels->equal(n, expected.data(), result.data(), tolerance));
+      }
+      int rows = static_cast<int>(n % 9) + 1;
+      int cols = static_cast<int>(n / 3) + 1;
+      std::vector<T> src(rows * cols), dst(rows * cols),
+          reference(rows * cols);
+      for (std::size_t k = 0; k < src.size(); k++) {
+        src[k] = static_cast<T>(k);
+      }
+      scalar->transpose(rows, cols, src.data(), cols, reference.data(), rows);
+      kernels->transpose(rows, cols, src.data(), cols, dst.data(), rows);
+      EXPECT_EQ(reference, dst);
+    }
+  }
+}
+
+template <typename T>
+static S21BasicMatrix<T> TypedMatrix(int rows, int cols) {
+  S21BasicMatrix<T> result(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      result(i, j) = static_cast<T>((i * 7 + j * 3) % 10) - 4;
+    }
+  }
+  return result;
+}
+
+TEST(test_scalar_types, kernels_match_scalar) {
+  ExpectKernelsMatchScalar<float>();
+  ExpectKernelsMatchScalar<std::int64_t>();
+  EXPECT_EQ(S21KernelsFor<long double>(S21Isa::kSse2), nullptr);
+  EXPECT_EQ(S21BasicMatrix<long double>::ActiveIsa(), S21Isa::kScalar);
+  EXPECT_NE(S21KernelsFor<float>(S21BasicMatrix<float>::ActiveIsa()),
+            nullptr);
+}
+
+//Операции над float, long double и int64_t дают те же значения, что над
+//double (на целых входах все вычисления точны).
+TEST(test_scalar_types, operations_match_double) {
+  S21Matrix a = TypedMatrix<double>(19, 23);
+  S21Matrix b = TypedMatrix<double>(23, 17);
+  S21Matrix sum = a + a * 2.0 - a;
+  S21Matrix product = a * b;
+  S21Matrix transposed = a.Transpose();
+
+  S21BasicMatrix<float> af(a), bf(b);
+  S21BasicMatrix<float> sum_f = af + af * 2.0f - af;
+  EXPECT_TRUE(S21Matrix(sum_f) == sum);
+  EXPECT_TRUE(S21Matrix(af * bf) == product);
+  EXPECT_TRUE(S21Matrix(af.Transpose()) == transposed);
+
+  S21BasicMatrix<long double> al(a), bl(b);
+  EXPECT_TRUE(S21Matrix(S21BasicMatrix<long double>(al + al * 2 - al)) ==
+              sum);
+  EXPECT_TRUE(S21Matrix(al * bl) == product);
+
+  S21BasicMatrix<std::int64_t> ai(a), bi(b);
+  S21BasicMatrix<std::int64_t> sum_i = ai + ai * 2 - ai;
+  EXPECT_TRUE(S21Matrix(sum_i) == sum);
+  EXPECT_TRUE(S21Matrix(ai * bi) == product);
+  EXPECT_TRUE(S21Matrix(std::move(ai).Transpose()) == transposed);
+
+  S21BasicMatrix<std::int64_t> big = TypedMatrix<std::int64_t>(140, 150);
+  big.MulMatrix(TypedMatrix<std::int64_t>(150, 130),
+                S21MulAlgorithm::kStrassen);
+  EXPECT_TRUE(S21Matrix(big) ==
+              TypedMatrix<double>(140, 150) * TypedMatrix<double>(150, 130));
+}
+
+//Допуск сравнения зависит от типа элементов, целые сравниваются точно.
+TEST(test_scalar_types, tolerance) {
+  S21BasicMatrix<float> f1(2, 2), f2(2, 2);
+  f2(1, 1) = 5e-5f;
+  EXPECT_TRUE(f1 == f2);
+  f2(1, 1) = 5e-4f;
+  EXPECT_FALSE(f1 == f2);
+  S21BasicMatrix<long double> l1(2, 2), l2(2, 2);
+  l2(0, 1) = 1e-9L;
+  EXPECT_FALSE(l1 == l2);
+  EXPECT_TRUE(l1.View().Col(0) == l2.View().Col(0));
+  S21BasicMatrix<std::int64_t> i1(3, 3), i2(3, 3);
+  EXPECT_TRUE(i1 == i2);
+  i2(2, 2) = 1;
+  EXPECT_FALSE(i1.EqMatrix(i2));
+}
+
+//Определитель целой матрицы считается точно, обратная существует только
+//при det = ±1.
+TEST(test_scalar_types, integer_determinant_and_inverse) {
+  S21BasicMatrix<std::int64_t> a(3, 3);
+  std::int64_t values[] = {2, 3, 1, 1, 2, 1, 3, 5, 3};
+  for (int k = 0; k < 9; k++) {
+    a(k / 3, k % 3) = values[k];
+  }
+  EXPECT_EQ(a.Determinant(), 1);
+  S21BasicMatrix<std::int64_t> inverse = a.InverseMatrix();
+  S21BasicMatrix<std::int64_t> identity(3, 3);
+  for (int k = 0; k < 3; k++) {
+    identity(k, k) = 1;
+  }
+  EXPECT_TRUE(a * inverse == identity);
+  EXPECT_TRUE(inverse * a == identity);
+
+  a(0, 0) = 4;
+  EXPECT_EQ(a.Determinant(), 3);
+  EXPECT_THROW(a.InverseMatrix(), std::logic_error);
+  EXPECT_THROW(a.Solve(identity), std::logic_error);
+  S21BasicMatrix<std::int64_t> complements = a.CalcComplements();
+  EXPECT_TRUE(a * complements.Transpose() == identity * 3);
+
+  // 20 x 20 с элементами до 10^6: det = 1 при любом размере, через double
+  // он бы терял точность
+  S21BasicMatrix<std::int64_t> big(20, 20);
+  for (int i = 0; i < 20; i++) {
+    big(i, i) = 1;
+    for (int j = i + 1; j < 20; j++) {
+      big(i, j) = (i * 31 + j * 17) % 1000;
+    }
+  }
+  S21BasicMatrix<std::int64_t> lower = big.Transpose();
+  EXPECT_EQ((lower * big).Determinant(), 1);
+  EXPECT_EQ(S21BasicMatrix<std::int64_t>(2, 2).Determinant(), 0);
+}
+
+TEST(test_scalar_types, save_load) {
+  const std::string path = "test_scalar_types.bin";
+  S21BasicMatrix<float> f = TypedMatrix<float>(6, 9) * 0.25f;
+  f.Save(path);
+  EXPECT_TRUE(S21BasicMatrix<float>::Load(path) == f);
+  EXPECT_TRUE(S21BasicMatrix<float>::MapFile(path) == f);
+  EXPECT_THROW(S21Matrix::Load(path), std::runtime_error);
+
+  S21BasicMatrix<long double> l(f);
+  l(2, 3) = 1.0L / 3;
+  l.Save(path);
+  S21BasicMatrix<long double> loaded = S21BasicMatrix<long double>::Load(path);
+  EXPECT_EQ(loaded(2, 3), l(2, 3));
+  EXPECT_TRUE(loaded == l);
+  EXPECT_THROW(S21BasicMatrix<float>::Load(path), std::runtime_error);
+
+  S21BasicMatrix<std::int64_t> i = TypedMatrix<std::int64_t>(4, 4);
+  i(0, 0) = std::int64_t(1) << 60;
+  i.Save(path);
+  EXPECT_EQ(S21BasicMatrix<std::int64_t>::Load(path)(0, 0), i(0, 0));
+  std::remove(path.c_str());
+}
+
+//Асинхронные операции: тот же результат, что у синхронных, ошибки
+//размеров сразу, остальные - через future.
+TEST(test_async, results) {
+  S21Matrix a = NumberedMatrix(300, 300);
+  for (int i = 0; i < 300; i++) {
+    a(i, i) += 1e4;
+  }
+  S21Matrix b = NumberedMatrix(300, 700);
+  S21Matrix rhs = NumberedMatrix(300, 3);
+  std::future<S21Matrix> product = a.MulMatrixAsync(b);
+  std::future<S21Matrix> inverse = a.InverseAsync();
+  std::future<double> det = a.DeterminantAsync();
+  std::future<S21Matrix> solution = a.SolveAsync(rhs);
+  EXPECT_TRUE(product.get() == a * b);
+  EXPECT_TRUE(inverse.get() == a.InverseMatrix());
+  EXPECT_DOUBLE_EQ(det.get(), a.Determinant());
+  EXPECT_TRUE(solution.get() == a.Solve(rhs));
+  EXPECT_TRUE(a.MulMatrixAsync(rhs).get() == a * rhs);
+
+  // операнды копируются при вызове
+  S21Matrix saved = b;
+  std::future<S21Matrix> later = b.MulMatrixAsync(NumberedMatrix(700, 5));
+  b *= 2.0;
+  EXPECT_TRUE(later.get() == saved * NumberedMatrix(700, 5));
+
+  EXPECT_THROW(a.MulMatrixAsync(rhs.Transpose()), std::invalid_argument);
+  EXPECT_THROW(b.InverseAsync(), std::invalid_argument);
+  EXPECT_THROW(b.DeterminantAsync(), std::length_error);
+  EXPECT_THROW(a.SolveAsync(b.Transpose()), std::invalid_argument);
+  EXPECT_THROW(NumberedMatrix(3, 3).InverseAsync().get(), std::logic_error);
+
+  S21BasicMatrix<std::int64_t> i(2, 2);
+  i(0, 0) = 3;
+  i(0, 1) = 5;
+  i(1, 0) = 1;
+  i(1, 1) = 2;
+  EXPECT_EQ(i.DeterminantAsync().get(), 1);
+}
+
+//Политика с большим числом потоков пересоздает пул, пока асинхронные
+//операции еще работают на старом.
+TEST(test_async, policy_change) {
+  S21Matrix a = NumberedMatrix(200, 200);
+  for (int i = 0; i < 200; i++) {
+    a(i, i) += 1e4;
+  }
+  S21Matrix b = NumberedMatrix(200, 1500);
+  S21Matrix product = a * b;
+  S21Matrix inverse = a.InverseMatrix();
+  S21ExecutionPolicy previous = S21GetExecutionPolicy();
+  S21ExecutionPolicy policy;
+  policy.threads = 2;
+  policy.parallel_threshold = 0;
+  S21SetExecutionPolicy(policy);
+  std::future<S21Matrix> multiplied = a.MulMatrixAsync(b);
+  std::future<S21Matrix> inverted = a.InverseAsync();
+  // каждое увеличение заменяет пул, которым операции могут пользоваться
+  for (int threads = 3; threads <= 48; threads++) {
+    policy.threads = threads;
+    S21SetExecutionPolicy(policy);
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+  EXPECT_TRUE(multiplied.get() == product);
+  EXPECT_TRUE(inverted.get() == inverse);
+  S21SetExecutionPolicy(previous);
+}
+
+//Отмена, ход выполнения и уведомление о завершении.
+TEST(test_async, cancel_and_progress) {
+  S21Matrix a(400, 400);
+  for (int i = 0; i < 400; i++) {
+    for (int j = 0; j < 400; j++) {
+      a(i, j) = std::sin(i * 1.3 + j * j * 0.7);
+    }
+    a(i, i) += 10;
+  }
+  S21AsyncOptions cancelled;
+  cancelled.token.Cancel();
+  EXPECT_THROW(a.DeterminantAsync(cancelled).get(), S21OperationCancelled);
+  EXPECT_THROW(a.MulMatrixAsync(a, cancelled).get(), S21OperationCancelled);
+
+  // отмена из середины LU-разложения
+  std::vector<double> reported;
+  S21AsyncOptions options;
+  options.progress = [&reported, token = options.token](double done) {
+    reported.push_back(done);
+    if (done > 0.3) {
+      token.Cancel();
+    }
+  };
+  std::future<S21Matrix> solution = a.SolveAsync(a, options);
+  EXPECT_THROW(solution.get(), S21OperationCancelled);
+  ASSERT_GE(reported.size(), 2u);
+  EXPECT_EQ(reported.front(), 0.0);
+  EXPECT_GT(reported.back(), 0.3);
+  EXPECT_LT(reported.back(), 1.0);
+  for (std::size_t k = 1; k < reported.size(); k++) {
+    EXPECT_GT(reported[k], reported[k - 1]);
+  }
+
+  // полный проход доходит до 1
+  reported.clear();
+  std::promise<void> completed;
+  S21AsyncOptions tracked;
+  tracked.progress = [&reported](double done) { reported.push_back(done); };
+  tracked.on_complete = [&completed]() { completed.set_value(); };
+  S21Matrix b = NumberedMatrix(400, 2500);
+  S21Matrix product = a.MulMatrixAsync(b, tracked).get();
+  completed.get_future().wait();
+  EXPECT_TRUE(product == a * b);
+  ASSERT_GE(reported.size(), 3u);
+  EXPECT_EQ(reported.back(), 1.0);
+}
+
+#ifdef S21_PROFILING
+
+static int trace_begins = 0;
+static std::uint64_t traced_ns = 0;
+
+//Счетчики операций и обратные вызовы трассировщика (make test_profile).
+TEST(test_profile, counters) {
+  S21Matrix a = NumberedMatrix(40, 40);
+  for (int i = 0; i < 40; i++) {
+    a(i, i) += 1000;
+  }
+  S21Matrix b = a;
+  S21ResetProfile();
+  S21SetTraceHooks([](S21Operation, int, int) { trace_begins++; },
+                   [](S21Operation, std::uint64_t ns) { traced_ns += ns; });
+
+  a.MulMatrix(b);
+  a.SumMatrix(b);
+  a.SumMatrix(b);
+  double det = b.Determinant();
+  S21Matrix small = NumberedMatrix(3, 5);
+  S21Matrix t = small.Transpose();
+  S21SetTraceHooks(nullptr, nullptr);
+
+  S21ProfileSnapshot profile = S21GetProfile();
+  const S21OperationStats &mul = profile[S21Operation::kMulMatrix];
+  EXPECT_EQ(mul.calls, 1u);
+  EXPECT_EQ(mul.flops, 2u * 40 * 40 * 40);
+  EXPECT_EQ(mul.bytes, 8u * 3 * 40 * 40);
+  EXPECT_GE(mul.allocations, 1u);
+  EXPECT_GE(mul.total_ns, mul.max_ns);
+  EXPECT_EQ(mul.size_histogram[6], 1u);  //40 <= 64
+  EXPECT_EQ(profile[S21Operation::kSum].calls, 2u);
+  EXPECT_EQ(profile[S21Operation::kSum].flops, 2u * 40 * 40);
+  EXPECT_EQ(profile[S21Operation::kDeterminant].calls, 1u);
+  EXPECT_EQ(profile[S21Operation::kTranspose].size_histogram[3], 1u);
+  EXPECT_EQ(profile[S21Operation::kInverse].calls, 0u);
+  EXPECT_NE(det, 0.0);
+  EXPECT_EQ(trace_begins, 5);
+  EXPECT_GT(traced_ns, 0u);
+
+  std::string text = S21ProfilePrometheus();
+  EXPECT_NE(text.find("# TYPE s21_matrix_calls_total counter"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_calls_total{op=\"sum\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(
+      text.find("s21_matrix_size_bucket{op=\"mul_matrix\",le=\"32\"} 0"),
+      std::string::npos);
+  EXPECT_NE(
+      text.find("s21_matrix_size_bucket{op=\"mul_matrix\",le=\"64\"} 1"),
+      std::string::npos);
+
+  S21ResetProfile();
+  EXPECT_EQ(S21GetProfile()[S21Operation::kSum].calls, 0u);
+
+  //вложенные операции (Transpose и MulNumber) входят во внешнюю
+  S21Matrix c = NumberedMatrix(4, 4);
+  for (int i = 0; i < 4; i++) {
+    c(i, i) += 100;
+  }
+  S21Matrix complements = c.CalcComplements();
+  profile = S21GetProfile();
+  EXPECT_EQ(profile[S21Operation::kComplements].calls, 1u);
+  EXPECT_EQ(profile[S21Operation::kComplements].size_sum, 4u);
+  EXPECT_EQ(profile[S21Operation::kTranspose].calls, 0u);
+  EXPECT_EQ(profile[S21Operation::kMulNumber].calls, 0u);
+  text = S21ProfilePrometheus();
+  EXPECT_NE(text.find("s21_matrix_size_sum{op=\"complements\"} 4\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_size_count{op=\"complements\"} 1\n"),
+            std::string::npos);
+}
+
+#else
+
+//Без S21_PROFILING счетчики не ведутся.
+TEST(test_profile, compiled_out) {
+  EXPECT_FALSE(S21ProfilingEnabled());
+  S21Matrix a = NumberedMatrix(4, 4);
+  a.SumMatrix(a * 2.0);
+  EXPECT_EQ(S21GetProfile()[S21Operation::kSum].calls, 0u);
+  std::string text = S21ProfilePrometheus();
+  EXPECT_NE(text.find("s21_matrix_calls_total{op=\"sum\"} 0"),
+            std::string::npos);
+}
+
+#endif
+
 int main() {
   testing::InitGoogleTest();
   if (RUN_ALL_TESTS()) {